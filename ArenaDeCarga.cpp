@@ -0,0 +1,85 @@
+/**
+ * @file ArenaDeCarga.cpp
+ * @brief Implementación de la clase ArenaDeCarga
+ * @author Eliezer Mores Oyervides
+ */
+
+#include "ArenaDeCarga.h"
+#include <new>
+
+namespace {
+
+/**
+ * @brief Tamaño del encabezado redondeado para no romper la alineación
+ */
+const size_t TAMANO_ENCABEZADO =
+    (sizeof(BloqueArena) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+/**
+ * @brief Obtiene el inicio de los bytes utilizables de un bloque
+ */
+inline char* datosDe(BloqueArena* bloque) {
+    return reinterpret_cast<char*>(bloque) + TAMANO_ENCABEZADO;
+}
+
+} // namespace
+
+ArenaDeCarga::ArenaDeCarga(size_t tamanoBloque) : actual(nullptr), tamanoBloque(tamanoBloque) {
+    estadisticas.asignaciones = 0;
+    estadisticas.bloques = 0;
+    estadisticas.bytesUsados = 0;
+    estadisticas.bytesReservados = 0;
+}
+
+ArenaDeCarga::~ArenaDeCarga() {
+    liberarTodo();
+}
+
+void ArenaDeCarga::nuevoBloque(size_t capacidadMinima) {
+    size_t capacidad = tamanoBloque;
+    if (capacidad < capacidadMinima) capacidad = capacidadMinima;
+    
+    void* memoria = ::operator new(TAMANO_ENCABEZADO + capacidad);
+    BloqueArena* bloque = static_cast<BloqueArena*>(memoria);
+    bloque->siguiente = actual;
+    bloque->capacidad = capacidad;
+    bloque->usado = 0;
+    actual = bloque;
+    
+    estadisticas.bloques++;
+    estadisticas.bytesReservados += TAMANO_ENCABEZADO + capacidad;
+}
+
+void* ArenaDeCarga::reservar(size_t bytes, size_t alineacion) {
+    size_t inicio = 0;
+    
+    if (actual != nullptr) {
+        inicio = (actual->usado + alineacion - 1) & ~(alineacion - 1);
+    }
+    
+    if (actual == nullptr || inicio + bytes > actual->capacidad) {
+        // El bloque actual no alcanza: pedir otro (el resto se desperdicia)
+        nuevoBloque(bytes + alineacion);
+        inicio = 0;
+    }
+    
+    void* resultado = datosDe(actual) + inicio;
+    estadisticas.bytesUsados += inicio + bytes - actual->usado;
+    estadisticas.asignaciones++;
+    actual->usado = inicio + bytes;
+    
+    return resultado;
+}
+
+void ArenaDeCarga::liberarTodo() {
+    while (actual != nullptr) {
+        BloqueArena* siguiente = actual->siguiente;
+        ::operator delete(actual);
+        actual = siguiente;
+    }
+    
+    estadisticas.asignaciones = 0;
+    estadisticas.bloques = 0;
+    estadisticas.bytesUsados = 0;
+    estadisticas.bytesReservados = 0;
+}
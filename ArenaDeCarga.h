@@ -0,0 +1,96 @@
+/**
+ * @file ArenaDeCarga.h
+ * @brief Asignador por bloques (arena) para los nodos y tramas de ListaDeCarga
+ * @author Eliezer Mores Oyervides
+ * @date 2025
+ */
+
+#ifndef ARENA_DE_CARGA_H
+#define ARENA_DE_CARGA_H
+
+#include <cstddef>
+
+/**
+ * @struct BloqueArena
+ * @brief Encabezado de un bloque de memoria de la arena
+ * 
+ * Los bytes utilizables empiezan justo después del encabezado
+ */
+struct BloqueArena {
+    BloqueArena* siguiente; ///< Bloque reservado anteriormente
+    size_t capacidad;       ///< Bytes utilizables del bloque
+    size_t usado;           ///< Bytes ya entregados
+};
+
+/**
+ * @struct EstadisticasArena
+ * @brief Contadores de uso de la arena
+ */
+struct EstadisticasArena {
+    long asignaciones;      ///< Número de llamadas a reservar()
+    int bloques;            ///< Bloques pedidos al sistema
+    size_t bytesUsados;     ///< Bytes entregados (incluye relleno por alineación)
+    size_t bytesReservados; ///< Bytes pedidos al sistema
+};
+
+/**
+ * @class ArenaDeCarga
+ * @brief Reparte memoria desde bloques grandes y la libera toda de una vez
+ * 
+ * Cada trama recibida necesitaba dos new y dos delete (la trama y su nodo).
+ * La arena reduce eso a una reserva por bloque: los objetos se construyen
+ * con placement new dentro del bloque y no se liberan individualmente;
+ * el destructor devuelve todos los bloques al sistema.
+ */
+class ArenaDeCarga {
+private:
+    BloqueArena* actual;   ///< Bloque del que se está repartiendo memoria
+    size_t tamanoBloque;   ///< Capacidad de cada bloque nuevo
+    EstadisticasArena estadisticas; ///< Contadores de uso
+    
+    /**
+     * @brief Pide un bloque nuevo al sistema y lo vuelve el actual
+     * @param capacidadMinima Bytes que debe poder contener el bloque
+     */
+    void nuevoBloque(size_t capacidadMinima);
+    
+    // La arena es dueña de sus bloques: no se copia
+    ArenaDeCarga(const ArenaDeCarga&);
+    ArenaDeCarga& operator=(const ArenaDeCarga&);
+    
+public:
+    /**
+     * @brief Constructor
+     * @param tamanoBloque Bytes utilizables de cada bloque (por defecto 64 KiB)
+     */
+    explicit ArenaDeCarga(size_t tamanoBloque = 64 * 1024);
+    
+    /**
+     * @brief Destructor que libera todos los bloques de una sola vez
+     * 
+     * IMPORTANTE: No llama a los destructores de los objetos construidos
+     * en la arena; solo debe usarse para tipos sin recursos propios
+     */
+    ~ArenaDeCarga();
+    
+    /**
+     * @brief Reserva memoria dentro de la arena
+     * @param bytes Número de bytes a reservar
+     * @param alineacion Alineación requerida (potencia de 2)
+     * @return Puntero a la memoria reservada
+     */
+    void* reservar(size_t bytes, size_t alineacion = alignof(std::max_align_t));
+    
+    /**
+     * @brief Libera todos los bloques y reinicia las estadísticas
+     */
+    void liberarTodo();
+    
+    /**
+     * @brief Obtiene los contadores de uso de la arena
+     * @return Estadísticas acumuladas desde la creación o el último liberarTodo()
+     */
+    const EstadisticasArena& getEstadisticas() const { return estadisticas; }
+};
+
+#endif // ARENA_DE_CARGA_H
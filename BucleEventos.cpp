@@ -0,0 +1,215 @@
+/**
+ * @file BucleEventos.cpp
+ * @brief Implementación de la clase BucleEventos
+ * @author Eliezer Mores Oyervides
+ */
+
+#include "BucleEventos.h"
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <iostream>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+BucleEventos::BucleEventos()
+    : epoll(-1), temporizador(-1), temporizadorPlazo(-1), senales(-1), numeroDescriptores(0), descriptorListo(-1),
+      huboActividad(false), ultimaSenal(0) {}
+
+BucleEventos::~BucleEventos() {
+    cerrar();
+}
+
+bool BucleEventos::iniciar(int descriptor, int msInactividad) {
+    descriptoresDatos[0] = descriptor;
+    numeroDescriptores = 1;
+    
+    epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll < 0) {
+        std::cerr << "Error: No se pudo crear epoll" << std::endl;
+        return false;
+    }
+    
+    // Temporizador periódico de inactividad
+    temporizador = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (temporizador < 0) {
+        std::cerr << "Error: No se pudo crear el temporizador" << std::endl;
+        cerrar();
+        return false;
+    }
+    
+    struct itimerspec intervalo;
+    intervalo.it_interval.tv_sec = msInactividad / 1000;
+    intervalo.it_interval.tv_nsec = (msInactividad % 1000) * 1000000L;
+    intervalo.it_value = intervalo.it_interval;
+    if (timerfd_settime(temporizador, 0, &intervalo, nullptr) != 0) {
+        std::cerr << "Error: No se pudo programar el temporizador" << std::endl;
+        cerrar();
+        return false;
+    }
+    
+    // Temporizador de plazos, desarmado hasta que se llame a programarPlazo()
+    temporizadorPlazo = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (temporizadorPlazo < 0) {
+        std::cerr << "Error: No se pudo crear el temporizador" << std::endl;
+        cerrar();
+        return false;
+    }
+    
+    // Las señales de terminación y de volcado se leen del signalfd en lugar de un handler
+    sigset_t mascara;
+    sigemptyset(&mascara);
+    sigaddset(&mascara, SIGINT);
+    sigaddset(&mascara, SIGTERM);
+    sigaddset(&mascara, SIGUSR1);
+    if (pthread_sigmask(SIG_BLOCK, &mascara, nullptr) != 0) {
+        std::cerr << "Error: No se pudieron bloquear las señales" << std::endl;
+        cerrar();
+        return false;
+    }
+    
+    senales = signalfd(-1, &mascara, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (senales < 0) {
+        std::cerr << "Error: No se pudo crear el signalfd" << std::endl;
+        cerrar();
+        return false;
+    }
+    
+    // Registrar los cuatro descriptores
+    int descriptores[4] = { descriptor, temporizador, temporizadorPlazo, senales };
+    for (int i = 0; i < 4; i++) {
+        struct epoll_event evento;
+        evento.events = EPOLLIN;
+        evento.data.fd = descriptores[i];
+        if (epoll_ctl(epoll, EPOLL_CTL_ADD, descriptores[i], &evento) != 0) {
+            std::cerr << "Error: No se pudo registrar un descriptor en epoll" << std::endl;
+            cerrar();
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+bool BucleEventos::agregarDescriptor(int descriptor) {
+    if (epoll < 0 || numeroDescriptores == MAX_DESCRIPTORES_DATOS) return false;
+    
+    struct epoll_event evento;
+    evento.events = EPOLLIN;
+    evento.data.fd = descriptor;
+    if (epoll_ctl(epoll, EPOLL_CTL_ADD, descriptor, &evento) != 0) {
+        std::cerr << "Error: No se pudo registrar un descriptor en epoll" << std::endl;
+        return false;
+    }
+    descriptoresDatos[numeroDescriptores++] = descriptor;
+    return true;
+}
+
+bool BucleEventos::programarPlazo(int ms) {
+    if (temporizadorPlazo < 0) return false;
+    
+    // it_value en cero desarma el timerfd: un plazo de 0 ms se adelanta a 1 ns
+    struct itimerspec plazo;
+    plazo.it_interval.tv_sec = 0;
+    plazo.it_interval.tv_nsec = 0;
+    plazo.it_value.tv_sec = (ms > 0) ? ms / 1000 : 0;
+    plazo.it_value.tv_nsec = (ms > 0) ? (ms % 1000) * 1000000L : (ms == 0 ? 1 : 0);
+    return timerfd_settime(temporizadorPlazo, 0, &plazo, nullptr) == 0;
+}
+
+void BucleEventos::quitarDescriptor(int descriptor) {
+    for (int i = 0; i < numeroDescriptores; i++) {
+        if (descriptoresDatos[i] == descriptor) {
+            epoll_ctl(epoll, EPOLL_CTL_DEL, descriptor, nullptr);
+            descriptoresDatos[i] = descriptoresDatos[--numeroDescriptores];
+            return;
+        }
+    }
+}
+
+EventoBucle BucleEventos::esperar() {
+    if (epoll < 0) return EVENTO_ERROR;
+    
+    while (true) {
+        struct epoll_event eventos[MAX_DESCRIPTORES_DATOS + 3];
+        int n = epoll_wait(epoll, eventos, MAX_DESCRIPTORES_DATOS + 3, -1);
+        
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return EVENTO_ERROR;
+        }
+        
+        // Prioridad: señales, luego datos, luego el plazo y el temporizador
+        for (int i = 0; i < n; i++) {
+            if (eventos[i].data.fd == senales) {
+                struct signalfd_siginfo info;
+                if (read(senales, &info, sizeof(info)) == static_cast<ssize_t>(sizeof(info))) {
+                    ultimaSenal = static_cast<int>(info.ssi_signo);
+                }
+                return EVENTO_SENAL;
+            }
+        }
+        
+        for (int i = 0; i < n; i++) {
+            if (eventos[i].data.fd != temporizador && eventos[i].data.fd != temporizadorPlazo) {
+                descriptorListo = eventos[i].data.fd;
+                if (eventos[i].events & EPOLLIN) {
+                    huboActividad = true;
+                    return EVENTO_DATOS;
+                }
+                if (eventos[i].events & (EPOLLHUP | EPOLLERR)) {
+                    return EVENTO_DESCONEXION;
+                }
+            }
+        }
+        
+        for (int i = 0; i < n; i++) {
+            if (eventos[i].data.fd == temporizadorPlazo) {
+                uint64_t vencimientos;
+                if (read(temporizadorPlazo, &vencimientos, sizeof(vencimientos)) > 0) return EVENTO_PLAZO;
+            }
+        }
+        
+        for (int i = 0; i < n; i++) {
+            if (eventos[i].data.fd == temporizador) {
+                uint64_t vencimientos;
+                if (read(temporizador, &vencimientos, sizeof(vencimientos)) < 0) {
+                    continue;
+                }
+                
+                // Solo se reporta si el intervalo completo fue inactivo
+                if (!huboActividad) return EVENTO_INACTIVIDAD;
+                huboActividad = false;
+            }
+        }
+    }
+}
+
+void BucleEventos::cerrar() {
+    if (epoll >= 0) {
+        close(epoll);
+        epoll = -1;
+    }
+    if (temporizador >= 0) {
+        close(temporizador);
+        temporizador = -1;
+    }
+    if (temporizadorPlazo >= 0) {
+        close(temporizadorPlazo);
+        temporizadorPlazo = -1;
+    }
+    if (senales >= 0) {
+        close(senales);
+        senales = -1;
+        
+        sigset_t mascara;
+        sigemptyset(&mascara);
+        sigaddset(&mascara, SIGINT);
+        sigaddset(&mascara, SIGTERM);
+        sigaddset(&mascara, SIGUSR1);
+        pthread_sigmask(SIG_UNBLOCK, &mascara, nullptr);
+    }
+}
@@ -0,0 +1,121 @@
+/**
+ * @file BucleEventos.h
+ * @brief Bucle de eventos basado en epoll para la ingesta del puerto serial
+ * @author Eliezer Mores Oyervides
+ * @date 2025
+ */
+
+#ifndef BUCLE_EVENTOS_H
+#define BUCLE_EVENTOS_H
+
+/**
+ * @brief Descriptores de datos que puede vigilar un BucleEventos (carriles de --carriles)
+ */
+const int MAX_DESCRIPTORES_DATOS = 16;
+
+/**
+ * @brief Eventos que entrega BucleEventos::esperar()
+ */
+enum EventoBucle {
+    EVENTO_DATOS,        ///< El puerto tiene bytes para leer
+    EVENTO_INACTIVIDAD,  ///< Pasó un intervalo completo sin datos
+    EVENTO_SENAL,        ///< Llegó SIGINT/SIGTERM (terminar) o SIGUSR1 (volcar métricas)
+    EVENTO_DESCONEXION,  ///< El puerto se cerró o colgó
+    EVENTO_PLAZO,        ///< Venció el plazo fijado con programarPlazo()
+    EVENTO_ERROR         ///< Falló epoll o alguno de sus descriptores
+};
+
+/**
+ * @class BucleEventos
+ * @brief Espera datos del puerto, el temporizador de inactividad y señales con epoll
+ * 
+ * Sustituye la espera activa con VMIN=0/VTIME=1: el proceso solo despierta
+ * cuando llegan bytes, cuando vence el timerfd de inactividad o cuando
+ * el signalfd recibe SIGINT/SIGTERM para un apagado limpio o SIGUSR1
+ * para volcar las métricas sin detenerse.
+ */
+class BucleEventos {
+private:
+    int epoll;            ///< Descriptor de epoll
+    int temporizador;     ///< timerfd periódico de inactividad
+    int temporizadorPlazo; ///< timerfd de un solo disparo de programarPlazo()
+    int senales;          ///< signalfd de SIGINT/SIGTERM/SIGUSR1
+    int descriptoresDatos[MAX_DESCRIPTORES_DATOS]; ///< Descriptores vigilados (puertos seriales)
+    int numeroDescriptores; ///< Descriptores de datos vigilados
+    int descriptorListo;  ///< Descriptor del último EVENTO_DATOS o EVENTO_DESCONEXION
+    bool huboActividad;   ///< Llegaron datos desde el último vencimiento del temporizador
+    int ultimaSenal;      ///< Número de la última señal recibida
+    
+    // El bucle es dueño de sus descriptores: no se copia
+    BucleEventos(const BucleEventos&);
+    BucleEventos& operator=(const BucleEventos&);
+    
+public:
+    /**
+     * @brief Constructor
+     */
+    BucleEventos();
+    
+    /**
+     * @brief Destructor que cierra los descriptores propios
+     */
+    ~BucleEventos();
+    
+    /**
+     * @brief Prepara epoll, el temporizador y las señales
+     * @param descriptor Descriptor a vigilar (debe estar en modo no bloqueante)
+     * @param msInactividad Intervalo sin datos tras el cual se reporta inactividad
+     * @return true si todo se configuró, false en caso contrario
+     * 
+     * IMPORTANTE: Bloquea SIGINT, SIGTERM y SIGUSR1 en el hilo que llama; debe
+     * llamarse antes de crear otros hilos para que lo hereden
+     */
+    bool iniciar(int descriptor, int msInactividad);
+    
+    /**
+     * @brief Vigila otro descriptor de datos además del de iniciar()
+     * @param descriptor Descriptor en modo no bloqueante
+     * @return false si no se pudo registrar o ya hay MAX_DESCRIPTORES_DATOS
+     */
+    bool agregarDescriptor(int descriptor);
+    
+    /**
+     * @brief Deja de vigilar un descriptor de datos (por ejemplo, un carril que colgó)
+     * @param descriptor Descriptor registrado con iniciar() o agregarDescriptor()
+     */
+    void quitarDescriptor(int descriptor);
+    
+    /**
+     * @brief Programa un EVENTO_PLAZO para dentro de ms milisegundos (por ejemplo, el vencimiento de un hueco)
+     * @param ms Milisegundos hasta el evento (0: en cuanto se espere; negativo: cancelar)
+     * @return false si no se pudo programar el temporizador
+     *
+     * Reemplaza al plazo anterior; dispara una sola vez.
+     */
+    bool programarPlazo(int ms);
+    
+    /**
+     * @brief Espera (sin consumir CPU) hasta el siguiente evento
+     * @return Evento ocurrido
+     */
+    EventoBucle esperar();
+    
+    /**
+     * @brief Obtiene la última señal recibida
+     * @return Número de señal (SIGINT, SIGTERM, SIGUSR1) o 0
+     */
+    int getUltimaSenal() const { return ultimaSenal; }
+    
+    /**
+     * @brief Obtiene el descriptor del último EVENTO_DATOS o EVENTO_DESCONEXION
+     * @return Descriptor que tenía datos o colgó
+     */
+    int getDescriptorListo() const { return descriptorListo; }
+    
+    /**
+     * @brief Cierra los descriptores y restaura la máscara de señales
+     */
+    void cerrar();
+};
+
+#endif // BUCLE_EVENTOS_H
@@ -0,0 +1,63 @@
+/**
+ * @file BufferReordenamiento.cpp
+ * @brief Implementación de la clase BufferReordenamiento
+ * @author Eliezer Mores Oyervides
+ */
+
+#include "BufferReordenamiento.h"
+#include <ostream>
+
+BufferReordenamiento::BufferReordenamiento(int capacidadMinima, int msEsperaHueco)
+    : tramas(nullptr), envios(nullptr), secuencias(nullptr), capacidad(1), mascara(0), siguiente(0),
+      pendientes(0), msHueco(msEsperaHueco), candidatoSalto(-1), confirmacionesSalto(0), bloqueadoDesde(std::chrono::steady_clock::now()) {
+    // Potencia de 2 para ubicar cada secuencia con una máscara
+    while (capacidad < capacidadMinima) capacidad <<= 1;
+    mascara = capacidad - 1;
+    
+    tramas = new TramaCompacta[capacidad];
+    envios = new unsigned long long[capacidad];
+    secuencias = new long long[capacidad];
+    for (int i = 0; i < capacidad; i++) secuencias[i] = -1;
+    
+    estadisticas.recibidas = 0;
+    estadisticas.entregadas = 0;
+    estadisticas.perdidas = 0;
+    estadisticas.atrasadas = 0;
+    estadisticas.saltosPorTiempo = 0;
+    estadisticas.saltosPorCapacidad = 0;
+    estadisticas.saltosDescartados = 0;
+    estadisticas.pendientesMaximo = 0;
+}
+
+BufferReordenamiento::~BufferReordenamiento() {
+    delete[] tramas;
+    delete[] envios;
+    delete[] secuencias;
+}
+
+void BufferReordenamiento::volcar(std::ostream& destino, FormatoVolcado formato) const {
+    if (formato == VOLCADO_JSON) {
+        destino << "{\"reordenamiento\": {"
+                << "\"recibidas\": " << estadisticas.recibidas
+                << ", \"entregadas\": " << estadisticas.entregadas
+                << ", \"perdidas\": " << estadisticas.perdidas
+                << ", \"atrasadas\": " << estadisticas.atrasadas
+                << ", \"saltos_tiempo\": " << estadisticas.saltosPorTiempo
+                << ", \"saltos_capacidad\": " << estadisticas.saltosPorCapacidad
+                << ", \"saltos_descartados\": " << estadisticas.saltosDescartados
+                << ", \"pendientes_max\": " << estadisticas.pendientesMaximo
+                << ", \"capacidad\": " << capacidad << "}}" << std::endl;
+        return;
+    }
+    
+    destino << "=== Reordenamiento ===" << std::endl;
+    destino << "recibidas:        " << estadisticas.recibidas << std::endl;
+    destino << "entregadas:       " << estadisticas.entregadas << std::endl;
+    destino << "perdidas:         " << estadisticas.perdidas << std::endl;
+    destino << "atrasadas:        " << estadisticas.atrasadas << std::endl;
+    destino << "saltos (tiempo):  " << estadisticas.saltosPorTiempo << std::endl;
+    destino << "saltos (memoria): " << estadisticas.saltosPorCapacidad << std::endl;
+    destino << "saltos (falsos):  " << estadisticas.saltosDescartados << std::endl;
+    destino << "retenidas (max):  " << estadisticas.pendientesMaximo << " de " << capacidad << std::endl;
+    destino << "======================" << std::endl;
+}
@@ -0,0 +1,286 @@
+/**
+ * @file BufferReordenamiento.h
+ * @brief Reordenamiento por número de secuencia de tramas repartidas en varios carriles
+ * @author Eliezer Mores Oyervides
+ * @date 2025
+ */
+
+#ifndef BUFFER_REORDENAMIENTO_H
+#define BUFFER_REORDENAMIENTO_H
+
+#include <chrono>
+#include <iosfwd>
+#include "Instrumentacion.h"
+#include "TramaCompacta.h"
+
+/**
+ * @brief Capacidad por defecto del buffer (tramas adelantadas que puede retener)
+ */
+const int CAPACIDAD_REORDENAMIENTO = 4096;
+
+/**
+ * @brief Milisegundos por defecto que una trama puede esperar a que se llene un hueco
+ */
+const int MS_HUECO_REORDENAMIENTO = 100;
+
+/**
+ * @brief Capacidades más allá de siguiente a partir de las cuales una secuencia se considera sospechosa
+ */
+const int CAPACIDADES_SALTO_SOSPECHOSO = 4;
+
+/**
+ * @brief Tramas seguidas y coherentes entre sí que confirman un salto sospechoso
+ */
+const int CONFIRMACIONES_SALTO = 3;
+
+/**
+ * @struct EstadisticasReordenamiento
+ * @brief Contadores de un BufferReordenamiento
+ */
+struct EstadisticasReordenamiento {
+    long recibidas;        ///< Tramas que llegaron a agregar()
+    long entregadas;       ///< Tramas liberadas en orden al receptor
+    long perdidas;         ///< Secuencias saltadas (por tiempo, capacidad o fin de flujo)
+    long atrasadas;        ///< Tramas descartadas por llegar después de su turno o repetidas
+    long saltosPorTiempo;  ///< Huecos abandonados por vencer su espera
+    long saltosPorCapacidad; ///< Avances forzados por una trama fuera de la ventana
+    long saltosDescartados; ///< Tramas con una secuencia sospechosa (";s=" corrupto) no confirmada
+    int pendientesMaximo;  ///< Mayor número de tramas retenidas a la vez
+};
+
+/**
+ * @class BufferReordenamiento
+ * @brief Ventana circular que libera las tramas en orden de secuencia
+ *
+ * Con un emisor que reparte un flujo en varios carriles seriales (trama
+ * s por el carril s % carriles), las tramas llegan desordenadas entre
+ * carriles. ListaDeCarga y el rotor necesitan el orden original, así que
+ * cada trama se guarda en la posición secuencia % capacidad y el buffer
+ * entrega al receptor todas las consecutivas desde la siguiente esperada.
+ *
+ * La memoria es fija: una trama con secuencia fuera de la ventana fuerza
+ * a avanzar, entregando lo retenido y dando por perdidos los huecos. Como
+ * un solo ";s=" corrupto haría descartar todo el flujo posterior, una
+ * secuencia a más de CAPACIDADES_SALTO_SOSPECHOSO capacidades se descarta
+ * salvo que CONFIRMACIONES_SALTO tramas seguidas la respalden (el emisor
+ * de verdad saltó, por ejemplo porque se reinició). Un
+ * hueco que bloquea tramas durante más de msHueco también se abandona
+ * (vencer()). Las tramas que llegan después de su turno se descartan.
+ *
+ * El receptor es cualquier objeto con entregar(const TramaCompacta&,
+ * unsigned long long envioNs), como los visitantes de TramaCompacta.
+ *
+ * Ejemplo:
+ * @code
+ * BufferReordenamiento reorden(1024, 50);
+ * reorden.agregar(1, TramaCompacta::load('B'), 0, receptor); // retenida
+ * reorden.agregar(0, TramaCompacta::load('A'), 0, receptor); // entrega A y B
+ * @endcode
+ */
+class BufferReordenamiento {
+private:
+    TramaCompacta* tramas;          ///< Trama de cada posición
+    unsigned long long* envios;     ///< Marca ";t=" de cada posición (0 sin ella)
+    long long* secuencias;          ///< Secuencia guardada en cada posición (-1: libre)
+    int capacidad;                  ///< Posiciones (potencia de 2)
+    int mascara;                    ///< capacidad - 1
+    long long siguiente;            ///< Secuencia que se entrega a continuación
+    int pendientes;                 ///< Tramas retenidas
+    long long msHueco;              ///< Espera máxima detrás de un hueco
+    long long candidatoSalto;       ///< Última secuencia sospechosa recibida (-1: ninguna)
+    int confirmacionesSalto;        ///< Tramas sospechosas seguidas coherentes con candidatoSalto
+    std::chrono::steady_clock::time_point bloqueadoDesde; ///< Desde cuándo hay tramas retenidas tras el hueco actual
+    EstadisticasReordenamiento estadisticas; ///< Contadores
+    
+    /**
+     * @brief Indica si la posición de una secuencia la tiene ocupada esa misma secuencia
+     */
+    bool presente(long long secuencia) const { return secuencias[secuencia & mascara] == secuencia; }
+    
+    /**
+     * @brief Entrega las tramas consecutivas desde siguiente
+     *
+     * La espera del hueco solo se reinicia si se avanzó: mientras el mismo
+     * hueco siga abierto, las tramas que llegan detrás no lo prolongan.
+     */
+    template <typename Receptor>
+    void liberar(Receptor& receptor) {
+        long long inicio = siguiente;
+        while (pendientes > 0 && presente(siguiente)) {
+            int posicion = static_cast<int>(siguiente & mascara);
+            secuencias[posicion] = -1;
+            pendientes--;
+            siguiente++;
+            estadisticas.entregadas++;
+            receptor.entregar(tramas[posicion], envios[posicion]);
+        }
+        if (pendientes > 0 && siguiente != inicio) bloqueadoDesde = std::chrono::steady_clock::now();
+    }
+    
+    /**
+     * @brief Salta el hueco actual hasta la siguiente trama retenida y la entrega con las que la siguen
+     */
+    template <typename Receptor>
+    void saltarHueco(Receptor& receptor) {
+        if (pendientes == 0) return;
+        long long inicio = siguiente;
+        while (!presente(siguiente)) siguiente++;
+        estadisticas.perdidas += siguiente - inicio;
+        liberar(receptor);
+    }
+    
+    // El buffer es dueño de sus arreglos: no se copia
+    BufferReordenamiento(const BufferReordenamiento&);
+    BufferReordenamiento& operator=(const BufferReordenamiento&);
+    
+public:
+    /**
+     * @brief Constructor
+     * @param capacidadMinima Tramas adelantadas que se pueden retener (se redondea a potencia de 2)
+     * @param msEsperaHueco Milisegundos que una trama espera a que llegue la que falta
+     */
+    explicit BufferReordenamiento(int capacidadMinima = CAPACIDAD_REORDENAMIENTO,
+                                  int msEsperaHueco = MS_HUECO_REORDENAMIENTO);
+    
+    /**
+     * @brief Destructor
+     */
+    ~BufferReordenamiento();
+    
+    /**
+     * @brief Recibe una trama y entrega en orden todo lo que quede desbloqueado
+     * @param secuencia Número de secuencia de la trama (el flujo empieza en 0)
+     * @param trama Trama recibida
+     * @param envioNs Marca ";t=" del emisor (0 sin ella); se devuelve al entregar
+     * @param receptor Objeto con entregar(trama, envioNs)
+     * @return false si la trama se descartó por atrasada, repetida o sospechosa
+     */
+    template <typename Receptor>
+    bool agregar(long long secuencia, const TramaCompacta& trama, unsigned long long envioNs, Receptor& receptor) {
+        estadisticas.recibidas++;
+        if (secuencia < siguiente || presente(secuencia)) {
+            estadisticas.atrasadas++;
+            return false;
+        }
+        
+        // Caso común (un carril o carriles parejos): la trama esperada sin nada retenido
+        if (secuencia == siguiente && pendientes == 0) {
+            candidatoSalto = -1;
+            confirmacionesSalto = 0;
+            siguiente++;
+            estadisticas.entregadas++;
+            receptor.entregar(trama, envioNs);
+            return true;
+        }
+        
+        // Demasiado adelantada: un ";s=" corrupto salvo que las tramas siguientes lo confirmen
+        if (secuencia - siguiente >= static_cast<long long>(capacidad) * CAPACIDADES_SALTO_SOSPECHOSO) {
+            // Con varios carriles las confirmaciones pueden llegar desordenadas entre sí
+            if (candidatoSalto >= 0 && secuencia - candidatoSalto < capacidad &&
+                candidatoSalto - secuencia < capacidad) {
+                confirmacionesSalto++;
+            } else {
+                confirmacionesSalto = 1;
+            }
+            candidatoSalto = secuencia;
+            if (confirmacionesSalto < CONFIRMACIONES_SALTO) {
+                estadisticas.saltosDescartados++;
+                return false;
+            }
+        }
+        candidatoSalto = -1;
+        confirmacionesSalto = 0;
+        
+        // Fuera de la ventana: avanzar hasta que quepa, sin recorrer más de una vuelta
+        if (secuencia - siguiente >= capacidad) {
+            estadisticas.saltosPorCapacidad++;
+            long long limite = secuencia - capacidad + 1;
+            while (pendientes > 0 && siguiente < limite) saltarHueco(receptor);
+            if (siguiente < limite) {
+                estadisticas.perdidas += limite - siguiente;
+                siguiente = limite;
+            }
+        }
+        
+        int posicion = static_cast<int>(secuencia & mascara);
+        tramas[posicion] = trama;
+        envios[posicion] = envioNs;
+        secuencias[posicion] = secuencia;
+        if (pendientes++ == 0) bloqueadoDesde = std::chrono::steady_clock::now();
+        if (pendientes > estadisticas.pendientesMaximo) estadisticas.pendientesMaximo = pendientes;
+        
+        liberar(receptor);
+        return true;
+    }
+    
+    /**
+     * @brief Abandona el hueco actual si las tramas retenidas esperaron más de msHueco
+     * @param receptor Objeto con entregar(trama, envioNs)
+     *
+     * Pensado para llamarse tras cada lectura de los carriles.
+     */
+    template <typename Receptor>
+    void vencer(Receptor& receptor) {
+        while (pendientes > 0 &&
+               std::chrono::steady_clock::now() - bloqueadoDesde >= std::chrono::milliseconds(msHueco)) {
+            estadisticas.saltosPorTiempo++;
+            saltarHueco(receptor);
+        }
+    }
+    
+    /**
+     * @brief Entrega todo lo retenido saltando los huecos (fin del flujo o inactividad)
+     * @param receptor Objeto con entregar(trama, envioNs)
+     */
+    template <typename Receptor>
+    void vaciar(Receptor& receptor) {
+        while (pendientes > 0) saltarHueco(receptor);
+    }
+    
+    /**
+     * @brief Milisegundos que faltan para que vencer() abandone el hueco actual
+     * @return 0 si ya venció, -1 si no hay tramas retenidas
+     *
+     * Sirve para programar un temporizador y que un hueco se abandone a
+     * tiempo aunque los carriles dejen de enviar.
+     */
+    int msHastaVencer() const {
+        if (pendientes == 0) return -1;
+        long long transcurridos = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - bloqueadoDesde).count();
+        return (transcurridos >= msHueco) ? 0 : static_cast<int>(msHueco - transcurridos);
+    }
+    
+    /**
+     * @brief Número de tramas retenidas
+     * @return Tramas a la espera de un hueco
+     */
+    int getPendientes() const { return pendientes; }
+    
+    /**
+     * @brief Secuencia que se entrega a continuación
+     * @return Siguiente secuencia esperada
+     */
+    long long getSiguiente() const { return siguiente; }
+    
+    /**
+     * @brief Capacidad real del buffer
+     * @return Posiciones (potencia de 2)
+     */
+    int getCapacidad() const { return capacidad; }
+    
+    /**
+     * @brief Obtiene los contadores
+     * @return Estadísticas acumuladas
+     */
+    const EstadisticasReordenamiento& getEstadisticas() const { return estadisticas; }
+    
+    /**
+     * @brief Escribe los contadores del reordenamiento
+     * @param destino Flujo de salida
+     * @param formato VOLCADO_TEXTO o VOLCADO_JSON
+     */
+    void volcar(std::ostream& destino, FormatoVolcado formato) const;
+};
+
+#endif // BUFFER_REORDENAMIENTO_H
@@ -0,0 +1,270 @@
+/**
+ * @file CascadaRotores.cpp
+ * @brief Implementación de la clase CascadaRotores
+ * @author Eliezer Mores Oyervides
+ */
+
+#include "CascadaRotores.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+/**
+ * @brief Longitud máxima de una línea del archivo de configuración
+ */
+const int MAX_LINEA_CONFIGURACION = 256;
+
+/**
+ * @brief Verifica que un cableado sea una permutación de A-Z
+ */
+bool cableadoValido(const char* cableado) {
+    if (cableado == nullptr || std::strlen(cableado) != static_cast<size_t>(TAMANO_ALFABETO)) return false;
+    bool usada[TAMANO_ALFABETO] = { false };
+    for (int i = 0; i < TAMANO_ALFABETO; i++) {
+        if (cableado[i] < 'A' || cableado[i] > 'Z' || usada[cableado[i] - 'A']) return false;
+        usada[cableado[i] - 'A'] = true;
+    }
+    return true;
+}
+
+/**
+ * @brief Verifica que una lista de muescas solo tenga letras A-Z
+ */
+bool muescasValidas(const char* letras) {
+    if (letras == nullptr) return true;
+    for (int i = 0; letras[i] != '\0'; i++) {
+        if (letras[i] < 'A' || letras[i] > 'Z') return false;
+    }
+    return true;
+}
+
+} // namespace
+
+CascadaRotores::CascadaRotores()
+    : numeroRotores(0), avancePorCarga(false), generacion(1), primerRestoValido(1), composiciones(0) {
+    // Fuera de A-Z todas las tablas son la identidad y nunca se recomponen
+    for (int c = 0; c < 256; c++) {
+        for (int i = 0; i <= MAX_ROTORES_CASCADA; i++) restos[i][c] = static_cast<char>(c);
+        for (int p = 0; p < TAMANO_ALFABETO; p++) tablas[p][c] = static_cast<char>(c);
+    }
+    for (int p = 0; p < TAMANO_ALFABETO; p++) {
+        generacionTabla[p] = 0;
+        generacionUso[p] = 0;
+        usos[p] = 0;
+    }
+    const char identidad[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    const char* cableadoIdentidad = identidad;
+    definirRotores(1, &cableadoIdentidad, nullptr, nullptr, false);
+}
+
+bool CascadaRotores::definirRotores(int numero, const char* const* cableadosRotores,
+                                    const char* const* muescasRotores, const char* letrasIniciales, bool avance) {
+    if (numero < 1 || numero > MAX_ROTORES_CASCADA) {
+        std::cerr << "Error: Una cascada tiene de 1 a " << MAX_ROTORES_CASCADA << " rotores" << std::endl;
+        return false;
+    }
+    if (letrasIniciales != nullptr && std::strlen(letrasIniciales) != static_cast<size_t>(numero)) {
+        std::cerr << "Error: Se esperaban " << numero << " posiciones iniciales" << std::endl;
+        return false;
+    }
+    for (int i = 0; i < numero; i++) {
+        if (!cableadoValido(cableadosRotores[i])) {
+            std::cerr << "Error: El cableado del rotor " << i << " no es una permutación de A-Z" << std::endl;
+            return false;
+        }
+        if (muescasRotores != nullptr && !muescasValidas(muescasRotores[i])) {
+            std::cerr << "Error: Las muescas del rotor " << i << " deben ser letras A-Z" << std::endl;
+            return false;
+        }
+        if (letrasIniciales != nullptr && (letrasIniciales[i] < 'A' || letrasIniciales[i] > 'Z')) {
+            std::cerr << "Error: La posición del rotor " << i << " debe ser una letra A-Z" << std::endl;
+            return false;
+        }
+    }
+    
+    numeroRotores = numero;
+    avancePorCarga = avance;
+    for (int i = 0; i < numero; i++) {
+        for (int c = 0; c < 256; c++) cableados[i][c] = static_cast<char>(c);
+        for (int l = 0; l < TAMANO_ALFABETO; l++) cableados[i]['A' + l] = cableadosRotores[i][l];
+        
+        // Sin muescas el rotor arrastra al dar la vuelta
+        const char* letras = (muescasRotores != nullptr) ? muescasRotores[i] : nullptr;
+        for (int l = 0; l < TAMANO_ALFABETO; l++) muescas[i][l] = false;
+        if (letras == nullptr || letras[0] == '\0') {
+            muescas[i][TAMANO_ALFABETO - 1] = true;
+        } else {
+            for (int j = 0; letras[j] != '\0'; j++) muescas[i][letras[j] - 'A'] = true;
+        }
+        
+        posiciones[i] = (letrasIniciales != nullptr) ? letrasIniciales[i] - 'A' : 0;
+    }
+    
+    // restos[numero] es la identidad; los demás sufijos se componen al usarlos
+    for (int l = 0; l < TAMANO_ALFABETO; l++) restos[numero]['A' + l] = static_cast<char>('A' + l);
+    primerRestoValido = numero;
+    invalidar();
+    return true;
+}
+
+bool CascadaRotores::cargar(const char* ruta) {
+    FILE* archivo = std::fopen(ruta, "r");
+    if (archivo == nullptr) {
+        std::cerr << "Error: No se pudo abrir la configuración de rotores " << ruta << std::endl;
+        return false;
+    }
+    
+    char cableadosLeidos[MAX_ROTORES_CASCADA][TAMANO_ALFABETO + 1];
+    char muescasLeidas[MAX_ROTORES_CASCADA][TAMANO_ALFABETO + 1];
+    char posiciones[MAX_ROTORES_CASCADA + 1];
+    int numero = 0;
+    bool avance = false;
+    bool correcto = true;
+    
+    char linea[MAX_LINEA_CONFIGURACION];
+    int numeroLinea = 0;
+    while (correcto && std::fgets(linea, sizeof(linea), archivo) != nullptr) {
+        numeroLinea++;
+        char* comentario = std::strchr(linea, '#');
+        if (comentario != nullptr) *comentario = '\0';
+        
+        const char* separadores = " \t\r\n";
+        char* palabra = std::strtok(linea, separadores);
+        if (palabra == nullptr) continue;
+        
+        if (std::strcmp(palabra, "avance") == 0) {
+            const char* modo = std::strtok(nullptr, separadores);
+            if (modo != nullptr && std::strcmp(modo, "carga") == 0) {
+                avance = true;
+            } else if (modo != nullptr && std::strcmp(modo, "ninguno") == 0) {
+                avance = false;
+            } else {
+                std::cerr << "Error: " << ruta << ":" << numeroLinea
+                          << ": avance debe ser 'carga' o 'ninguno'" << std::endl;
+                correcto = false;
+            }
+        } else if (std::strcmp(palabra, "rotor") == 0) {
+            const char* cableado = std::strtok(nullptr, separadores);
+            if (numero == MAX_ROTORES_CASCADA) {
+                std::cerr << "Error: " << ruta << ":" << numeroLinea << ": más de "
+                          << MAX_ROTORES_CASCADA << " rotores" << std::endl;
+                correcto = false;
+                break;
+            }
+            if (!cableadoValido(cableado)) {
+                std::cerr << "Error: " << ruta << ":" << numeroLinea
+                          << ": el cableado debe ser una permutación de A-Z" << std::endl;
+                correcto = false;
+                break;
+            }
+            std::strcpy(cableadosLeidos[numero], cableado);
+            muescasLeidas[numero][0] = '\0';
+            posiciones[numero] = 'A';
+            
+            // Atributos opcionales: muescas <letras>, posicion <letra>
+            const char* atributo;
+            while (correcto && (atributo = std::strtok(nullptr, separadores)) != nullptr) {
+                const char* valor = std::strtok(nullptr, separadores);
+                if (std::strcmp(atributo, "muescas") == 0 && valor != nullptr &&
+                    std::strlen(valor) <= static_cast<size_t>(TAMANO_ALFABETO) && muescasValidas(valor)) {
+                    std::strcpy(muescasLeidas[numero], valor);
+                } else if (std::strcmp(atributo, "posicion") == 0 && valor != nullptr &&
+                           valor[1] == '\0' && valor[0] >= 'A' && valor[0] <= 'Z') {
+                    posiciones[numero] = valor[0];
+                } else {
+                    std::cerr << "Error: " << ruta << ":" << numeroLinea
+                              << ": atributo de rotor inválido: " << atributo << std::endl;
+                    correcto = false;
+                }
+            }
+            numero++;
+        } else {
+            std::cerr << "Error: " << ruta << ":" << numeroLinea
+                      << ": directiva desconocida: " << palabra << std::endl;
+            correcto = false;
+        }
+    }
+    std::fclose(archivo);
+    
+    if (correcto && numero == 0) {
+        std::cerr << "Error: " << ruta << " no define ningún rotor" << std::endl;
+        correcto = false;
+    }
+    if (!correcto) return false;
+    
+    const char* punterosCableado[MAX_ROTORES_CASCADA];
+    const char* punterosMuescas[MAX_ROTORES_CASCADA];
+    for (int i = 0; i < numero; i++) {
+        punterosCableado[i] = cableadosLeidos[i];
+        punterosMuescas[i] = muescasLeidas[i];
+    }
+    posiciones[numero] = '\0';
+    return definirRotores(numero, punterosCableado, punterosMuescas, posiciones, avance);
+}
+
+void CascadaRotores::arrastrar() {
+    // Mover el rotor 0 solo cambia de tabla; cualquier otro cambia la composición
+    for (int i = 1; i < numeroRotores; i++) {
+        bool arrastra = muescas[i][posiciones[i]];
+        posiciones[i] = (posiciones[i] + 1) % TAMANO_ALFABETO;
+        if (primerRestoValido <= i) primerRestoValido = i + 1;
+        invalidar();
+        if (!arrastra) break;
+    }
+}
+
+void CascadaRotores::invalidar() {
+    generacion++;
+    if (generacion == 0) {
+        // Tras dar la vuelta el contador, ninguna etiqueta vieja puede coincidir
+        for (int p = 0; p < TAMANO_ALFABETO; p++) {
+            generacionTabla[p] = 0;
+            generacionUso[p] = 0;
+        }
+        generacion = 1;
+    }
+}
+
+char CascadaRotores::mapearSinTabla(char in) {
+    if (primerRestoValido > 1) componerRestos();
+    
+    int posicion = posiciones[0];
+    if (generacionUso[posicion] != generacion) {
+        generacionUso[posicion] = generacion;
+        usos[posicion] = 0;
+    }
+    if (++usos[posicion] >= USOS_PARA_COMPONER) {
+        // La posición se repite en esta generación: vale la pena la tabla
+        componerTabla(posicion);
+        return tablas[posicion][static_cast<unsigned char>(in)];
+    }
+    
+    const char* desplazada = RotorDeMapeo::obtenerTabla(posicion);
+    return restos[1][static_cast<unsigned char>(cableados[0][static_cast<unsigned char>(desplazada[static_cast<unsigned char>(in)])])];
+}
+
+void CascadaRotores::componerRestos() {
+    // El rotor 0 ya dejó las minúsculas en mayúsculas: basta con A-Z
+    for (int i = primerRestoValido - 1; i >= 1; i--) {
+        const char* desplazada = RotorDeMapeo::obtenerTabla(posiciones[i]);
+        for (int l = 0; l < TAMANO_ALFABETO; l++) {
+            unsigned char x = static_cast<unsigned char>(cableados[i][static_cast<unsigned char>(desplazada['A' + l])]);
+            restos[i]['A' + l] = restos[i + 1][x];
+        }
+    }
+    primerRestoValido = 1;
+}
+
+void CascadaRotores::componerTabla(int posicion) {
+    const char* desplazada = RotorDeMapeo::obtenerTabla(posicion);
+    for (int l = 0; l < TAMANO_ALFABETO; l++) {
+        unsigned char x = static_cast<unsigned char>(desplazada['A' + l]);
+        char decodificado = restos[1][static_cast<unsigned char>(cableados[0][x])];
+        tablas[posicion]['A' + l] = decodificado;
+        tablas[posicion]['a' + l] = decodificado;
+    }
+    generacionTabla[posicion] = generacion;
+    composiciones++;
+}
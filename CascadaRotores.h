@@ -0,0 +1,206 @@
+/**
+ * @file CascadaRotores.h
+ * @brief Varios rotores en serie con cableado propio y avance tipo odómetro
+ * @author Eliezer Mores Oyervides
+ * @date 2025
+ *
+ * Cada rotor de la cascada desplaza como RotorDeMapeo (con sus mismas
+ * tablas) y después aplica su cableado: una permutación de A-Z. Un LOAD atraviesa los rotores en
+ * orden, del 0 al último. Con un solo rotor y cableado identidad la
+ * cascada decodifica igual que RotorDeMapeo.
+ *
+ * Archivo de configuración (una directiva por línea, '#' comenta):
+ * @code
+ * # Tres rotores; el 0 avanza con cada LOAD y arrastra al 1 al pasar por Q
+ * avance carga
+ * rotor EKMFLGDQVZNTOWYHXUSPAIBRCJ muescas Q posicion A
+ * rotor AJDKSIRUXBLHWTMCQGZNPYFVOE muescas E
+ * rotor BDFHJLCPRTXVZNYEIWGAKMUSQO muescas V
+ * @endcode
+ *
+ * "avance ninguno" (por defecto) deja que solo las tramas MAP muevan el
+ * rotor 0. Sin muescas un rotor arrastra al siguiente al dar la vuelta
+ * (de Z a A), como un odómetro.
+ */
+
+#ifndef CASCADA_ROTORES_H
+#define CASCADA_ROTORES_H
+
+#include "RotorDeMapeo.h"
+
+/**
+ * @brief Máximo de rotores en una cascada
+ */
+const int MAX_ROTORES_CASCADA = 8;
+
+/**
+ * @brief Usos de una posición del rotor 0 en una generación antes de componer su tabla
+ */
+const int USOS_PARA_COMPONER = 16;
+
+/**
+ * @class CascadaRotores
+ * @brief Rotores en serie con la permutación compuesta en caché
+ *
+ * Hay una tabla compuesta de 256 entradas por cada posición del rotor 0,
+ * así que una trama MAP o un avance que solo mueve el rotor 0 no recompone
+ * nada: solo cambia de tabla. Cuando se mueve otro rotor cambia la
+ * generación y las tablas quedan invalidadas sin tocarlas. Una posición
+ * se compone al llegar a USOS_PARA_COMPONER usos en la generación; antes
+ * se resuelve con tres consultas sobre la composición de los rotores
+ * 1..k-1. Esas composiciones se guardan por sufijo (rotores i..k-1), de
+ * modo que cuando el rotor j avanza solo se recomponen los sufijos 1..j,
+ * casi siempre uno solo de 26 entradas. Así un LOAD cuesta una
+ * consulta mientras el estado se repite y, con avance en cada LOAD (donde
+ * casi todos los estados se usan una o pocas veces), no paga componer
+ * tablas que no se reusan ni recorre los k rotores.
+ *
+ * Ejemplo:
+ * @code
+ * CascadaRotores cascada;
+ * cascada.cargar("cascada.txt");
+ * char c = cascada.decodificar('H'); // decodifica y avanza
+ * cascada.rotar(3);                  // trama MAP
+ * @endcode
+ */
+class CascadaRotores {
+private:
+    int numeroRotores;                           ///< Rotores en uso (1..MAX_ROTORES_CASCADA)
+    int posiciones[MAX_ROTORES_CASCADA];         ///< Desplazamiento de cada rotor (0..25); el 0 es el rápido
+    char cableados[MAX_ROTORES_CASCADA][256];    ///< Cableado de cada rotor (identidad fuera de A-Z)
+    bool muescas[MAX_ROTORES_CASCADA][TAMANO_ALFABETO]; ///< Arrastra al siguiente al avanzar desde esa posición
+    bool avancePorCarga;                         ///< El rotor 0 avanza tras cada LOAD
+    
+    char tablas[TAMANO_ALFABETO][256];           ///< Tabla compuesta por cada posición del rotor 0
+    unsigned int generacionTabla[TAMANO_ALFABETO]; ///< Generación con la que se compuso cada tabla
+    unsigned int generacionUso[TAMANO_ALFABETO];   ///< Generación a la que corresponden los usos contados
+    int usos[TAMANO_ALFABETO];                   ///< Usos de cada posición sin tabla en esa generación
+    unsigned int generacion;                     ///< Cambia cada vez que se mueve un rotor distinto del 0
+    char restos[MAX_ROTORES_CASCADA + 1][256];   ///< restos[i]: composición de los rotores i..k-1 (restos[k] es la identidad)
+    int primerRestoValido;                       ///< restos[i] está al día para i >= primerRestoValido
+    long composiciones;                          ///< Tablas compuestas desde el inicio
+    
+    /**
+     * @brief Decodifica un carácter cuando la tabla de la posición actual no es válida
+     * @param in Carácter de entrada
+     * @return Carácter decodificado
+     */
+    char mapearSinTabla(char in);
+    
+    /**
+     * @brief Recompone los sufijos de restos que quedaron desactualizados
+     */
+    void componerRestos();
+    
+    /**
+     * @brief Compone la tabla de una posición del rotor 0
+     * @param posicion Desplazamiento del rotor 0
+     */
+    void componerTabla(int posicion);
+    
+    /**
+     * @brief Invalida todas las tablas compuestas
+     */
+    void invalidar();
+    
+    /**
+     * @brief Avanza los rotores 1..k-1 que arrastra el rotor 0 al pasar por su muesca
+     */
+    void arrastrar();
+    
+public:
+    /**
+     * @brief Constructor de una cascada de un rotor con cableado identidad y sin avance
+     */
+    CascadaRotores();
+    
+    /**
+     * @brief Reemplaza los rotores de la cascada
+     * @param numero Número de rotores (1..MAX_ROTORES_CASCADA)
+     * @param cableadosRotores Cableado de cada rotor: 26 letras A-Z sin repetir
+     * @param muescasRotores Letras donde cada rotor arrastra al siguiente
+     *                       (nullptr o cadena vacía: al pasar de Z a A)
+     * @param letrasIniciales Letra inicial de cada rotor (nullptr: todos en A)
+     * @param avance true para avanzar el rotor 0 tras cada LOAD
+     * @return false si algún cableado o muesca no es válido (la cascada no cambia)
+     */
+    bool definirRotores(int numero, const char* const* cableadosRotores,
+                        const char* const* muescasRotores, const char* letrasIniciales, bool avance);
+    
+    /**
+     * @brief Carga la cascada desde un archivo de configuración
+     * @param ruta Ruta del archivo
+     * @return false si no se pudo leer o tiene errores (se informan en std::cerr)
+     */
+    bool cargar(const char* ruta);
+    
+    /**
+     * @brief Decodifica un carácter con el estado actual, sin avanzar
+     * @param in Carácter de entrada
+     * @return Carácter decodificado (sin cambios si no es una letra)
+     */
+    char getMapeo(char in) {
+        int posicion = posiciones[0];
+        if (generacionTabla[posicion] == generacion) {
+            return tablas[posicion][static_cast<unsigned char>(in)];
+        }
+        return mapearSinTabla(in);
+    }
+    
+    /**
+     * @brief Decodifica el carácter de una trama LOAD y avanza si corresponde
+     * @param in Carácter de entrada
+     * @return Carácter decodificado
+     */
+    char decodificar(char in) {
+        char out = getMapeo(in);
+        if (avancePorCarga) avanzar();
+        return out;
+    }
+    
+    /**
+     * @brief Avanza el rotor 0 una posición, arrastrando a los siguientes en sus muescas
+     */
+    void avanzar() {
+        int posicion = posiciones[0];
+        posiciones[0] = (posicion + 1 == TAMANO_ALFABETO) ? 0 : posicion + 1;
+        if (muescas[0][posicion]) arrastrar();
+    }
+    
+    /**
+     * @brief Rota el rotor 0 (trama MAP), sin arrastrar a los demás
+     * @param n Posiciones a rotar (positivo: adelante, negativo: atrás)
+     */
+    void rotar(int n) {
+        n %= TAMANO_ALFABETO;
+        if (n < 0) n += TAMANO_ALFABETO;
+        posiciones[0] = (posiciones[0] + n) % TAMANO_ALFABETO;
+    }
+    
+    /**
+     * @brief Obtiene el número de rotores
+     * @return Rotores de la cascada
+     */
+    int getNumeroRotores() const { return numeroRotores; }
+    
+    /**
+     * @brief Obtiene el desplazamiento de un rotor
+     * @param rotor Índice del rotor (0..getNumeroRotores()-1)
+     * @return Desplazamiento (0..25)
+     */
+    int getDesplazamiento(int rotor) const { return posiciones[rotor]; }
+    
+    /**
+     * @brief Indica si el rotor 0 avanza con cada LOAD
+     * @return true si hay avance por carga
+     */
+    bool getAvancePorCarga() const { return avancePorCarga; }
+    
+    /**
+     * @brief Obtiene cuántas tablas se han compuesto
+     * @return Composiciones desde la construcción
+     */
+    long getComposiciones() const { return composiciones; }
+};
+
+#endif // CASCADA_ROTORES_H
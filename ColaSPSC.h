@@ -0,0 +1,135 @@
+/**
+ * @file ColaSPSC.h
+ * @brief Cola acotada sin bloqueos para un productor y un consumidor
+ * @author Eliezer Mores Oyervides
+ * @date 2025
+ */
+
+#ifndef COLA_SPSC_H
+#define COLA_SPSC_H
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @class ColaSPSC
+ * @brief Buffer circular de capacidad fija para pasar datos entre dos hilos
+ * @tparam T Tipo de los elementos (copiable)
+ * @tparam Capacidad Número de posiciones (potencia de 2)
+ * 
+ * Solo un hilo puede encolar y solo un hilo puede desencolar. Cada extremo
+ * escribe únicamente su propio índice, así que basta con cargas "acquire"
+ * y almacenamientos "release", sin mutex. Los índices están separados por
+ * relleno para que productor y consumidor no compartan línea de caché.
+ */
+template <typename T, size_t Capacidad>
+class ColaSPSC {
+private:
+    static_assert((Capacidad & (Capacidad - 1)) == 0, "La capacidad debe ser potencia de 2");
+    
+    T elementos[Capacidad];          ///< Posiciones del buffer circular
+    char separacion1[64];            ///< Relleno para separar los índices de los datos
+    std::atomic<size_t> cabeza;      ///< Siguiente posición a leer (consumidor)
+    char separacion2[64];            ///< Relleno para que cabeza y cola no compartan línea
+    std::atomic<size_t> cola;        ///< Siguiente posición a escribir (productor)
+    
+    // La cola no se copia
+    ColaSPSC(const ColaSPSC&);
+    ColaSPSC& operator=(const ColaSPSC&);
+    
+public:
+    /**
+     * @brief Constructor de una cola vacía
+     */
+    ColaSPSC() : cabeza(0), cola(0) {}
+    
+    /**
+     * @brief Intenta encolar un elemento (solo el productor)
+     * @param elemento Elemento a copiar en la cola
+     * @return false si la cola está llena
+     */
+    bool intentarEncolar(const T& elemento) {
+        size_t posicion = cola.load(std::memory_order_relaxed);
+        if (posicion - cabeza.load(std::memory_order_acquire) == Capacidad) {
+            return false;
+        }
+        elementos[posicion & (Capacidad - 1)] = elemento;
+        cola.store(posicion + 1, std::memory_order_release);
+        return true;
+    }
+    
+    /**
+     * @brief Intenta desencolar un elemento (solo el consumidor)
+     * @param elemento Recibe el elemento extraído
+     * @return false si la cola está vacía
+     */
+    bool intentarDesencolar(T& elemento) {
+        size_t posicion = cabeza.load(std::memory_order_relaxed);
+        if (posicion == cola.load(std::memory_order_acquire)) {
+            return false;
+        }
+        elemento = elementos[posicion & (Capacidad - 1)];
+        cabeza.store(posicion + 1, std::memory_order_release);
+        return true;
+    }
+    
+    /**
+     * @brief Obtiene la siguiente posición libre para llenarla en su lugar (solo el productor)
+     * @return Posición libre, o nullptr si la cola está llena
+     * 
+     * Evita copiar elementos grandes (por ejemplo lotes de tramas): el
+     * productor escribe directamente en la posición y la entrega con
+     * publicar(). Hasta entonces el consumidor no la ve.
+     */
+    T* espacioLibre() {
+        size_t posicion = cola.load(std::memory_order_relaxed);
+        if (posicion - cabeza.load(std::memory_order_acquire) == Capacidad) {
+            return nullptr;
+        }
+        return &elementos[posicion & (Capacidad - 1)];
+    }
+    
+    /**
+     * @brief Entrega al consumidor la posición obtenida con espacioLibre()
+     */
+    void publicar() {
+        cola.store(cola.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+    
+    /**
+     * @brief Obtiene el elemento más antiguo sin sacarlo (solo el consumidor)
+     * @return Elemento, o nullptr si la cola está vacía
+     * 
+     * El elemento sigue siendo del consumidor hasta que llame a liberar().
+     */
+    T* frente() {
+        size_t posicion = cabeza.load(std::memory_order_relaxed);
+        if (posicion == cola.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &elementos[posicion & (Capacidad - 1)];
+    }
+    
+    /**
+     * @brief Devuelve al productor la posición obtenida con frente()
+     */
+    void liberar() {
+        cabeza.store(cabeza.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+    
+    /**
+     * @brief Número aproximado de elementos en la cola
+     * @return Elementos pendientes (exacto solo si ningún hilo opera)
+     */
+    size_t tamano() const {
+        return cola.load(std::memory_order_acquire) - cabeza.load(std::memory_order_acquire);
+    }
+    
+    /**
+     * @brief Capacidad de la cola
+     * @return Número máximo de elementos
+     */
+    static size_t capacidad() { return Capacidad; }
+};
+
+#endif // COLA_SPSC_H
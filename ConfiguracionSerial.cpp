@@ -0,0 +1,46 @@
+/**
+ * @file ConfiguracionSerial.cpp
+ * @brief Implementación de la configuración del puerto con termios2
+ * @author Eliezer Mores Oyervides
+ */
+
+#include "ConfiguracionSerial.h"
+// Solo las definiciones del kernel: <termios.h> no puede incluirse aquí
+#include <asm/termbits.h>
+#include <linux/serial.h>
+#include <sys/ioctl.h>
+
+ConfiguracionSerial::ConfiguracionSerial()
+    : baudios(9600), vmin(0), vtime(1), bajaLatencia(false) {}
+
+bool fijarVelocidad(int descriptor, int baudios, int& efectivos) {
+    struct termios2 tty;
+    if (ioctl(descriptor, TCGETS2, &tty) != 0) return false;
+    
+    // BOTHER: la velocidad es el número de c_ispeed/c_ospeed, no una constante Bxxx
+    tty.c_cflag &= ~CBAUD;
+    tty.c_cflag |= BOTHER;
+    tty.c_ospeed = static_cast<speed_t>(baudios);
+    
+    // Entrada a la misma velocidad que la salida
+    tty.c_cflag &= ~(CBAUD << IBSHIFT);
+    tty.c_cflag |= BOTHER << IBSHIFT;
+    tty.c_ispeed = static_cast<speed_t>(baudios);
+    
+    if (ioctl(descriptor, TCSETS2, &tty) != 0) return false;
+    
+    // Lo que el driver realmente configuró
+    if (ioctl(descriptor, TCGETS2, &tty) != 0) return false;
+    efectivos = static_cast<int>(tty.c_ospeed);
+    return true;
+}
+
+bool fijarBajaLatencia(int descriptor, bool activar) {
+    struct serial_struct serie;
+    if (ioctl(descriptor, TIOCGSERIAL, &serie) != 0) return false;
+    
+    if (activar) serie.flags |= ASYNC_LOW_LATENCY;
+    else serie.flags &= ~ASYNC_LOW_LATENCY;
+    
+    return ioctl(descriptor, TIOCSSERIAL, &serie) == 0;
+}
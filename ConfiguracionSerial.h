@@ -0,0 +1,61 @@
+/**
+ * @file ConfiguracionSerial.h
+ * @brief Velocidad arbitraria (termios2/BOTHER), VMIN/VTIME y baja latencia del puerto serial
+ * @author Eliezer Mores Oyervides
+ * @date 2025
+ */
+
+#ifndef CONFIGURACION_SERIAL_H
+#define CONFIGURACION_SERIAL_H
+
+/**
+ * @brief Valor máximo de VMIN y VTIME (son un cc_t)
+ */
+const int MAXIMO_VMIN_VTIME = 255;
+
+/**
+ * @struct ConfiguracionSerial
+ * @brief Parámetros con los que SerialReader::conectar() prepara el puerto
+ *
+ * La configuración por defecto es la de siempre: 9600 baud, read() que
+ * vuelve con lo que haya o tras 0.1 s, y el driver con su latencia normal.
+ * VMIN y VTIME solo rigen las lecturas bloqueantes (leerLinea(),
+ * leerLineaVista()); con setNoBloqueante(true) read() vuelve de inmediato.
+ */
+struct ConfiguracionSerial {
+    int baudios;       ///< Velocidad pedida: cualquier valor positivo, no solo las estándar
+    int vmin;          ///< VMIN: bytes mínimos que espera un read() bloqueante (0-255)
+    int vtime;         ///< VTIME: espera entre bytes en décimas de segundo (0-255)
+    bool bajaLatencia; ///< Pedir ASYNC_LOW_LATENCY al driver (por ejemplo, ftdi_sio baja su temporizador a 1 ms)
+    
+    /**
+     * @brief Constructor con la configuración por defecto
+     */
+    ConfiguracionSerial();
+};
+
+/**
+ * @brief Fija la velocidad del puerto con termios2 y BOTHER
+ * @param descriptor Puerto abierto (ya configurado con tcsetattr)
+ * @param baudios Velocidad pedida
+ * @param efectivos Recibe la velocidad que el driver dejó configurada
+ * @return false si el driver rechazó la velocidad
+ *
+ * Con termios2 la velocidad va como número en c_ispeed/c_ospeed, así que
+ * sirven 250000, 1000000 o 2000000 aunque no exista la constante Bxxx. El
+ * driver puede redondear a lo que su reloj permite; por eso se relee.
+ *
+ * Vive en su propia unidad de traducción porque <asm/termbits.h>, que
+ * define termios2, choca con el struct termios de <termios.h>.
+ */
+bool fijarVelocidad(int descriptor, int baudios, int& efectivos);
+
+/**
+ * @brief Activa o desactiva ASYNC_LOW_LATENCY en el driver del puerto
+ * @param descriptor Puerto abierto
+ * @param activar true para pedir baja latencia
+ * @return false si el driver no lo admite (por ejemplo un pseudo-terminal)
+ */
+bool fijarBajaLatencia(int descriptor, bool activar);
+
+#endif // CONFIGURACION_SERIAL_H
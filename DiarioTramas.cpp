@@ -0,0 +1,403 @@
+/**
+ * @file DiarioTramas.cpp
+ * @brief Implementación de la clase DiarioTramas
+ * @author Eliezer Mores Oyervides
+ */
+
+#include "DiarioTramas.h"
+#include "FormatoBinario.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief Identificador al inicio del archivo
+ */
+const char FIRMA_DIARIO[12] = { 'P', 'R', 'T', '7', 'D', 'I', 'A', 'R', 'I', 'O', 0, 0 };
+
+/**
+ * @brief Versión del formato
+ */
+const unsigned int VERSION_DIARIO = 1;
+
+/**
+ * @brief Bytes de la cabecera del archivo (firma + versión)
+ */
+const size_t BYTES_CABECERA_DIARIO = sizeof(FIRMA_DIARIO) + sizeof(unsigned int);
+
+/**
+ * @brief Marca de inicio de cada grupo ("PRTG")
+ */
+const unsigned int MARCA_GRUPO = 0x47545250u;
+
+/**
+ * @brief Suma de verificación de 32 bits, 8 bytes por paso
+ */
+unsigned int sumaVerificacion(const unsigned char* datos, size_t n) {
+    unsigned long long h = 0x9E3779B97F4A7C15ULL ^ n;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        unsigned long long palabra;
+        std::memcpy(&palabra, datos + i, 8);
+        h = (h ^ palabra) * 0x100000001B3ULL;
+        h ^= h >> 29;
+    }
+    for (; i < n; i++) {
+        h = (h ^ datos[i]) * 0x100000001B3ULL;
+    }
+    h ^= h >> 32;
+    return static_cast<unsigned int>(h);
+}
+
+/**
+ * @brief Suma de verificación de un grupo: cabecera con suma = 0 y tramas
+ */
+unsigned int sumaGrupo(const unsigned char* grupo, size_t bytes) {
+    CabeceraGrupo cabecera;
+    std::memcpy(&cabecera, grupo, sizeof(cabecera));
+    cabecera.suma = 0;
+    unsigned int sumaCabecera = sumaVerificacion(reinterpret_cast<const unsigned char*>(&cabecera),
+                                                 sizeof(cabecera));
+    return sumaCabecera ^ sumaVerificacion(grupo + sizeof(cabecera), bytes);
+}
+
+/**
+ * @brief Escribe todos los bytes aunque write() escriba parcialmente
+ */
+bool escribirCompleto(int descriptor, const unsigned char* datos, size_t n) {
+    while (n > 0) {
+        ssize_t escritos = write(descriptor, datos, n);
+        if (escritos < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        datos += escritos;
+        n -= static_cast<size_t>(escritos);
+    }
+    return true;
+}
+
+/**
+ * @brief Decodifica las tramas de un grupo y las inserta en la lista
+ * @return Tramas insertadas, o -1 si los bytes no son tramas válidas
+ */
+long insertarGrupo(const unsigned char* datos, size_t bytes, ListaDeCarga& lista) {
+    long tramas = 0;
+    size_t posicion = 0;
+    while (posicion < bytes) {
+        unsigned char etiqueta = datos[posicion];
+        if (etiqueta >= ETIQUETA_LOAD && etiqueta < ETIQUETA_LOAD_EXTENDIDO) {
+            // LOAD imprimible: el caso común, un byte
+            lista.insertarLoad(static_cast<char>(0x20 + (etiqueta - ETIQUETA_LOAD)));
+            posicion++;
+        } else {
+            int longitud = longitudTramaBinaria(etiqueta);
+            TramaCompacta trama;
+            if (longitud == 0 || posicion + longitud > bytes ||
+                !decodificarTramaBinaria(reinterpret_cast<const char*>(datos + posicion), longitud, trama)) {
+                return -1;
+            }
+            lista.insertarAlFinal(trama);
+            posicion += longitud;
+        }
+        tramas++;
+    }
+    return tramas;
+}
+
+} // namespace
+
+DiarioTramas::DiarioTramas()
+    : descriptor(-1), usadosLote(0), tramasLote(0), tramasAgregadas(0), cargasAgregadas(0),
+      desplazamientoAgregado(0), descartando(false), activo(nullptr), enEscritura(nullptr), usadosActivo(sizeof(CabeceraGrupo)),
+      tramasActivo(0), tramasTotales(0), cargasTotales(0), desplazamiento(0), tramasDuraderas(0),
+      solicitudSincronia(false), detener(false), fallo(false) {
+    std::memset(&estadisticas, 0, sizeof(estadisticas));
+}
+
+DiarioTramas::~DiarioTramas() {
+    cerrar();
+}
+
+bool DiarioTramas::abrir(const char* ruta, ListaDeCarga& lista, RotorDeMapeo& rotor,
+                         EstadisticasRecuperacion& recuperacion) {
+    cerrar();
+    std::memset(&recuperacion, 0, sizeof(recuperacion));
+    
+    descriptor = open(ruta, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (descriptor < 0) {
+        std::cerr << "Error: No se pudo abrir el diario " << ruta << std::endl;
+        return false;
+    }
+    
+    if (!recuperar(lista, recuperacion)) {
+        close(descriptor);
+        descriptor = -1;
+        return false;
+    }
+    
+    // Continuar desde la última instantánea
+    tramasTotales = tramasDuraderas;
+    desplazamiento = recuperacion.desplazamiento;
+    tramasAgregadas = tramasTotales;
+    cargasAgregadas = cargasTotales;
+    desplazamientoAgregado = desplazamiento;
+    usadosLote = 0;
+    tramasLote = 0;
+    descartando = false;
+    rotor.rotar(desplazamiento - rotor.getDesplazamiento());
+    
+    // Dos buffers que se intercambian: agregar() nunca espera a que termine un write()
+    activo = new unsigned char[MAX_BYTES_PENDIENTES + sizeof(CabeceraGrupo)];
+    enEscritura = new unsigned char[MAX_BYTES_PENDIENTES + sizeof(CabeceraGrupo)];
+    usadosActivo = sizeof(CabeceraGrupo);
+    tramasActivo = 0;
+    solicitudSincronia = false;
+    detener = false;
+    fallo = false;
+    std::memset(&estadisticas, 0, sizeof(estadisticas));
+    
+    escritor = std::thread(&DiarioTramas::escribirGrupos, this);
+    return true;
+}
+
+bool DiarioTramas::recuperar(ListaDeCarga& lista, EstadisticasRecuperacion& recuperacion) {
+    struct stat info;
+    if (fstat(descriptor, &info) != 0) {
+        std::cerr << "Error: No se pudo obtener el tamaño del diario" << std::endl;
+        return false;
+    }
+    size_t tamano = static_cast<size_t>(info.st_size);
+    
+    if (tamano == 0) {
+        // Diario nuevo: escribir la cabecera y dejarla en disco
+        unsigned char cabecera[BYTES_CABECERA_DIARIO];
+        std::memcpy(cabecera, FIRMA_DIARIO, sizeof(FIRMA_DIARIO));
+        std::memcpy(cabecera + sizeof(FIRMA_DIARIO), &VERSION_DIARIO, sizeof(VERSION_DIARIO));
+        if (!escribirCompleto(descriptor, cabecera, sizeof(cabecera)) || fdatasync(descriptor) != 0) {
+            std::cerr << "Error: No se pudo escribir la cabecera del diario" << std::endl;
+            return false;
+        }
+        tramasDuraderas = 0;
+        cargasTotales = 0;
+        return true;
+    }
+    
+    if (tamano < BYTES_CABECERA_DIARIO) {
+        std::cerr << "Error: El archivo no es un diario PRT-7" << std::endl;
+        return false;
+    }
+    
+    void* mapeo = mmap(nullptr, tamano, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (mapeo == MAP_FAILED) {
+        std::cerr << "Error: No se pudo mapear el diario en memoria" << std::endl;
+        return false;
+    }
+    madvise(mapeo, tamano, MADV_SEQUENTIAL);
+    const unsigned char* datos = static_cast<const unsigned char*>(mapeo);
+    
+    unsigned int version = 0;
+    std::memcpy(&version, datos + sizeof(FIRMA_DIARIO), sizeof(version));
+    if (std::memcmp(datos, FIRMA_DIARIO, sizeof(FIRMA_DIARIO)) != 0 || version != VERSION_DIARIO) {
+        std::cerr << "Error: El archivo no es un diario PRT-7 (o es de otra versión)" << std::endl;
+        munmap(mapeo, tamano);
+        return false;
+    }
+    
+    // Recorrer los grupos mientras estén completos, íntegros y sean consecutivos
+    size_t posicion = BYTES_CABECERA_DIARIO;
+    unsigned long long tramas = 0;
+    unsigned long long cargas = 0;
+    while (tamano - posicion >= sizeof(CabeceraGrupo)) {
+        CabeceraGrupo cabecera;
+        std::memcpy(&cabecera, datos + posicion, sizeof(cabecera));
+        if (cabecera.marca != MARCA_GRUPO || cabecera.bytes > tamano - posicion - sizeof(cabecera) ||
+            cabecera.tramasTotales != tramas + cabecera.tramas || cabecera.cargasTotales > cabecera.tramasTotales ||
+            cabecera.desplazamiento < 0 || cabecera.desplazamiento >= TAMANO_ALFABETO ||
+            sumaGrupo(datos + posicion, cabecera.bytes) != cabecera.suma) {
+            break;
+        }
+        
+        long insertadas = insertarGrupo(datos + posicion + sizeof(cabecera), cabecera.bytes, lista);
+        if (insertadas != static_cast<long>(cabecera.tramas)) {
+            // La suma coincide pero las tramas no: no debería pasar; no seguir
+            std::cerr << "Advertencia: grupo del diario con tramas inválidas en el byte "
+                      << posicion << std::endl;
+            break;
+        }
+        
+        tramas = cabecera.tramasTotales;
+        cargas = cabecera.cargasTotales;
+        recuperacion.desplazamiento = cabecera.desplazamiento;
+        recuperacion.grupos++;
+        posicion += sizeof(cabecera) + cabecera.bytes;
+    }
+    munmap(mapeo, tamano);
+    
+    recuperacion.tramas = static_cast<long>(tramas);
+    recuperacion.bytesDescartados = tamano - posicion;
+    tramasDuraderas = tramas;
+    cargasTotales = cargas;
+    
+    // Quitar el grupo cortado para que los siguientes queden a continuación del último válido
+    if (posicion < tamano) {
+        if (ftruncate(descriptor, static_cast<off_t>(posicion)) != 0 || fdatasync(descriptor) != 0) {
+            std::cerr << "Error: No se pudo truncar el final inválido del diario" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void DiarioTramas::vaciar() {
+    if (tramasLote == 0) return;
+    
+    std::unique_lock<std::mutex> bloqueo(cerrojo);
+    
+    // Buffer lleno: el escritor va atrasado, esperar a que lo intercambie
+    while (descriptor >= 0 && !fallo &&
+           usadosActivo + usadosLote > MAX_BYTES_PENDIENTES + sizeof(CabeceraGrupo)) {
+        estadisticas.esperasLlenas++;
+        hayTrabajo.notify_one();
+        hayEspacio.wait(bloqueo);
+    }
+    
+    // Sin archivo o con una escritura fallida el lote no va a ninguna parte
+    if (descriptor < 0 || fallo) {
+        usadosLote = 0;
+        tramasLote = 0;
+        descartando = true;
+        return;
+    }
+    
+    std::memcpy(activo + usadosActivo, lote, usadosLote);
+    usadosActivo += usadosLote;
+    bool grupoNuevo = (tramasActivo == 0);
+    tramasActivo += tramasLote;
+    tramasTotales = tramasAgregadas;
+    cargasTotales = cargasAgregadas;
+    desplazamiento = desplazamientoAgregado;
+    usadosLote = 0;
+    tramasLote = 0;
+    
+    // Avisar al escritor al abrir un grupo (arranca el plazo) y al completarlo
+    if (grupoNuevo) {
+        primeraPendiente = std::chrono::steady_clock::now();
+        hayTrabajo.notify_one();
+    } else if (tramasActivo >= TRAMAS_POR_GRUPO) {
+        hayTrabajo.notify_one();
+    }
+}
+
+void DiarioTramas::escribirGrupos() {
+    std::unique_lock<std::mutex> bloqueo(cerrojo);
+    while (true) {
+        if (tramasActivo == 0) {
+            if (detener) break;
+            solicitudSincronia = false;
+            hayTrabajo.wait(bloqueo);
+            continue;
+        }
+        
+        // Esperar a completar el grupo, como mucho MS_POR_GRUPO desde su primera trama
+        if (tramasActivo < TRAMAS_POR_GRUPO && !detener && !solicitudSincronia) {
+            std::chrono::steady_clock::time_point plazo =
+                primeraPendiente + std::chrono::milliseconds(MS_POR_GRUPO);
+            if (hayTrabajo.wait_until(bloqueo, plazo) == std::cv_status::no_timeout) continue;
+        }
+        
+        // Tomar el grupo con la instantánea del estado tras su última trama
+        CabeceraGrupo cabecera;
+        cabecera.marca = MARCA_GRUPO;
+        cabecera.bytes = static_cast<unsigned int>(usadosActivo - sizeof(CabeceraGrupo));
+        cabecera.tramas = static_cast<unsigned int>(tramasActivo);
+        cabecera.suma = 0;
+        cabecera.tramasTotales = tramasTotales;
+        cabecera.cargasTotales = cargasTotales;
+        cabecera.desplazamiento = desplazamiento;
+        cabecera.reservado = 0;
+        
+        unsigned char* grupo = activo;
+        size_t bytesGrupo = usadosActivo;
+        activo = enEscritura;
+        enEscritura = grupo;
+        usadosActivo = sizeof(CabeceraGrupo);
+        tramasActivo = 0;
+        solicitudSincronia = false;
+        hayEspacio.notify_all();
+        bloqueo.unlock();
+        
+        // Un write() y un fdatasync() por grupo, fuera del cerrojo
+        std::memcpy(grupo, &cabecera, sizeof(cabecera));
+        cabecera.suma = sumaGrupo(grupo, cabecera.bytes);
+        std::memcpy(grupo, &cabecera, sizeof(cabecera));
+        
+        std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+        bool escrito = escribirCompleto(descriptor, grupo, bytesGrupo) && fdatasync(descriptor) == 0;
+        unsigned long long ns = static_cast<unsigned long long>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - inicio).count());
+        
+        bloqueo.lock();
+        if (!escrito) {
+            std::cerr << "Error: No se pudo escribir el diario: " << std::strerror(errno) << std::endl;
+            fallo = true;
+            hayEspacio.notify_all();
+            break;
+        }
+        tramasDuraderas = cabecera.tramasTotales;
+        estadisticas.grupos++;
+        estadisticas.tramas += cabecera.tramas;
+        estadisticas.bytes += bytesGrupo;
+        estadisticas.nsSincronizacion += ns;
+        if (ns > estadisticas.maxNsSincronizacion) estadisticas.maxNsSincronizacion = ns;
+        hayEspacio.notify_all();
+    }
+}
+
+bool DiarioTramas::sincronizar() {
+    vaciar();
+    
+    std::unique_lock<std::mutex> bloqueo(cerrojo);
+    if (descriptor < 0) return false;
+    
+    unsigned long long objetivo = tramasAgregadas;
+    while (tramasDuraderas < objetivo && !fallo) {
+        solicitudSincronia = true;
+        hayTrabajo.notify_one();
+        hayEspacio.wait(bloqueo);
+    }
+    return !fallo;
+}
+
+void DiarioTramas::cerrar() {
+    if (escritor.joinable()) {
+        vaciar();
+        {
+            std::lock_guard<std::mutex> bloqueo(cerrojo);
+            detener = true;
+        }
+        hayTrabajo.notify_one();
+        escritor.join();
+    }
+    
+    if (descriptor >= 0) {
+        close(descriptor);
+        descriptor = -1;
+    }
+    delete[] activo;
+    delete[] enEscritura;
+    activo = nullptr;
+    enEscritura = nullptr;
+}
+
+EstadisticasDiario DiarioTramas::getEstadisticas() {
+    std::lock_guard<std::mutex> bloqueo(cerrojo);
+    return estadisticas;
+}
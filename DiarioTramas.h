@@ -0,0 +1,258 @@
+/**
+ * @file DiarioTramas.h
+ * @brief Diario en disco de las tramas recibidas, con confirmación por grupos y recuperación
+ * @author Eliezer Mores Oyervides
+ * @date 2025
+ *
+ * Formato del archivo:
+ *
+ *   Cabecera (16 bytes): "PRT7DIARIO" + relleno + versión
+ *   Grupo:   CabeceraGrupo (40 bytes) + tramas en el formato de FormatoBinario.h
+ *   Grupo:   ...
+ *
+ * Cada grupo se escribe con un solo write() seguido de un fdatasync(), y
+ * su cabecera guarda los totales del diario y el desplazamiento del rotor
+ * después del grupo (una instantánea por grupo) más una suma de
+ * verificación, así que un grupo cortado por una caída se detecta y se
+ * descarta al recuperar.
+ */
+
+#ifndef DIARIO_TRAMAS_H
+#define DIARIO_TRAMAS_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include "TramaCompacta.h"
+#include "FormatoBinario.h"
+#include "ListaDeCarga.h"
+#include "RotorDeMapeo.h"
+
+/**
+ * @brief Tramas pendientes que disparan la escritura de un grupo
+ */
+const int TRAMAS_POR_GRUPO = 512;
+
+/**
+ * @brief Milisegundos que una trama puede esperar a que se complete su grupo
+ */
+const int MS_POR_GRUPO = 10;
+
+/**
+ * @brief Bytes pendientes a partir de los cuales vaciar() espera al escritor
+ */
+const size_t MAX_BYTES_PENDIENTES = 1 << 20;
+
+/**
+ * @brief Bytes del lote local donde agregar() codifica sin tomar el cerrojo
+ */
+const size_t BYTES_LOTE_DIARIO = 4096;
+
+/**
+ * @struct CabeceraGrupo
+ * @brief Cabecera de un grupo de tramas del diario
+ */
+struct CabeceraGrupo {
+    unsigned int marca;                ///< MARCA_GRUPO
+    unsigned int bytes;                ///< Bytes de tramas que siguen a la cabecera
+    unsigned int tramas;               ///< Tramas del grupo
+    unsigned int suma;                 ///< Suma de verificación de la cabecera (con suma = 0) y las tramas
+    unsigned long long tramasTotales;  ///< Tramas del diario hasta este grupo inclusive
+    unsigned long long cargasTotales;  ///< Tramas LOAD del diario hasta este grupo inclusive
+    int desplazamiento;                ///< Desplazamiento del rotor después del grupo (0..25)
+    unsigned int reservado;            ///< Cero
+};
+
+/**
+ * @struct EstadisticasRecuperacion
+ * @brief Resultado de recuperar un diario al abrirlo
+ */
+struct EstadisticasRecuperacion {
+    long grupos;            ///< Grupos válidos leídos
+    long tramas;            ///< Tramas insertadas en la lista
+    int desplazamiento;     ///< Desplazamiento del rotor recuperado
+    size_t bytesDescartados; ///< Bytes del final que no formaban un grupo completo y válido
+};
+
+/**
+ * @struct EstadisticasDiario
+ * @brief Contadores del escritor del diario
+ */
+struct EstadisticasDiario {
+    long grupos;                        ///< Grupos escritos
+    long tramas;                        ///< Tramas escritas
+    unsigned long long bytes;           ///< Bytes escritos (cabeceras incluidas)
+    long esperasLlenas;                 ///< Veces que vaciar() esperó por el buffer lleno
+    unsigned long long nsSincronizacion; ///< Tiempo total en write() + fdatasync()
+    unsigned long long maxNsSincronizacion; ///< Grupo más lento en write() + fdatasync()
+};
+
+/**
+ * @class DiarioTramas
+ * @brief Agrega tramas a un archivo de solo anexado y las confirma en disco por grupos
+ *
+ * agregar() solo codifica la trama en un lote local, sin cerrojo, y
+ * vaciar() pasa el lote al buffer del escritor (una vez por lectura del
+ * puerto, igual que SalidaTramas::vaciar()). Un hilo escritor intercambia
+ * ese buffer por otro y lo escribe como un grupo cuando junta
+ * TRAMAS_POR_GRUPO tramas o cuando la más antigua lleva MS_POR_GRUPO ms
+ * esperando, de modo que un fdatasync() cubre muchas tramas y el camino
+ * caliente nunca espera al disco. Si el disco se queda atrás y el buffer
+ * llega a MAX_BYTES_PENDIENTES, vaciar() espera: la memoria pendiente está
+ * acotada.
+ *
+ * agregar(), vaciar() y sincronizar() deben llamarse desde un solo hilo.
+ *
+ * Ejemplo:
+ * @code
+ * DiarioTramas diario;
+ * EstadisticasRecuperacion recuperacion;
+ * diario.abrir("sesion.diario", lista, rotor, recuperacion);
+ * diario.agregar(trama);
+ * diario.vaciar();
+ * diario.sincronizar();
+ * @endcode
+ */
+class DiarioTramas {
+private:
+    int descriptor;              ///< Archivo del diario (O_APPEND)
+    std::thread escritor;        ///< Hilo que escribe los grupos
+    std::mutex cerrojo;          ///< Protege los buffers y el estado compartido
+    std::condition_variable hayTrabajo; ///< Despierta al escritor
+    std::condition_variable hayEspacio; ///< Despierta a quien espera buffer o confirmación
+    
+    unsigned char lote[BYTES_LOTE_DIARIO]; ///< Tramas codificadas aún no entregadas al escritor (solo el productor)
+    size_t usadosLote;           ///< Bytes usados de lote
+    int tramasLote;              ///< Tramas en lote
+    unsigned long long tramasAgregadas; ///< Tramas agregadas desde el inicio del diario (solo el productor)
+    unsigned long long cargasAgregadas; ///< Tramas LOAD agregadas (solo el productor)
+    int desplazamientoAgregado;  ///< Desplazamiento del rotor tras la última trama agregada (solo el productor)
+    bool descartando;            ///< vaciar() vio el fallo: agregar() ya no codifica nada (solo el productor)
+    
+    unsigned char* activo;       ///< Buffer donde agregar() codifica (empieza con espacio para la cabecera)
+    unsigned char* enEscritura;  ///< Buffer que escribe el escritor
+    size_t usadosActivo;         ///< Bytes usados de activo, cabecera incluida
+    int tramasActivo;            ///< Tramas en activo
+    std::chrono::steady_clock::time_point primeraPendiente; ///< Llegada de la primera trama de activo
+    
+    unsigned long long tramasTotales;   ///< Tramas entregadas al escritor desde el inicio del diario
+    unsigned long long cargasTotales;   ///< Tramas LOAD entregadas al escritor
+    int desplazamiento;                 ///< Desplazamiento del rotor tras la última trama entregada
+    unsigned long long tramasDuraderas; ///< Tramas ya confirmadas con fdatasync()
+    
+    bool solicitudSincronia;     ///< sincronizar() pide escribir sin esperar a completar el grupo
+    bool detener;                ///< cerrar() pide vaciar y terminar
+    bool fallo;                  ///< Falló una escritura: el diario dejó de ser durable
+    EstadisticasDiario estadisticas; ///< Contadores del escritor
+    
+    /**
+     * @brief Bucle del hilo escritor
+     */
+    void escribirGrupos();
+    
+    /**
+     * @brief Lee los grupos válidos del archivo abierto y descarta el final cortado
+     * @param lista Lista donde se insertan las tramas recuperadas
+     * @param recuperacion Recibe el resultado
+     * @return false si el archivo no es un diario o no se pudo leer
+     */
+    bool recuperar(ListaDeCarga& lista, EstadisticasRecuperacion& recuperacion);
+    
+    // El diario es dueño de su archivo y de su hilo: no se copia
+    DiarioTramas(const DiarioTramas&);
+    DiarioTramas& operator=(const DiarioTramas&);
+    
+public:
+    /**
+     * @brief Constructor
+     */
+    DiarioTramas();
+    
+    /**
+     * @brief Destructor que confirma lo pendiente y cierra el archivo
+     */
+    ~DiarioTramas();
+    
+    /**
+     * @brief Abre (o crea) un diario, recupera su contenido e inicia el escritor
+     * @param ruta Ruta del archivo
+     * @param lista Lista donde se insertan las tramas recuperadas, en orden
+     * @param rotor Rotor que se deja en el estado de la última instantánea
+     * @param recuperacion Recibe cuántas tramas se recuperaron y cuántos bytes se descartaron
+     * @return true si el diario quedó listo para agregar tramas
+     *
+     * La recuperación mapea el archivo con mmap y decodifica las tramas
+     * binarias directamente, sin parsear texto. Un grupo incompleto o con
+     * la suma de verificación incorrecta (una caída a mitad de un write())
+     * termina la recuperación y el archivo se trunca ahí.
+     */
+    bool abrir(const char* ruta, ListaDeCarga& lista, RotorDeMapeo& rotor,
+               EstadisticasRecuperacion& recuperacion);
+    
+    /**
+     * @brief Agrega una trama al lote local
+     * @param trama Trama LOAD o MAP
+     *
+     * No toma el cerrojo ni espera al disco: solo codifica la trama (un
+     * byte para un LOAD imprimible). Si el lote se llena se entrega con vaciar().
+     * Tras un fallo de escritura no hace nada (ver getFallido()).
+     */
+    void agregar(const TramaCompacta& trama) {
+        if (descartando) return;
+        if (usadosLote + MAX_TRAMA_BINARIA > BYTES_LOTE_DIARIO) vaciar();
+        
+        unsigned char c = static_cast<unsigned char>(trama.caracter);
+        if (trama.esLoad() && c >= 0x20 && c < 0x7F) {
+            lote[usadosLote++] = static_cast<unsigned char>(ETIQUETA_LOAD + (c - 0x20));
+        } else {
+            usadosLote += codificarTramaBinaria(trama, lote + usadosLote);
+        }
+        
+        tramasLote++;
+        tramasAgregadas++;
+        if (trama.esLoad()) {
+            cargasAgregadas++;
+        } else {
+            desplazamientoAgregado = (desplazamientoAgregado + trama.rotacion % TAMANO_ALFABETO + TAMANO_ALFABETO)
+                                     % TAMANO_ALFABETO;
+        }
+    }
+    
+    /**
+     * @brief Entrega el lote local al escritor
+     *
+     * Toma el cerrojo una vez por lote. Solo espera si hay
+     * MAX_BYTES_PENDIENTES sin escribir. Si el diario no está abierto o
+     * una escritura falló, el lote se descarta.
+     */
+    void vaciar();
+    
+    /**
+     * @brief Indica si el diario dejó de escribir por un fallo (disco lleno, EIO)
+     * @return true desde el vaciar() que encontró el fallo
+     *
+     * Lo consulta el mismo hilo que llama a agregar() y vaciar(), sin cerrojo.
+     */
+    bool getFallido() const { return descartando; }
+    
+    /**
+     * @brief Entrega el lote y espera a que todo lo agregado esté confirmado en disco
+     * @return false si alguna escritura falló
+     */
+    bool sincronizar();
+    
+    /**
+     * @brief Confirma lo pendiente, detiene el escritor y cierra el archivo
+     */
+    void cerrar();
+    
+    /**
+     * @brief Obtiene una copia de los contadores del escritor
+     * @return Estadísticas hasta el momento
+     */
+    EstadisticasDiario getEstadisticas();
+};
+
+#endif // DIARIO_TRAMAS_H
@@ -0,0 +1,88 @@
+/**
+ * @file FormatoBinario.cpp
+ * @brief Implementación del formato binario de tramas PRT-7
+ * @author Eliezer Mores Oyervides
+ */
+
+#include "FormatoBinario.h"
+#include <cstdio>
+#include <cstring>
+
+int codificarTramaBinaria(const TramaCompacta& trama, unsigned char* salida) {
+    if (trama.esLoad()) {
+        unsigned char c = static_cast<unsigned char>(trama.caracter);
+        if (c >= 0x20 && c < 0x7F) {
+            salida[0] = static_cast<unsigned char>(ETIQUETA_LOAD + (c - 0x20));
+            return 1;
+        }
+        salida[0] = ETIQUETA_LOAD_EXTENDIDO;
+        salida[1] = c & 0x7F;
+        salida[2] = c >> 7;
+        return 3;
+    }
+    
+    // Zigzag: las rotaciones pequeñas (positivas o negativas) ocupan un byte
+    unsigned int valor = static_cast<unsigned int>(trama.rotacion);
+    unsigned int zigzag = (valor << 1) ^ (trama.rotacion < 0 ? 0xFFFFFFFFu : 0u);
+    
+    int bytes = 0;
+    do {
+        salida[1 + bytes++] = zigzag & 0x7F;
+        zigzag >>= 7;
+    } while (zigzag != 0);
+    
+    salida[0] = static_cast<unsigned char>(ETIQUETA_MAP + bytes);
+    return 1 + bytes;
+}
+
+bool decodificarTramaBinaria(const char* datos, int longitud, TramaCompacta& trama) {
+    if (longitud <= 0) return false;
+    
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(datos);
+    unsigned char etiqueta = bytes[0];
+    if (longitudTramaBinaria(etiqueta) != longitud) return false;
+    
+    // La carga nunca lleva el bit alto
+    for (int i = 1; i < longitud; i++) {
+        if (bytes[i] & 0x80) return false;
+    }
+    
+    if (etiqueta < ETIQUETA_LOAD_EXTENDIDO) {
+        trama = TramaCompacta::load(static_cast<char>(0x20 + (etiqueta - ETIQUETA_LOAD)));
+        return true;
+    }
+    
+    if (etiqueta == ETIQUETA_LOAD_EXTENDIDO) {
+        trama = TramaCompacta::load(static_cast<char>(bytes[1] | ((bytes[2] & 1) << 7)));
+        return true;
+    }
+    
+    if (etiqueta > ETIQUETA_MAP && etiqueta <= ETIQUETA_MAP + 5) {
+        unsigned int zigzag = 0;
+        for (int i = longitud - 1; i >= 1; i--) {
+            zigzag = (zigzag << 7) | bytes[i];
+        }
+        int rotacion = static_cast<int>(zigzag >> 1) ^ -static_cast<int>(zigzag & 1);
+        trama = TramaCompacta::map(rotacion);
+        return true;
+    }
+    
+    // Sincronía y END no son tramas de datos
+    return false;
+}
+
+int escribirTramaTexto(const TramaCompacta& trama, char* salida) {
+    if (trama.esLoad()) {
+        if (trama.caracter == ' ') {
+            std::memcpy(salida, "L,Space", 8);
+            return 7;
+        }
+        salida[0] = 'L';
+        salida[1] = ',';
+        salida[2] = trama.caracter;
+        salida[3] = '\0';
+        return 3;
+    }
+    
+    return std::sprintf(salida, "M,%d", trama.rotacion);
+}
@@ -0,0 +1,104 @@
+/**
+ * @file FormatoBinario.h
+ * @brief Formato binario compacto de las tramas PRT-7
+ * @author Eliezer Mores Oyervides
+ * @date 2025
+ *
+ * Cada trama empieza con un byte de etiqueta con el bit alto encendido y
+ * sigue con 0 a 5 bytes de carga con el bit alto apagado, así que el
+ * receptor se resincroniza solo en el siguiente byte >= 0x80. El texto
+ * "L,A" / "M,5" nunca usa esos bytes, lo que permite detectar el formato
+ * automáticamente.
+ *
+ *   0x80..0xDE  LOAD de un carácter imprimible (0x20 + etiqueta - 0x80), 1 byte
+ *   0xDF        LOAD de cualquier otro carácter: 2 bytes de carga (bits 0-6 y bit 7)
+ *   0xE1..0xE5  MAP: 1 a 5 bytes de carga con la rotación en zigzag, 7 bits por byte
+ *   0xF0        Sincronización (el emisor la envía al empezar; no es una trama)
+ *   0xFF        END
+ *
+ * A 9600 baud un LOAD pasa de 5-9 bytes ("L,A\r\n", "L,Space\r\n") a 1 byte.
+ */
+
+#ifndef FORMATO_BINARIO_H
+#define FORMATO_BINARIO_H
+
+#include "TramaCompacta.h"
+
+/**
+ * @brief Primera etiqueta de LOAD imprimible (carácter ' ')
+ */
+const unsigned char ETIQUETA_LOAD = 0x80;
+
+/**
+ * @brief Etiqueta de LOAD con el carácter en los bytes de carga
+ */
+const unsigned char ETIQUETA_LOAD_EXTENDIDO = 0xDF;
+
+/**
+ * @brief Etiqueta base de MAP; el nibble bajo es el número de bytes de carga
+ */
+const unsigned char ETIQUETA_MAP = 0xE0;
+
+/**
+ * @brief Byte de sincronización
+ */
+const unsigned char ETIQUETA_SINCRONIA = 0xF0;
+
+/**
+ * @brief Etiqueta de fin de flujo
+ */
+const unsigned char ETIQUETA_FIN = 0xFF;
+
+/**
+ * @brief Tamaño máximo de una trama binaria en bytes
+ */
+const int MAX_TRAMA_BINARIA = 6;
+
+/**
+ * @brief Indica si un byte es una etiqueta de trama binaria
+ * @param byte Byte recibido
+ * @return true si tiene el bit alto encendido
+ */
+inline bool esEtiquetaBinaria(char byte) {
+    return (static_cast<unsigned char>(byte) & 0x80) != 0;
+}
+
+/**
+ * @brief Longitud total de la trama que empieza con una etiqueta
+ * @param etiqueta Primer byte de la trama
+ * @return Bytes de la trama incluyendo la etiqueta, o 0 si no es una etiqueta válida
+ */
+inline int longitudTramaBinaria(unsigned char etiqueta) {
+    if (etiqueta < ETIQUETA_LOAD_EXTENDIDO) return (etiqueta >= ETIQUETA_LOAD) ? 1 : 0;
+    if (etiqueta == ETIQUETA_LOAD_EXTENDIDO) return 3;
+    if (etiqueta > ETIQUETA_MAP && etiqueta <= ETIQUETA_MAP + 5) return 1 + (etiqueta - ETIQUETA_MAP);
+    if (etiqueta == ETIQUETA_SINCRONIA || etiqueta == ETIQUETA_FIN) return 1;
+    return 0;
+}
+
+/**
+ * @brief Codifica una trama en formato binario
+ * @param trama Trama a codificar
+ * @param salida Buffer de al menos MAX_TRAMA_BINARIA bytes
+ * @return Número de bytes escritos
+ */
+int codificarTramaBinaria(const TramaCompacta& trama, unsigned char* salida);
+
+/**
+ * @brief Decodifica una trama binaria completa
+ * @param datos Bytes de la trama, empezando por la etiqueta
+ * @param longitud Número de bytes disponibles
+ * @param trama Trama resultante
+ * @return true si los bytes forman exactamente una trama LOAD o MAP válida
+ */
+bool decodificarTramaBinaria(const char* datos, int longitud, TramaCompacta& trama);
+
+/**
+ * @brief Escribe una trama en el formato de texto ("L,A", "L,Space", "M,-2")
+ * @param trama Trama a escribir
+ * @param salida Buffer de al menos 16 bytes; se termina en '\0'
+ * @return Número de caracteres escritos (sin contar el '\0')
+ */
+int escribirTramaTexto(const TramaCompacta& trama, char* salida);
+
+#endif // FORMATO_BINARIO_H
@@ -0,0 +1,198 @@
+/**
+ * @file IngestaMultipuerto.cpp
+ * @brief Implementación de la clase IngestaMultipuerto
+ * @author Eliezer Mores Oyervides
+ */
+
+#include "IngestaMultipuerto.h"
+#include "Instrumentacion.h"
+#include "Tramas.h"
+#include <cstring>
+#include <chrono>
+#include <poll.h>
+
+namespace {
+
+/**
+ * @brief Milisegundos que un lector espera datos antes de revisar la parada
+ */
+const int MS_ESPERA_LECTOR = 100;
+
+} // namespace
+
+FlujoPRT7::FlujoPRT7()
+    : lecturaTerminada(false), tramasLeidas(0), tramasDecodificadas(0), finRecibido(false) {
+    nombrePuerto[0] = '\0';
+}
+
+IngestaMultipuerto::IngestaMultipuerto()
+    : numeroFlujos(0), lectores(nullptr), decodificadores(nullptr),
+      numeroDecodificadores(0), detenido(false), flujosActivos(0) {}
+
+IngestaMultipuerto::~IngestaMultipuerto() {
+    detener();
+    esperar();
+    for (int i = 0; i < numeroFlujos; i++) {
+        delete flujos[i];
+    }
+}
+
+bool IngestaMultipuerto::agregarPuerto(const char* nombrePuerto, int baudRate) {
+    ConfiguracionSerial configuracion;
+    configuracion.baudios = baudRate;
+    return agregarPuerto(nombrePuerto, configuracion);
+}
+
+bool IngestaMultipuerto::agregarPuerto(const char* nombrePuerto, const ConfiguracionSerial& configuracion) {
+    if (numeroFlujos >= MAX_FLUJOS || lectores != nullptr) return false;
+    
+    FlujoPRT7* flujo = new FlujoPRT7();
+    std::strncpy(flujo->nombrePuerto, nombrePuerto, sizeof(flujo->nombrePuerto) - 1);
+    flujo->nombrePuerto[sizeof(flujo->nombrePuerto) - 1] = '\0';
+    
+    if (!flujo->serial.conectar(nombrePuerto, configuracion) || !flujo->serial.setNoBloqueante(true)) {
+        delete flujo;
+        return false;
+    }
+    
+    flujos[numeroFlujos++] = flujo;
+    return true;
+}
+
+bool IngestaMultipuerto::iniciar(int hilosDecodificacion) {
+    if (numeroFlujos == 0 || lectores != nullptr) return false;
+    
+    if (hilosDecodificacion < 1) hilosDecodificacion = 1;
+    if (hilosDecodificacion > numeroFlujos) hilosDecodificacion = numeroFlujos;
+    
+    flujosActivos.store(numeroFlujos);
+    numeroDecodificadores = hilosDecodificacion;
+    
+    lectores = new std::thread[numeroFlujos];
+    for (int i = 0; i < numeroFlujos; i++) {
+        lectores[i] = std::thread(&IngestaMultipuerto::leer, this, flujos[i]);
+    }
+    
+    decodificadores = new std::thread[numeroDecodificadores];
+    for (int i = 0; i < numeroDecodificadores; i++) {
+        decodificadores[i] = std::thread(&IngestaMultipuerto::decodificar, this, i);
+    }
+    
+    return true;
+}
+
+void IngestaMultipuerto::esperar() {
+    if (lectores != nullptr) {
+        for (int i = 0; i < numeroFlujos; i++) {
+            if (lectores[i].joinable()) lectores[i].join();
+        }
+    }
+    if (decodificadores != nullptr) {
+        for (int i = 0; i < numeroDecodificadores; i++) {
+            if (decodificadores[i].joinable()) decodificadores[i].join();
+        }
+    }
+    delete[] lectores;
+    delete[] decodificadores;
+    lectores = nullptr;
+    decodificadores = nullptr;
+}
+
+void IngestaMultipuerto::leer(FlujoPRT7* flujo) {
+    struct pollfd vigilado;
+    vigilado.fd = flujo->serial.getDescriptor();
+    vigilado.events = POLLIN;
+    
+    const char* linea;
+    int longitud;
+    bool terminado = false;
+    
+    while (!terminado && !detenido.load(std::memory_order_relaxed)) {
+        // Dormir hasta que haya datos (o revisar la parada periódicamente)
+        int listo = poll(&vigilado, 1, MS_ESPERA_LECTOR);
+        if (listo < 0) break;
+        if (listo == 0) continue;
+        
+        // Solo -1 es un puerto colgado; 0 bytes es EAGAIN/EINTR
+        int leidos = flujo->serial.leerDisponible();
+        if (leidos < 0) break;
+        if (leidos == 0) continue;
+        
+        while (!terminado && flujo->serial.extraerLinea(linea, longitud)) {
+            if (esTramaFin(linea, longitud)) {
+                flujo->finRecibido = true;
+                terminado = true;
+                break;
+            }
+            
+            TramaCompacta trama;
+            bool valida;
+            {
+                MedicionEtapa medicion(ETAPA_PARSEO);
+                valida = parsearTrama(linea, longitud, trama);
+            }
+            if (!valida) {
+                contar(CONTADOR_LINEAS_INVALIDAS);
+                continue;
+            }
+            
+            // Cola llena: ceder el CPU hasta que el decodificador avance
+            bool encolada;
+            while (!(encolada = flujo->cola.intentarEncolar(trama))) {
+                if (detenido.load(std::memory_order_relaxed)) {
+                    terminado = true;
+                    break;
+                }
+                std::this_thread::yield();
+            }
+            if (encolada) flujo->tramasLeidas.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    
+    flujo->lecturaTerminada.store(true, std::memory_order_release);
+}
+
+void IngestaMultipuerto::decodificar(int indice) {
+    int pendientes = 0;
+    for (int i = indice; i < numeroFlujos; i += numeroDecodificadores) pendientes++;
+    
+    bool* terminado = new bool[numeroFlujos]();
+    
+    while (pendientes > 0) {
+        bool huboTrabajo = false;
+        
+        for (int i = indice; i < numeroFlujos; i += numeroDecodificadores) {
+            if (terminado[i]) continue;
+            FlujoPRT7* flujo = flujos[i];
+            
+            // Leer la bandera antes de vaciar la cola para no perder tramas
+            bool sinMasDatos = flujo->lecturaTerminada.load(std::memory_order_acquire);
+            
+            TramaCompacta trama;
+            while (flujo->cola.intentarDesencolar(trama)) {
+                flujo->lista.insertarAlFinal(trama);
+                if (trama.esLoad()) {
+                    flujo->mensaje.agregar(flujo->rotor.getMapeo(trama.caracter));
+                } else {
+                    flujo->rotor.rotar(trama.rotacion);
+                }
+                flujo->tramasDecodificadas++;
+                contar(CONTADOR_TRAMAS);
+                huboTrabajo = true;
+            }
+            
+            if (sinMasDatos) {
+                terminado[i] = true;
+                pendientes--;
+                flujosActivos.fetch_sub(1);
+            }
+        }
+        
+        if (!huboTrabajo) {
+            // Sin tramas en ninguna cola propia: dormir un poco
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+    
+    delete[] terminado;
+}
@@ -0,0 +1,155 @@
+/**
+ * @file IngestaMultipuerto.h
+ * @brief Ingesta concurrente de varios puertos PRT-7, cada uno con su rotor y su lista
+ * @author Eliezer Mores Oyervides
+ * @date 2025
+ */
+
+#ifndef INGESTA_MULTIPUERTO_H
+#define INGESTA_MULTIPUERTO_H
+
+#include <atomic>
+#include <thread>
+#include "ColaSPSC.h"
+#include "ListaDeCarga.h"
+#include "MensajeDecodificado.h"
+#include "RotorDeMapeo.h"
+#include "SerialReader.h"
+#include "TramaCompacta.h"
+
+/**
+ * @brief Número máximo de puertos que maneja una IngestaMultipuerto
+ */
+const int MAX_FLUJOS = 64;
+
+/**
+ * @brief Capacidad de la cola entre el lector y el decodificador de cada flujo
+ */
+const size_t CAPACIDAD_COLA_FLUJO = 4096;
+
+/**
+ * @struct FlujoPRT7
+ * @brief Estado de un emisor PRT-7: su puerto, su cola, su lista y su rotor
+ * 
+ * El hilo lector del puerto es el único productor de la cola y el hilo
+ * decodificador asignado al flujo es su único consumidor.
+ */
+struct FlujoPRT7 {
+    char nombrePuerto[100];  ///< Ruta del puerto serial
+    SerialReader serial;     ///< Lector del puerto
+    ColaSPSC<TramaCompacta, CAPACIDAD_COLA_FLUJO> cola; ///< Tramas parseadas pendientes de decodificar
+    std::atomic<bool> lecturaTerminada; ///< El lector ya no encolará más tramas
+    ListaDeCarga lista;      ///< Tramas del flujo en orden de llegada
+    RotorDeMapeo rotor;      ///< Rotor propio del flujo
+    MensajeDecodificado mensaje; ///< Mensaje decodificado
+    std::atomic<long> tramasLeidas;   ///< Tramas encoladas por el lector
+    long tramasDecodificadas;         ///< Tramas procesadas por el decodificador
+    bool finRecibido;        ///< El emisor envió END
+    
+    /**
+     * @brief Constructor de un flujo sin puerto
+     */
+    FlujoPRT7();
+};
+
+/**
+ * @class IngestaMultipuerto
+ * @brief Lee varios puertos en paralelo y decodifica sus tramas con un grupo de hilos
+ * 
+ * Cada puerto tiene un hilo lector dedicado que parsea las líneas y pasa
+ * las tramas por una ColaSPSC sin bloqueos. Un grupo de hilos
+ * decodificadores consume las colas: el flujo i pertenece siempre al
+ * hilo i % hilos, lo que conserva el orden de las tramas de cada flujo
+ * y mantiene cada cola con un solo consumidor.
+ */
+class IngestaMultipuerto {
+private:
+    FlujoPRT7* flujos[MAX_FLUJOS];  ///< Flujos registrados
+    int numeroFlujos;               ///< Número de flujos registrados
+    std::thread* lectores;          ///< Un hilo lector por flujo
+    std::thread* decodificadores;   ///< Grupo de hilos decodificadores
+    int numeroDecodificadores;      ///< Tamaño del grupo
+    std::atomic<bool> detenido;     ///< Solicitud de parada
+    std::atomic<int> flujosActivos; ///< Flujos que aún no terminan de decodificarse
+    
+    /**
+     * @brief Cuerpo del hilo lector de un flujo
+     * @param flujo Flujo a leer
+     */
+    void leer(FlujoPRT7* flujo);
+    
+    /**
+     * @brief Cuerpo de un hilo decodificador
+     * @param indice Índice del hilo dentro del grupo
+     */
+    void decodificar(int indice);
+    
+    // La ingesta es dueña de sus hilos y flujos: no se copia
+    IngestaMultipuerto(const IngestaMultipuerto&);
+    IngestaMultipuerto& operator=(const IngestaMultipuerto&);
+    
+public:
+    /**
+     * @brief Constructor
+     */
+    IngestaMultipuerto();
+    
+    /**
+     * @brief Destructor que detiene los hilos y libera los flujos
+     */
+    ~IngestaMultipuerto();
+    
+    /**
+     * @brief Conecta un puerto y lo registra como un flujo nuevo
+     * @param nombrePuerto Ruta del puerto (ej: "/dev/ttyUSB0")
+     * @param baudRate Velocidad de comunicación
+     * @return true si se conectó, false si falló o se alcanzó MAX_FLUJOS
+     */
+    bool agregarPuerto(const char* nombrePuerto, int baudRate = 9600);
+    
+    /**
+     * @brief Conecta un puerto con una configuración completa y lo registra como un flujo nuevo
+     * @param nombrePuerto Ruta del puerto (ej: "/dev/ttyUSB0")
+     * @param configuracion Velocidad, VMIN/VTIME y baja latencia
+     * @return true si se conectó, false si falló o se alcanzó MAX_FLUJOS
+     */
+    bool agregarPuerto(const char* nombrePuerto, const ConfiguracionSerial& configuracion);
+    
+    /**
+     * @brief Arranca los lectores y el grupo de decodificadores
+     * @param hilosDecodificacion Número de hilos decodificadores (se limita al número de flujos)
+     * @return true si se arrancaron los hilos
+     */
+    bool iniciar(int hilosDecodificacion);
+    
+    /**
+     * @brief Indica si todos los flujos terminaron (END, error o parada)
+     * @return true si no queda trabajo pendiente
+     */
+    bool terminada() const { return flujosActivos.load() == 0; }
+    
+    /**
+     * @brief Solicita a todos los hilos que terminen
+     */
+    void detener() { detenido.store(true); }
+    
+    /**
+     * @brief Espera a que terminen todos los hilos
+     */
+    void esperar();
+    
+    /**
+     * @brief Obtiene el número de flujos registrados
+     * @return Número de flujos
+     */
+    int getNumeroFlujos() const { return numeroFlujos; }
+    
+    /**
+     * @brief Obtiene un flujo (solo consultar después de esperar())
+     * @param i Índice del flujo
+     * @return Referencia al flujo
+     */
+    const FlujoPRT7& getFlujo(int i) const { return *flujos[i]; }
+};
+
+#endif // INGESTA_MULTIPUERTO_H
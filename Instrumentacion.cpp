@@ -0,0 +1,145 @@
+/**
+ * @file Instrumentacion.cpp
+ * @brief Implementación de los histogramas, contadores y volcado de métricas
+ * @author Eliezer Mores Oyervides
+ */
+
+#include "Instrumentacion.h"
+#include <cmath>
+#include <cstring>
+#include <ostream>
+
+bool parsearFormatoVolcado(const char* nombre, FormatoVolcado& formato) {
+    if (std::strcmp(nombre, "texto") == 0) formato = VOLCADO_TEXTO;
+    else if (std::strcmp(nombre, "json") == 0) formato = VOLCADO_JSON;
+    else return false;
+    return true;
+}
+
+#if PRT7_INSTRUMENTACION
+
+std::atomic<unsigned long long> contadoresMedida[NUM_CONTADORES];
+
+namespace {
+
+/**
+ * @brief Nombres estables de las etapas (se usan como llaves del JSON)
+ */
+const char* const NOMBRES_ETAPAS[NUM_ETAPAS] = {
+    "lectura", "parseo", "rotor", "insercion", "salida", "extremo_a_extremo", "desde_emisor"
+};
+
+/**
+ * @brief Nombres estables de los contadores
+ */
+const char* const NOMBRES_CONTADORES[NUM_CONTADORES] = {
+    "tramas", "bytes", "lineas_invalidas", "errores_lectura", "tramas_perdidas", "fuera_de_orden"
+};
+
+/**
+ * @brief Histograma de cada etapa
+ */
+HistogramaLatencia histogramas[NUM_ETAPAS];
+
+} // namespace
+
+HistogramaLatencia::HistogramaLatencia() : total(0), suma(0), maximo(0) {
+    for (int i = 0; i < CUBETAS_HISTOGRAMA; i++) {
+        cubetas[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+unsigned long long HistogramaLatencia::limiteSuperior(int indice) {
+    if (indice < SUBCUBETAS_HISTOGRAMA) return static_cast<unsigned long long>(indice);
+    
+    int potencia = indice / SUBCUBETAS_HISTOGRAMA + 3;
+    unsigned long long sub = static_cast<unsigned long long>(indice % SUBCUBETAS_HISTOGRAMA);
+    unsigned long long ancho = 1ULL << (potencia - 4);
+    return ((SUBCUBETAS_HISTOGRAMA + sub) << (potencia - 4)) + ancho - 1;
+}
+
+unsigned long long HistogramaLatencia::percentil(double fraccion) const {
+    unsigned long long muestras = getTotal();
+    if (muestras == 0) return 0;
+    
+    // Primera cubeta cuya cuenta acumulada alcanza el rango pedido (redondeado hacia arriba)
+    unsigned long long rango = static_cast<unsigned long long>(std::ceil(fraccion * muestras));
+    if (rango == 0) rango = 1;
+    unsigned long long acumulado = 0;
+    for (int i = 0; i < CUBETAS_HISTOGRAMA; i++) {
+        acumulado += cubetas[i].load(std::memory_order_relaxed);
+        if (acumulado >= rango) {
+            // El límite de la cubeta nunca debe pasar del máximo observado
+            unsigned long long limite = limiteSuperior(i);
+            unsigned long long mayor = getMaximo();
+            return (limite < mayor) ? limite : mayor;
+        }
+    }
+    return getMaximo();
+}
+
+double HistogramaLatencia::getPromedio() const {
+    unsigned long long muestras = getTotal();
+    return muestras ? static_cast<double>(suma.load(std::memory_order_relaxed)) / muestras : 0.0;
+}
+
+HistogramaLatencia& histogramaEtapa(EtapaMedida etapa) {
+    return histogramas[etapa];
+}
+
+void volcarInstrumentacion(std::ostream& salida, FormatoVolcado formato) {
+    if (formato == VOLCADO_JSON) {
+        salida << "{\"contadores\": {";
+        for (int c = 0; c < NUM_CONTADORES; c++) {
+            salida << (c ? ", " : "") << "\"" << NOMBRES_CONTADORES[c] << "\": "
+                   << contadoresMedida[c].load(std::memory_order_relaxed);
+        }
+        salida << "}, \"etapas\": {";
+        for (int e = 0; e < NUM_ETAPAS; e++) {
+            const HistogramaLatencia& h = histogramas[e];
+            salida << (e ? ", " : "") << "\"" << NOMBRES_ETAPAS[e] << "\": {"
+                   << "\"muestras\": " << h.getTotal()
+                   << ", \"promedio_ns\": " << h.getPromedio()
+                   << ", \"p50_ns\": " << h.percentil(0.5)
+                   << ", \"p99_ns\": " << h.percentil(0.99)
+                   << ", \"p999_ns\": " << h.percentil(0.999)
+                   << ", \"max_ns\": " << h.getMaximo() << "}";
+        }
+        salida << "}}" << std::endl;
+        return;
+    }
+    
+    salida << "=== Metricas PRT-7 ===" << std::endl;
+    for (int c = 0; c < NUM_CONTADORES; c++) {
+        salida << NOMBRES_CONTADORES[c] << ": "
+               << contadoresMedida[c].load(std::memory_order_relaxed) << std::endl;
+    }
+    // Un espacio entre columnas para que los valores anchos no se junten
+    salida << "etapa                muestras    promedio        p50        p99       p999        max (ns)"
+           << std::endl;
+    for (int e = 0; e < NUM_ETAPAS; e++) {
+        const HistogramaLatencia& h = histogramas[e];
+        salida.width(18);
+        salida << std::left << NOMBRES_ETAPAS[e] << std::right;
+        salida << ' '; salida.width(10); salida << h.getTotal();
+        salida << ' '; salida.width(11); salida << static_cast<unsigned long long>(h.getPromedio());
+        salida << ' '; salida.width(10); salida << h.percentil(0.5);
+        salida << ' '; salida.width(10); salida << h.percentil(0.99);
+        salida << ' '; salida.width(10); salida << h.percentil(0.999);
+        salida << ' '; salida.width(10); salida << h.getMaximo();
+        salida << std::endl;
+    }
+    salida << "======================" << std::endl;
+}
+
+#else
+
+void volcarInstrumentacion(std::ostream& salida, FormatoVolcado formato) {
+    if (formato == VOLCADO_JSON) {
+        salida << "{\"instrumentacion\": false}" << std::endl;
+    } else {
+        salida << "(Instrumentacion deshabilitada: compile con -DPRT7_INSTRUMENTACION=ON)" << std::endl;
+    }
+}
+
+#endif // PRT7_INSTRUMENTACION
@@ -0,0 +1,273 @@
+/**
+ * @file Instrumentacion.h
+ * @brief Histogramas de latencia y contadores por etapa del camino caliente
+ * @author Eliezer Mores Oyervides
+ * @date 2025
+ *
+ * Solo se compila con -DPRT7_INSTRUMENTACION=1 (opción de CMake del mismo
+ * nombre). Sin ella MedicionEtapa, contar() y registrarLatencia() son
+ * funciones vacías en línea y el compilador las elimina por completo.
+ */
+
+#ifndef INSTRUMENTACION_H
+#define INSTRUMENTACION_H
+
+#include <iosfwd>
+
+#ifndef PRT7_INSTRUMENTACION
+#define PRT7_INSTRUMENTACION 0
+#endif
+
+#if PRT7_INSTRUMENTACION
+#include <atomic>
+#include <chrono>
+#endif
+
+/**
+ * @brief Etapas del camino caliente con histograma propio
+ */
+enum EtapaMedida {
+    ETAPA_LECTURA,           ///< read() del puerto (SerialReader::leerDisponible)
+    ETAPA_PARSEO,            ///< parsearTrama
+    ETAPA_ROTOR,             ///< RotorDeMapeo::getMapeo / rotar
+    ETAPA_INSERCION,         ///< ListaDeCarga::insertarAlFinal
+    ETAPA_SALIDA,            ///< Formato de la salida en consola
+    ETAPA_EXTREMO_A_EXTREMO, ///< Desde que read() trajo la trama hasta que quedó decodificada
+    ETAPA_DESDE_EMISOR,      ///< Desde la marca ";t=" del emisor hasta que quedó decodificada
+    NUM_ETAPAS
+};
+
+/**
+ * @brief Contadores globales
+ */
+enum ContadorMedida {
+    CONTADOR_TRAMAS,            ///< Tramas válidas decodificadas
+    CONTADOR_BYTES,             ///< Bytes leídos de los puertos
+    CONTADOR_LINEAS_INVALIDAS,  ///< Líneas que no son tramas válidas
+    CONTADOR_ERRORES_LECTURA,   ///< Fallos de read()
+    CONTADOR_TRAMAS_PERDIDAS,   ///< Huecos en la secuencia ";s=" del emisor
+    CONTADOR_FUERA_DE_ORDEN,    ///< Tramas con secuencia ";s=" repetida o anterior a la esperada
+    NUM_CONTADORES
+};
+
+/**
+ * @brief Formato del volcado de métricas
+ */
+enum FormatoVolcado {
+    VOLCADO_TEXTO, ///< Tabla legible
+    VOLCADO_JSON   ///< Un objeto JSON en una sola línea
+};
+
+/**
+ * @brief Convierte un nombre de formato ("texto" o "json")
+ * @param nombre Nombre del formato
+ * @param formato Formato resultante
+ * @return true si el nombre es válido
+ */
+bool parsearFormatoVolcado(const char* nombre, FormatoVolcado& formato);
+
+/**
+ * @brief Escribe los contadores y los percentiles p50/p99/p999 de cada etapa
+ * @param salida Flujo de salida
+ * @param formato VOLCADO_TEXTO o VOLCADO_JSON
+ *
+ * Puede llamarse en cualquier momento (por ejemplo al recibir SIGUSR1);
+ * los valores se leen sin detener a los hilos que los actualizan.
+ */
+void volcarInstrumentacion(std::ostream& salida, FormatoVolcado formato);
+
+/**
+ * @brief Indica si la instrumentación se compiló
+ * @return true si PRT7_INSTRUMENTACION estaba activa
+ */
+inline bool instrumentacionActiva() { return PRT7_INSTRUMENTACION != 0; }
+
+#if PRT7_INSTRUMENTACION
+
+/**
+ * @brief Número de sub-cubetas por potencia de 2 (error relativo < 1/16)
+ */
+const int SUBCUBETAS_HISTOGRAMA = 16;
+
+/**
+ * @brief Total de cubetas: valores exactos hasta 15 y 16 por cada potencia hasta 2^63
+ */
+const int CUBETAS_HISTOGRAMA = (64 - 3) * SUBCUBETAS_HISTOGRAMA;
+
+/**
+ * @class HistogramaLatencia
+ * @brief Histograma log-lineal de latencias en nanosegundos, sin bloqueos
+ *
+ * Cada potencia de 2 se divide en 16 cubetas lineales, así que cualquier
+ * percentil se reporta con menos de 6.25% de error relativo. registrar()
+ * es un fetch_add relajado: varios hilos pueden registrar a la vez.
+ */
+class HistogramaLatencia {
+private:
+    std::atomic<unsigned long long> cubetas[CUBETAS_HISTOGRAMA]; ///< Conteo por cubeta
+    std::atomic<unsigned long long> total;  ///< Muestras registradas
+    std::atomic<unsigned long long> suma;   ///< Suma de las muestras (para el promedio)
+    std::atomic<unsigned long long> maximo; ///< Muestra más grande
+    
+    // Los contadores atómicos no se copian
+    HistogramaLatencia(const HistogramaLatencia&);
+    HistogramaLatencia& operator=(const HistogramaLatencia&);
+    
+public:
+    /**
+     * @brief Constructor de un histograma vacío
+     */
+    HistogramaLatencia();
+    
+    /**
+     * @brief Cubeta a la que pertenece un valor
+     * @param ns Latencia en nanosegundos
+     * @return Índice de cubeta
+     */
+    static int cubeta(unsigned long long ns) {
+        if (ns < static_cast<unsigned long long>(SUBCUBETAS_HISTOGRAMA)) return static_cast<int>(ns);
+        int potencia = 63 - __builtin_clzll(ns);
+        int sub = static_cast<int>((ns >> (potencia - 4)) & (SUBCUBETAS_HISTOGRAMA - 1));
+        return (potencia - 3) * SUBCUBETAS_HISTOGRAMA + sub;
+    }
+    
+    /**
+     * @brief Límite superior (inclusivo) de los valores de una cubeta
+     * @param indice Índice de cubeta
+     * @return Mayor latencia que cae en la cubeta
+     */
+    static unsigned long long limiteSuperior(int indice);
+    
+    /**
+     * @brief Registra una muestra
+     * @param ns Latencia en nanosegundos
+     */
+    void registrar(unsigned long long ns) {
+        cubetas[cubeta(ns)].fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(1, std::memory_order_relaxed);
+        suma.fetch_add(ns, std::memory_order_relaxed);
+        unsigned long long actual = maximo.load(std::memory_order_relaxed);
+        while (ns > actual && !maximo.compare_exchange_weak(actual, ns, std::memory_order_relaxed)) {}
+    }
+    
+    /**
+     * @brief Calcula un percentil
+     * @param fraccion Percentil como fracción (0.5, 0.99, 0.999)
+     * @return Límite superior de la cubeta donde cae el percentil, 0 si no hay muestras
+     */
+    unsigned long long percentil(double fraccion) const;
+    
+    /**
+     * @brief Obtiene el número de muestras
+     * @return Muestras registradas
+     */
+    unsigned long long getTotal() const { return total.load(std::memory_order_relaxed); }
+    
+    /**
+     * @brief Obtiene la latencia promedio
+     * @return Promedio en nanosegundos, 0 si no hay muestras
+     */
+    double getPromedio() const;
+    
+    /**
+     * @brief Obtiene la latencia máxima
+     * @return Máximo en nanosegundos
+     */
+    unsigned long long getMaximo() const { return maximo.load(std::memory_order_relaxed); }
+};
+
+/**
+ * @brief Histograma de una etapa
+ * @param etapa Etapa medida
+ * @return Histograma global de la etapa
+ */
+HistogramaLatencia& histogramaEtapa(EtapaMedida etapa);
+
+/**
+ * @brief Contadores globales, indexados por ContadorMedida
+ */
+extern std::atomic<unsigned long long> contadoresMedida[NUM_CONTADORES];
+
+/**
+ * @brief Marca de tiempo monótona
+ * @return Nanosegundos desde un origen arbitrario
+ */
+inline unsigned long long ahoraNs() {
+    return static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * @brief Suma a un contador
+ * @param contador Contador a incrementar
+ * @param cantidad Cantidad a sumar
+ */
+inline void contar(ContadorMedida contador, unsigned long long cantidad = 1) {
+    contadoresMedida[contador].fetch_add(cantidad, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Registra una latencia medida por fuera de MedicionEtapa
+ * @param etapa Etapa medida
+ * @param desdeNs Marca de ahoraNs() tomada al inicio
+ */
+inline void registrarLatencia(EtapaMedida etapa, unsigned long long desdeNs) {
+    histogramaEtapa(etapa).registrar(ahoraNs() - desdeNs);
+}
+
+/**
+ * @brief Registra el número de secuencia ";s=" de una trama
+ * @param secuencia Secuencia recibida
+ * @param esperada Secuencia que debía llegar (-1 antes de la primera); se actualiza
+ *
+ * Un salto hacia adelante cuenta las tramas que faltan como perdidas; una
+ * secuencia menor que la esperada cuenta como fuera de orden.
+ */
+inline void registrarSecuencia(long long secuencia, long long& esperada) {
+    if (esperada >= 0 && secuencia < esperada) {
+        contar(CONTADOR_FUERA_DE_ORDEN);
+        return;
+    }
+    if (esperada >= 0 && secuencia > esperada) {
+        contar(CONTADOR_TRAMAS_PERDIDAS, static_cast<unsigned long long>(secuencia - esperada));
+    }
+    esperada = secuencia + 1;
+}
+
+/**
+ * @class MedicionEtapa
+ * @brief Mide el tiempo de vida de un bloque y lo registra en el histograma de la etapa
+ */
+class MedicionEtapa {
+private:
+    EtapaMedida etapa;         ///< Etapa medida
+    unsigned long long inicio; ///< Marca de tiempo al construir
+    
+public:
+    /**
+     * @brief Empieza a medir
+     * @param medida Etapa a la que se atribuye el tiempo
+     */
+    explicit MedicionEtapa(EtapaMedida medida) : etapa(medida), inicio(ahoraNs()) {}
+    
+    /**
+     * @brief Registra el tiempo transcurrido
+     */
+    ~MedicionEtapa() { registrarLatencia(etapa, inicio); }
+};
+
+#else
+
+inline unsigned long long ahoraNs() { return 0; }
+inline void contar(ContadorMedida, unsigned long long = 1) {}
+inline void registrarLatencia(EtapaMedida, unsigned long long) {}
+inline void registrarSecuencia(long long, long long&) {}
+
+class MedicionEtapa {
+public:
+    explicit MedicionEtapa(EtapaMedida) {}
+};
+
+#endif // PRT7_INSTRUMENTACION
+
+#endif // INSTRUMENTACION_H
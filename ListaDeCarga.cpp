@@ -5,38 +5,455 @@
  */
 
 #include "ListaDeCarga.h"
-#include "Tramas.h"
+#include "RotorDeMapeo.h"
+#include <climits>
 #include <iostream>
+#include <new>
+#include <thread>
 
-ListaDeCarga::ListaDeCarga() : cabeza(nullptr), cola(nullptr), tamano(0) {}
+namespace {
 
-ListaDeCarga::~ListaDeCarga() {
-    NodoCarga* actual = cabeza;
-    while (actual != nullptr) {
-        NodoCarga* siguiente = actual->siguiente;
-        // Liberar la trama apuntada
-        delete actual->trama;
-        // Liberar el nodo
-        delete actual;
-        actual = siguiente;
+/**
+ * @brief Visitante que decodifica e imprime cada trama (procesarTramas)
+ */
+struct VisitanteProceso {
+    RotorDeMapeo* rotor;
+    char* mensaje;
+    int posicionMensaje;
+    int numeroTrama;
+    
+    void visitarLoad(char original) {
+        // Es una trama LOAD
+        char decodificado = rotor->getMapeo(original);
+        mensaje[posicionMensaje++] = decodificado;
+        
+        std::cout << "Trama #" << numeroTrama++ << " [LOAD,'" << original << "'] -> ";
+        std::cout << "Decodificado como '" << decodificado << "'" << std::endl;
+    }
+    
+    void visitarMap(int rotacion) {
+        // Es una trama MAP
+        rotor->rotar(rotacion);
+        
+        std::cout << "Trama #" << numeroTrama++ << " [MAP," << rotacion << "] -> ";
+        std::cout << "ROTANDO ROTOR " << (rotacion >= 0 ? "+" : "") << rotacion << std::endl;
+    }
+};
+
+/**
+ * @brief Visitante que agrupa tramas LOAD y las decodifica en bloque
+ */
+struct VisitanteBloque {
+    RotorDeMapeo* rotor;
+    char* salida;
+    int posicionMensaje;
+    int inicioBloque;
+    
+    void visitarLoad(char caracter) {
+        // Acumular el carácter; se decodifica junto con su bloque
+        salida[posicionMensaje++] = caracter;
     }
+    
+    void visitarMap(int rotacion) {
+        // Cerrar el bloque actual antes de cambiar el estado del rotor
+        cerrarBloque();
+        rotor->rotar(rotacion);
+    }
+    
+    void cerrarBloque() {
+        rotor->mapearBloque(salida + inicioBloque, salida + inicioBloque,
+                            posicionMensaje - inicioBloque);
+        inicioBloque = posicionMensaje;
+    }
+};
+
+/**
+ * @brief Visitante que lista el contenido (imprimirMensajeFinal)
+ */
+struct VisitanteImpresion {
+    long contador;
+    
+    void visitarLoad(char caracter) {
+        std::cout << "  " << contador++ << ". [LOAD: '" << caracter << "']" << std::endl;
+    }
+    
+    void visitarMap(int rotacion) {
+        std::cout << "  " << contador++ << ". [MAP: " << rotacion << "]" << std::endl;
+    }
+};
+
+/**
+ * @brief Tramo de nodos consecutivos que procesa un hilo en decodificarParalelo()
+ */
+struct TramoParalelo {
+    NodoCarga* primero;     ///< Primer nodo del tramo
+    int numeroNodos;        ///< Nodos del tramo
+    int rotacion;           ///< Rotación total del tramo (0..25)
+    int tramasLoad;         ///< Tramas LOAD del tramo
+    int desplazamiento;     ///< Desplazamiento del rotor al inicio del tramo
+    int posicionSalida;     ///< Posición en la salida del primer LOAD del tramo
+};
+
+/**
+ * @brief Fase 1: rotación total y número de LOAD de un tramo
+ */
+void resumirTramo(TramoParalelo* tramo) {
+    int rotacion = 0;
+    int tramasLoad = 0;
+    NodoCarga* nodo = tramo->primero;
+    for (int n = 0; n < tramo->numeroNodos; n++, nodo = nodo->siguiente) {
+        for (int i = 0; i < nodo->usadas; i++) {
+            const TramaCompacta& trama = nodo->tramas[i];
+            if (trama.esLoad()) {
+                tramasLoad++;
+            } else {
+                rotacion = (rotacion + trama.rotacion % TAMANO_ALFABETO + TAMANO_ALFABETO)
+                           % TAMANO_ALFABETO;
+            }
+        }
+    }
+    tramo->rotacion = rotacion;
+    tramo->tramasLoad = tramasLoad;
 }
 
-void ListaDeCarga::insertarAlFinal(TramaBase* trama) {
-    NodoCarga* nuevo = new NodoCarga(trama);
+/**
+ * @brief Fase 2: decodifica un tramo desde su desplazamiento y posición iniciales
+ */
+void decodificarTramo(const TramoParalelo* tramo, char* salida) {
+    int desplazamiento = tramo->desplazamiento;
+    int posicion = tramo->posicionSalida;
+    int inicioBloque = posicion;
+    NodoCarga* nodo = tramo->primero;
     
-    if (cabeza == nullptr) {
+    for (int n = 0; n < tramo->numeroNodos; n++, nodo = nodo->siguiente) {
+        for (int i = 0; i < nodo->usadas; i++) {
+            const TramaCompacta& trama = nodo->tramas[i];
+            if (trama.esLoad()) {
+                salida[posicion++] = trama.caracter;
+            } else {
+                RotorDeMapeo::mapearBloque(salida + inicioBloque, salida + inicioBloque,
+                                           posicion - inicioBloque, desplazamiento);
+                inicioBloque = posicion;
+                desplazamiento = (desplazamiento + trama.rotacion % TAMANO_ALFABETO + TAMANO_ALFABETO)
+                                 % TAMANO_ALFABETO;
+            }
+        }
+    }
+    
+    RotorDeMapeo::mapearBloque(salida + inicioBloque, salida + inicioBloque,
+                               posicion - inicioBloque, desplazamiento);
+}
+
+/**
+ * @brief Suma un resumen a otro (la rotación módulo 26)
+ */
+void sumarResumen(ResumenNodo& acumulado, const ResumenNodo& otro) {
+    acumulado.tramas += otro.tramas;
+    acumulado.cargas += otro.cargas;
+    acumulado.rotacion = (acumulado.rotacion + otro.rotacion) % TAMANO_ALFABETO;
+}
+
+/**
+ * @brief Acumula una trama en un resumen
+ */
+void acumularTrama(ResumenNodo& acumulado, const TramaCompacta& trama) {
+    acumulado.tramas++;
+    if (trama.esLoad()) {
+        acumulado.cargas++;
+    } else {
+        acumulado.rotacion = (acumulado.rotacion + trama.rotacion % TAMANO_ALFABETO + TAMANO_ALFABETO)
+                             % TAMANO_ALFABETO;
+    }
+}
+
+/**
+ * @brief Resumen de todas las tramas de un nodo
+ */
+ResumenNodo resumirNodo(const NodoCarga* nodo) {
+    ResumenNodo resumen = { 0, 0, 0 };
+    for (int i = 0; i < nodo->usadas; i++) acumularTrama(resumen, nodo->tramas[i]);
+    return resumen;
+}
+
+/**
+ * @brief Cambio en el resumen de un nodo al agregar (signo 1) o quitar (signo -1) una trama
+ */
+ResumenNodo resumenTrama(const TramaCompacta& trama, int signo) {
+    ResumenNodo resumen = { signo, 0, 0 };
+    if (trama.esLoad()) {
+        resumen.cargas = signo;
+    } else {
+        resumen.rotacion = (signo * (trama.rotacion % TAMANO_ALFABETO) + TAMANO_ALFABETO) % TAMANO_ALFABETO;
+    }
+    return resumen;
+}
+
+/**
+ * @brief Parte del mensaje que cambia al quitar y/o poner una trama
+ * @param anteriores Resumen de las tramas anteriores a la editada
+ * @param cargasCompactadas LOAD que ya salieron de la ventana
+ * @param quitada Trama que se quita (nullptr si ninguna)
+ * @param puesta Trama que se pone en su lugar (nullptr si ninguna)
+ */
+CambioMensaje describirCambio(const ResumenNodo& anteriores, long cargasCompactadas,
+                              const TramaCompacta* quitada, const TramaCompacta* puesta) {
+    CambioMensaje cambio = { cargasCompactadas + anteriores.cargas, 0, 0, '\0', 0 };
+    int rotacion = 0;
+    if (quitada != nullptr) {
+        if (quitada->esLoad()) {
+            cambio.eliminados = 1;
+        } else {
+            rotacion -= quitada->rotacion % TAMANO_ALFABETO;
+        }
+    }
+    if (puesta != nullptr) {
+        if (puesta->esLoad()) {
+            // El carácter nuevo se decodifica con el estado anterior a la trama
+            cambio.insertados = 1;
+            cambio.caracter = RotorDeMapeo::obtenerTabla(anteriores.rotacion)
+                              [static_cast<unsigned char>(puesta->caracter)];
+        } else {
+            rotacion += puesta->rotacion % TAMANO_ALFABETO;
+        }
+    }
+    cambio.rotacion = (rotacion % TAMANO_ALFABETO + TAMANO_ALFABETO) % TAMANO_ALFABETO;
+    return cambio;
+}
+
+} // namespace
+
+ListaDeCarga::ListaDeCarga()
+    : cabeza(nullptr), cola(nullptr), tamano(0), nodos(nullptr), resumenes(nullptr), arbol(nullptr),
+      numeroNodos(0), capacidadNodos(0), ventana(0), limiteCompactacion(INT_MAX), libres(nullptr) {
+    compactado.tramas = 0;
+    compactado.cargas = 0;
+    compactado.rotacion = 0;
+}
+
+ListaDeCarga::~ListaDeCarga() {
+    // Los nodos guardan las tramas por valor y viven en la arena,
+    // que libera todos sus bloques en su propio destructor
+    delete[] nodos;
+    delete[] resumenes;
+    delete[] arbol;
+}
+
+NodoCarga* ListaDeCarga::enlazarNodo(int posicionAnterior) {
+    if (numeroNodos == capacidadNodos) {
+        int nuevaCapacidad = (capacidadNodos == 0) ? 64 : capacidadNodos * 2;
+        NodoCarga** nuevosNodos = new NodoCarga*[nuevaCapacidad];
+        ResumenNodo* nuevosResumenes = new ResumenNodo[nuevaCapacidad];
+        ResumenNodo* nuevoArbol = new ResumenNodo[nuevaCapacidad + 1];
+        for (int i = 0; i < numeroNodos; i++) {
+            nuevosNodos[i] = nodos[i];
+            nuevosResumenes[i] = resumenes[i];
+            nuevoArbol[i + 1] = arbol[i + 1];
+        }
+        delete[] nodos;
+        delete[] resumenes;
+        delete[] arbol;
+        nodos = nuevosNodos;
+        resumenes = nuevosResumenes;
+        arbol = nuevoArbol;
+        capacidadNodos = nuevaCapacidad;
+    }
+    
+    // Los nodos desenlazados o compactados se reutilizan antes de crecer la arena
+    void* memoria;
+    if (libres != nullptr) {
+        memoria = libres;
+        libres = libres->siguiente;
+    } else {
+        memoria = arena.reservar(sizeof(NodoCarga), alignof(NodoCarga));
+    }
+    NodoCarga* nuevo = new (memoria) NodoCarga();
+    ResumenNodo vacio = { 0, 0, 0 };
+    
+    if (posicionAnterior < 0) {
         // Lista vacía
         cabeza = nuevo;
         cola = nuevo;
+        nodos[0] = nuevo;
+        resumenes[0] = vacio;
+        numeroNodos = 1;
+        return nuevo;
+    }
+    
+    NodoCarga* anterior = nodos[posicionAnterior];
+    nuevo->previo = anterior;
+    nuevo->siguiente = anterior->siguiente;
+    if (anterior->siguiente != nullptr) {
+        anterior->siguiente->previo = nuevo;
     } else {
-        // Insertar al final
-        cola->siguiente = nuevo;
-        nuevo->previo = cola;
         cola = nuevo;
     }
+    anterior->siguiente = nuevo;
+    
+    if (nuevo == cola) {
+        // La cola anterior deja de cambiar: resumirla y agregarla al árbol.
+        // El nodo k del árbol cubre los (k & -k) resúmenes que terminan en k.
+        resumenes[posicionAnterior] = resumirNodo(anterior);
+        int k = posicionAnterior + 1;
+        ResumenNodo suma = resumenes[posicionAnterior];
+        for (int paso = 1; paso < (k & -k); paso <<= 1) sumarResumen(suma, arbol[k - paso]);
+        arbol[k] = suma;
+    } else {
+        for (int i = numeroNodos; i > posicionAnterior + 1; i--) {
+            nodos[i] = nodos[i - 1];
+            resumenes[i] = resumenes[i - 1];
+        }
+    }
+    nodos[posicionAnterior + 1] = nuevo;
+    resumenes[posicionAnterior + 1] = vacio;
+    numeroNodos++;
+    return nuevo;
+}
+
+void ListaDeCarga::dividirNodo(int posicion) {
+    NodoCarga* nodo = nodos[posicion];
+    NodoCarga* nuevo = enlazarNodo(posicion);
+    
+    const int mitad = TRAMAS_POR_NODO / 2;
+    for (int i = mitad; i < nodo->usadas; i++) nuevo->tramas[i - mitad] = nodo->tramas[i];
+    nuevo->usadas = nodo->usadas - mitad;
+    nodo->usadas = mitad;
+    
+    resumenes[posicion] = resumirNodo(nodo);
+    resumenes[posicion + 1] = resumirNodo(nuevo);
+    reconstruirArbol();
+}
+
+void ListaDeCarga::desenlazarNodo(int posicion) {
+    NodoCarga* nodo = nodos[posicion];
+    if (nodo->previo != nullptr) {
+        nodo->previo->siguiente = nodo->siguiente;
+    } else {
+        cabeza = nodo->siguiente;
+    }
+    if (nodo->siguiente != nullptr) {
+        nodo->siguiente->previo = nodo->previo;
+    } else {
+        cola = nodo->previo;
+    }
     
+    for (int i = posicion; i < numeroNodos - 1; i++) {
+        nodos[i] = nodos[i + 1];
+        resumenes[i] = resumenes[i + 1];
+    }
+    numeroNodos--;
+    reconstruirArbol();
+    
+    nodo->siguiente = libres;
+    libres = nodo;
+}
+
+void ListaDeCarga::compactar() {
+    // Quitar nodos enteros de la cabeza mientras quede al menos la ventana
+    char decodificado[TRAMAS_POR_NODO];
+    int quitados = 0;
+    while (cabeza != cola && tamano - cabeza->usadas >= ventana) {
+        NodoCarga* nodo = cabeza;
+        const char* tabla = RotorDeMapeo::obtenerTabla(compactado.rotacion);
+        int caracteres = 0;
+        for (int i = 0; i < nodo->usadas; i++) {
+            const TramaCompacta& trama = nodo->tramas[i];
+            if (trama.esLoad()) {
+                decodificado[caracteres++] = tabla[static_cast<unsigned char>(trama.caracter)];
+            } else {
+                compactado.rotacion = (compactado.rotacion + trama.rotacion % TAMANO_ALFABETO + TAMANO_ALFABETO)
+                                      % TAMANO_ALFABETO;
+                tabla = RotorDeMapeo::obtenerTabla(compactado.rotacion);
+            }
+        }
+        texto.agregar(decodificado, static_cast<size_t>(caracteres));
+        compactado.tramas += nodo->usadas;
+        compactado.cargas += caracteres;
+        tamano -= nodo->usadas;
+        
+        cabeza = nodo->siguiente;
+        cabeza->previo = nullptr;
+        nodo->siguiente = libres;
+        libres = nodo;
+        quitados++;
+    }
+    if (quitados == 0) return;
+    
+    for (int i = quitados; i < numeroNodos; i++) {
+        nodos[i - quitados] = nodos[i];
+        resumenes[i - quitados] = resumenes[i];
+    }
+    numeroNodos -= quitados;
+    reconstruirArbol();
+}
+
+bool ListaDeCarga::setVentana(int tramas, const char* rutaDerrame) {
+    if (rutaDerrame != nullptr && !texto.derramarEn(rutaDerrame)) return false;
+    
+    if (tramas <= 0) {
+        ventana = 0;
+        limiteCompactacion = INT_MAX;
+        return true;
+    }
+    ventana = tramas;
+    limiteCompactacion = tramas + tramas / 4 + TRAMAS_POR_NODO;
+    if (tamano > limiteCompactacion) compactar();
+    return true;
+}
+
+void ListaDeCarga::reconstruirArbol() {
+    // La cola no entra en el árbol: cambia con cada insertarAlFinal()
+    int indexados = numeroNodos - 1;
+    for (int k = 1; k <= indexados; k++) arbol[k] = resumenes[k - 1];
+    for (int k = 1; k <= indexados; k++) {
+        int padre = k + (k & -k);
+        if (padre <= indexados) sumarResumen(arbol[padre], arbol[k]);
+    }
+}
+
+void ListaDeCarga::actualizarResumen(int posicion, const ResumenNodo& cambio) {
+    int indexados = numeroNodos - 1;
+    if (posicion >= indexados) return;
+    
+    sumarResumen(resumenes[posicion], cambio);
+    for (int k = posicion + 1; k <= indexados; k += k & -k) sumarResumen(arbol[k], cambio);
+}
+
+int ListaDeCarga::ubicar(int indice, ResumenNodo& anteriores) const {
+    ResumenNodo vacio = { 0, 0, 0 };
+    anteriores = vacio;
+    int indexados = numeroNodos - 1;
+    
+    // Mayor posición cuyo prefijo de tramas no pasa de indice; no hay nodos vacíos
+    int paso = 1;
+    while (paso * 2 <= indexados) paso *= 2;
+    int posicion = 0;
+    for (; paso > 0; paso >>= 1) {
+        if (posicion + paso <= indexados && anteriores.tramas + arbol[posicion + paso].tramas <= indice) {
+            posicion += paso;
+            sumarResumen(anteriores, arbol[posicion]);
+        }
+    }
+    return posicion;
+}
+
+void ListaDeCarga::ubicarTrama(int indice, int& posicionNodo, int& enNodo, ResumenNodo& anteriores) const {
+    // El final de la lista está al final de la cola
+    posicionNodo = ubicar(indice < tamano ? indice : tamano - 1, anteriores);
+    const NodoCarga* nodo = nodos[posicionNodo];
+    enNodo = indice - anteriores.tramas;
+    for (int i = 0; i < enNodo; i++) acumularTrama(anteriores, nodo->tramas[i]);
+    
+    // Las tramas compactadas siguen contando para el estado del rotor
+    anteriores.rotacion = (anteriores.rotacion + compactado.rotacion) % TAMANO_ALFABETO;
+}
+
+void ListaDeCarga::insertarAlFinal(const TramaCompacta& trama) {
+    // El último nodo está lleno (o no hay): enlazar uno nuevo
+    if (cola == nullptr || cola->usadas == TRAMAS_POR_NODO) enlazarNodo(numeroNodos - 1);
+    
+    cola->tramas[cola->usadas++] = trama;
     tamano++;
+    if (tamano > limiteCompactacion) compactar();
 }
 
 void ListaDeCarga::procesarTramas(RotorDeMapeo* rotor) {
@@ -50,44 +467,15 @@ void ListaDeCarga::procesarTramas(RotorDeMapeo* rotor) {
     
     // Buffer temporal para almacenar caracteres decodificados
     char* mensajeTemp = new char[tamano + 1];
-    int posicionMensaje = 0;
     
     std::cout << "Procesando " << tamano << " tramas almacenadas..." << std::endl;
     std::cout << "========================================" << std::endl;
     
-    NodoCarga* actual = cabeza;
-    int numeroTrama = 1;
-    
-    while (actual != nullptr) {
-        TramaBase* trama = actual->trama;
-        
-        // Determinar el tipo de trama (usando dynamic_cast)
-        TramaLoad* tramaLoad = dynamic_cast<TramaLoad*>(trama);
-        TramaMap* tramaMap = dynamic_cast<TramaMap*>(trama);
-        
-        if (tramaLoad != nullptr) {
-            // Es una trama LOAD
-            char original = tramaLoad->getCaracter();
-            char decodificado = rotor->getMapeo(original);
-            mensajeTemp[posicionMensaje++] = decodificado;
-            
-            std::cout << "Trama #" << numeroTrama << " [LOAD,'" << original << "'] -> ";
-            std::cout << "Decodificado como '" << decodificado << "'" << std::endl;
-            
-        } else if (tramaMap != nullptr) {
-            // Es una trama MAP
-            int rotacion = tramaMap->getRotacion();
-            rotor->rotar(rotacion);
-            
-            std::cout << "Trama #" << numeroTrama << " [MAP," << rotacion << "] -> ";
-            std::cout << "ROTANDO ROTOR " << (rotacion >= 0 ? "+" : "") << rotacion << std::endl;
-        }
-        
-        actual = actual->siguiente;
-        numeroTrama++;
-    }
+    rotor->rotar(compactado.rotacion);
+    VisitanteProceso visitante = { rotor, mensajeTemp, 0, 1 };
+    recorrer(visitante);
     
-    mensajeTemp[posicionMensaje] = '\0';
+    mensajeTemp[visitante.posicionMensaje] = '\0';
     
     std::cout << "========================================" << std::endl;
     std::cout << "MENSAJE OCULTO DECODIFICADO:" << std::endl;
@@ -97,34 +485,203 @@ void ListaDeCarga::procesarTramas(RotorDeMapeo* rotor) {
     delete[] mensajeTemp;
 }
 
+int ListaDeCarga::decodificarMensaje(RotorDeMapeo* rotor, char* salida) {
+    rotor->rotar(compactado.rotacion);
+    VisitanteBloque visitante = { rotor, salida, 0, 0 };
+    recorrer(visitante);
+    visitante.cerrarBloque();
+    
+    salida[visitante.posicionMensaje] = '\0';
+    return visitante.posicionMensaje;
+}
+
+int ListaDeCarga::decodificarParalelo(RotorDeMapeo* rotor, char* salida, int hilos) {
+    if (hilos > numeroNodos) hilos = numeroNodos;
+    if (hilos <= 1) return decodificarMensaje(rotor, salida);
+    
+    // Repartir los nodos en tramos parecidos; el índice da el primero de cada tramo
+    TramoParalelo* tramos = new TramoParalelo[hilos];
+    int primero = 0;
+    for (int t = 0; t < hilos; t++) {
+        tramos[t].primero = nodos[primero];
+        tramos[t].numeroNodos = numeroNodos / hilos + (t < numeroNodos % hilos ? 1 : 0);
+        primero += tramos[t].numeroNodos;
+    }
+    
+    // Fase 1: totales por tramo (el último tramo lo calcula este hilo)
+    std::thread* trabajadores = new std::thread[hilos - 1];
+    for (int t = 0; t < hilos - 1; t++) {
+        trabajadores[t] = std::thread(resumirTramo, &tramos[t]);
+    }
+    resumirTramo(&tramos[hilos - 1]);
+    for (int t = 0; t < hilos - 1; t++) trabajadores[t].join();
+    
+    // Prefijo exclusivo: desplazamiento y posición inicial de cada tramo
+    int desplazamiento = (rotor->getDesplazamiento() + compactado.rotacion) % TAMANO_ALFABETO;
+    int posicion = 0;
+    for (int t = 0; t < hilos; t++) {
+        tramos[t].desplazamiento = desplazamiento;
+        tramos[t].posicionSalida = posicion;
+        desplazamiento = (desplazamiento + tramos[t].rotacion) % TAMANO_ALFABETO;
+        posicion += tramos[t].tramasLoad;
+    }
+    
+    // Fase 2: decodificar todos los tramos a la vez
+    for (int t = 0; t < hilos - 1; t++) {
+        trabajadores[t] = std::thread(decodificarTramo, &tramos[t], salida);
+    }
+    decodificarTramo(&tramos[hilos - 1], salida);
+    for (int t = 0; t < hilos - 1; t++) trabajadores[t].join();
+    
+    // Dejar el rotor en el estado final, como el recorrido secuencial
+    rotor->rotar(desplazamiento - rotor->getDesplazamiento());
+    salida[posicion] = '\0';
+    
+    delete[] trabajadores;
+    delete[] tramos;
+    return posicion;
+}
+
+IteradorCarga ListaDeCarga::buscar(int indice, int& desplazamiento, int& cargas) const {
+    if (indice < 0 || indice >= tamano) return IteradorCarga();
+    
+    int posicionNodo = 0;
+    int enNodo = 0;
+    ResumenNodo anteriores;
+    ubicarTrama(indice, posicionNodo, enNodo, anteriores);
+    
+    desplazamiento = anteriores.rotacion;
+    cargas = anteriores.cargas;
+    return IteradorCarga(nodos[posicionNodo], enNodo);
+}
+
+int ListaDeCarga::decodificarRango(int inicio, int fin, char* salida) const {
+    if (inicio < 0) inicio = 0;
+    if (fin > tamano) fin = tamano;
+    
+    int desplazamiento = 0;
+    int cargas = 0;
+    IteradorCarga it = buscar(inicio, desplazamiento, cargas);
+    
+    // Igual que decodificarTramo(): bloques de LOAD entre dos MAP
+    int posicion = 0;
+    int inicioBloque = 0;
+    for (int i = inicio; i < fin && it.valido(); i++, ++it) {
+        const TramaCompacta& trama = *it;
+        if (trama.esLoad()) {
+            salida[posicion++] = trama.caracter;
+        } else {
+            RotorDeMapeo::mapearBloque(salida + inicioBloque, salida + inicioBloque,
+                                       posicion - inicioBloque, desplazamiento);
+            inicioBloque = posicion;
+            desplazamiento = (desplazamiento + trama.rotacion % TAMANO_ALFABETO + TAMANO_ALFABETO)
+                             % TAMANO_ALFABETO;
+        }
+    }
+    RotorDeMapeo::mapearBloque(salida + inicioBloque, salida + inicioBloque,
+                               posicion - inicioBloque, desplazamiento);
+    
+    salida[posicion] = '\0';
+    return posicion;
+}
+
+bool ListaDeCarga::insertarEn(int indice, const TramaCompacta& trama, CambioMensaje* cambio) {
+    if (indice < 0 || indice > tamano) return false;
+    
+    ResumenNodo anteriores = { 0, 0, compactado.rotacion };
+    int posicionNodo = 0;
+    int enNodo = 0;
+    if (tamano > 0) ubicarTrama(indice, posicionNodo, enNodo, anteriores);
+    if (cambio != nullptr) *cambio = describirCambio(anteriores, compactado.cargas, nullptr, &trama);
+    
+    if (indice == tamano) {
+        insertarAlFinal(trama);
+        return true;
+    }
+    
+    if (nodos[posicionNodo]->usadas == TRAMAS_POR_NODO) {
+        dividirNodo(posicionNodo);
+        if (enNodo > TRAMAS_POR_NODO / 2) {
+            posicionNodo++;
+            enNodo -= TRAMAS_POR_NODO / 2;
+        }
+    }
+    
+    NodoCarga* nodo = nodos[posicionNodo];
+    for (int i = nodo->usadas; i > enNodo; i--) nodo->tramas[i] = nodo->tramas[i - 1];
+    nodo->tramas[enNodo] = trama;
+    nodo->usadas++;
+    tamano++;
+    actualizarResumen(posicionNodo, resumenTrama(trama, 1));
+    if (tamano > limiteCompactacion) compactar();
+    return true;
+}
+
+bool ListaDeCarga::eliminarEn(int indice, CambioMensaje* cambio) {
+    if (indice < 0 || indice >= tamano) return false;
+    
+    int posicionNodo = 0;
+    int enNodo = 0;
+    ResumenNodo anteriores;
+    ubicarTrama(indice, posicionNodo, enNodo, anteriores);
+    
+    NodoCarga* nodo = nodos[posicionNodo];
+    TramaCompacta quitada = nodo->tramas[enNodo];
+    if (cambio != nullptr) *cambio = describirCambio(anteriores, compactado.cargas, &quitada, nullptr);
+    
+    for (int i = enNodo; i < nodo->usadas - 1; i++) nodo->tramas[i] = nodo->tramas[i + 1];
+    nodo->usadas--;
+    tamano--;
+    
+    if (nodo->usadas == 0) {
+        desenlazarNodo(posicionNodo);
+    } else {
+        actualizarResumen(posicionNodo, resumenTrama(quitada, -1));
+    }
+    return true;
+}
+
+bool ListaDeCarga::reemplazarEn(int indice, const TramaCompacta& trama, CambioMensaje* cambio) {
+    if (indice < 0 || indice >= tamano) return false;
+    
+    int posicionNodo = 0;
+    int enNodo = 0;
+    ResumenNodo anteriores;
+    ubicarTrama(indice, posicionNodo, enNodo, anteriores);
+    
+    NodoCarga* nodo = nodos[posicionNodo];
+    TramaCompacta quitada = nodo->tramas[enNodo];
+    if (cambio != nullptr) *cambio = describirCambio(anteriores, compactado.cargas, &quitada, &trama);
+    nodo->tramas[enNodo] = trama;
+    
+    ResumenNodo diferencia = resumenTrama(trama, 1);
+    sumarResumen(diferencia, resumenTrama(quitada, -1));
+    actualizarResumen(posicionNodo, diferencia);
+    return true;
+}
+
 void ListaDeCarga::imprimirMensajeFinal() {
-    if (cabeza == nullptr) {
+    if (cabeza == nullptr && compactado.tramas == 0) {
         std::cout << "[Sin mensaje]" << std::endl;
         return;
     }
     
     std::cout << "Contenido de la lista de tramas:" << std::endl;
+    if (compactado.tramas > 0) {
+        std::cout << "  1-" << compactado.tramas << ". [" << compactado.tramas << " tramas compactadas: "
+                  << compactado.cargas << " caracteres, rotor en " << compactado.rotacion << "]" << std::endl;
+    }
     
-    NodoCarga* actual = cabeza;
-    int contador = 1;
+    VisitanteImpresion visitante = { compactado.tramas + 1 };
+    recorrer(visitante);
+}
+
+bool ListaDeCarga::escribirMensaje(std::ostream& salida) const {
+    bool correcto = texto.escribir(salida);
     
-    while (actual != nullptr) {
-        TramaLoad* tramaLoad = dynamic_cast<TramaLoad*>(actual->trama);
-        TramaMap* tramaMap = dynamic_cast<TramaMap*>(actual->trama);
-        
-        std::cout << "  " << contador << ". ";
-        
-        if (tramaLoad != nullptr) {
-            std::cout << "[LOAD: '" << tramaLoad->getCaracter() << "']";
-        } else if (tramaMap != nullptr) {
-            std::cout << "[MAP: " << tramaMap->getRotacion() << "]";
-        } else {
-            std::cout << "[Trama desconocida]";
-        }
-        
-        std::cout << std::endl;
-        
-        actual = actual->siguiente;
-        contador++;
-    }
-}
\ No newline at end of file
+    char* decodificado = new char[tamano + 1];
+    int caracteres = decodificarRango(0, tamano, decodificado);
+    salida.write(decodificado, caracteres);
+    delete[] decodificado;
+    return correcto;
+}
@@ -9,21 +9,144 @@
 #define LISTA_DE_CARGA_H
 
 #include "TramaBase.h"
+#include "TramaCompacta.h"
+#include "ArenaDeCarga.h"
+#include "MensajeDecodificado.h"
+#include "TextoCompactado.h"
+#include <ostream>
+
+/**
+ * @brief Número de tramas que guarda cada nodo de la lista
+ */
+const int TRAMAS_POR_NODO = 64;
 
 /**
  * @struct NodoCarga
- * @brief Nodo de la lista doblemente enlazada que almacena punteros a TramaBase
+ * @brief Nodo de la lista doblemente enlazada que almacena un bloque de tramas
+ * 
+ * La lista está "desenrollada": cada nodo guarda hasta TRAMAS_POR_NODO
+ * tramas contiguas, así que recorrerla salta de nodo una vez cada 64
+ * tramas en lugar de seguir un puntero por trama
  */
 struct NodoCarga {
-    TramaBase* trama;     ///< Puntero polimórfico a la trama (LOAD o MAP)
+    TramaCompacta tramas[TRAMAS_POR_NODO]; ///< Tramas (LOAD o MAP) en orden de llegada
+    int usadas;           ///< Número de posiciones ocupadas de tramas
     NodoCarga* siguiente; ///< Puntero al siguiente nodo
     NodoCarga* previo;    ///< Puntero al nodo anterior
     
     /**
-     * @brief Constructor del nodo
-     * @param t Puntero a la trama a almacenar
+     * @brief Constructor de un nodo vacío
      */
-    NodoCarga(TramaBase* t) : trama(t), siguiente(nullptr), previo(nullptr) {}
+    NodoCarga() : usadas(0), siguiente(nullptr), previo(nullptr) {}
+};
+
+/**
+ * @struct ResumenNodo
+ * @brief Totales de las tramas de un nodo (o de varios), base del índice de la lista
+ * 
+ * Los totales se suman componente a componente (la rotación módulo 26),
+ * así que el resumen de un prefijo de nodos es la suma de sus resúmenes.
+ */
+struct ResumenNodo {
+    int tramas;   ///< Tramas
+    int cargas;   ///< Tramas LOAD: posiciones que ocupan en el mensaje decodificado
+    int rotacion; ///< Suma de las rotaciones de las tramas MAP, módulo 26 (0..25)
+};
+
+/**
+ * @struct EstadoCompactado
+ * @brief Lo que queda de las tramas que salieron de la ventana de ListaDeCarga
+ * 
+ * Las tramas compactadas ya no están en la lista; de ellas solo se guarda
+ * cuántas eran, cuántas eran LOAD (sus caracteres están en el texto
+ * compactado) y el desplazamiento del rotor después de la última.
+ */
+struct EstadoCompactado {
+    long tramas;  ///< Tramas compactadas
+    long cargas;  ///< Tramas LOAD compactadas: caracteres del texto compactado
+    int rotacion; ///< Desplazamiento del rotor tras la última trama compactada (0..25)
+};
+
+/**
+ * @class IteradorCarga
+ * @brief Posición de una trama dentro de ListaDeCarga, recorrible en ambos sentidos
+ * 
+ * Ejemplo:
+ * @code
+ * for (IteradorCarga it = lista.primero(); it.valido(); ++it) { ... }
+ * for (IteradorCarga it = lista.ultimo(); it.valido(); --it) { ... }
+ * @endcode
+ */
+class IteradorCarga {
+private:
+    NodoCarga* nodo; ///< Nodo actual (nullptr al salir de la lista)
+    int indice;      ///< Posición dentro del nodo
+    
+public:
+    /**
+     * @brief Constructor
+     * @param n Nodo de la trama
+     * @param i Posición dentro del nodo
+     */
+    IteradorCarga(NodoCarga* n = nullptr, int i = 0) : nodo(n), indice(i) {}
+    
+    /**
+     * @brief Indica si el iterador apunta a una trama
+     * @return false cuando se recorrió más allá de un extremo de la lista
+     */
+    bool valido() const { return nodo != nullptr; }
+    
+    /**
+     * @brief Obtiene la trama actual
+     * @return Referencia a la trama
+     */
+    const TramaCompacta& operator*() const { return nodo->tramas[indice]; }
+    
+    /**
+     * @brief Acceso a los miembros de la trama actual
+     * @return Puntero a la trama
+     */
+    const TramaCompacta* operator->() const { return &nodo->tramas[indice]; }
+    
+    /**
+     * @brief Avanza a la siguiente trama
+     * @return El propio iterador
+     */
+    IteradorCarga& operator++() {
+        if (++indice >= nodo->usadas) {
+            nodo = nodo->siguiente;
+            indice = 0;
+        }
+        return *this;
+    }
+    
+    /**
+     * @brief Retrocede a la trama anterior
+     * @return El propio iterador
+     */
+    IteradorCarga& operator--() {
+        if (--indice < 0) {
+            nodo = nodo->previo;
+            indice = (nodo != nullptr) ? nodo->usadas - 1 : 0;
+        }
+        return *this;
+    }
+    
+    /**
+     * @brief Compara dos posiciones
+     * @param otro Iterador a comparar
+     * @return true si apuntan a la misma trama
+     */
+    bool operator==(const IteradorCarga& otro) const {
+        return nodo == otro.nodo && indice == otro.indice;
+    }
+    
+    /**
+     * @brief Compara dos posiciones
+     * @param otro Iterador a comparar
+     * @return true si apuntan a tramas distintas
+     */
+    bool operator!=(const IteradorCarga& otro) const { return !(*this == otro); }
 };
 
 /**
@@ -31,13 +154,108 @@ struct NodoCarga {
  * @brief Lista doblemente enlazada que almacena las tramas recibidas en orden
  * 
  * Esta lista mantiene todas las tramas (LOAD y MAP) en el orden en que fueron
- * recibidas del puerto serial, permitiendo procesarlas secuencialmente
+ * recibidas del puerto serial, permitiendo procesarlas secuencialmente.
+ * 
+ * Cada trama se guarda como TramaCompacta dentro de un nodo de hasta
+ * TRAMAS_POR_NODO tramas, y los nodos se construyen en una ArenaDeCarga
+ * propia de la lista, de modo que no hay un new por trama, el recorrido
+ * es casi secuencial en memoria y toda la memoria se libera de una vez.
+ * 
+ * Un árbol de Fenwick sobre el resumen de cada nodo (tramas, LOAD y
+ * rotación acumulada) permite ubicar una trama y el estado del rotor
+ * antes de ella en O(log n), también después de insertar, eliminar o
+ * corregir tramas en medio de la lista.
+ * 
+ * Con setVentana() la lista funciona como flujo: solo retiene las
+ * tramas más recientes y compacta las demás en un EstadoCompactado y en
+ * su texto decodificado (en memoria o derramado a disco). Los índices de
+ * todas las operaciones son entonces relativos a la ventana retenida, y
+ * los desplazamientos del rotor siguen siendo los de la sesión completa.
  */
 class ListaDeCarga {
 private:
     NodoCarga* cabeza;  ///< Primer nodo de la lista
     NodoCarga* cola;    ///< Último nodo de la lista
-    int tamano;         ///< Número de elementos
+    int tamano;         ///< Número de tramas
+    ArenaDeCarga arena; ///< Memoria de los nodos
+    NodoCarga** nodos;      ///< Nodos en orden, para ubicarlos por posición
+    ResumenNodo* resumenes; ///< Resumen de cada nodo (el de la cola no se mantiene)
+    ResumenNodo* arbol;     ///< Árbol de Fenwick (base 1) sobre los resúmenes, sin la cola
+    int numeroNodos;        ///< Nodos enlazados
+    int capacidadNodos;     ///< Capacidad de nodos, resumenes y arbol
+    int ventana;            ///< Tramas que se retienen como mínimo (0: todas)
+    int limiteCompactacion; ///< Con más tramas que esto se compacta la cabeza
+    EstadoCompactado compactado; ///< Tramas que ya salieron de la ventana
+    TextoCompactado texto;  ///< Texto decodificado de las tramas compactadas
+    NodoCarga* libres;      ///< Nodos desenlazados, reutilizables antes de pedir a la arena
+    
+    /**
+     * @brief Enlaza un nodo vacío después de otro y lo registra en el índice
+     * @param posicionAnterior Posición del nodo tras el que se enlaza (-1: lista vacía)
+     * @return Nodo recién enlazado
+     * 
+     * Si el nodo nuevo es la cola, la cola anterior se resume y se agrega al
+     * árbol en O(log n), así que insertarAlFinal() no acumula nada por trama.
+     * Si queda en medio de la lista, el llamador debe reconstruir el árbol.
+     */
+    NodoCarga* enlazarNodo(int posicionAnterior);
+    
+    /**
+     * @brief Parte un nodo lleno en dos mitades y reconstruye el índice
+     * @param posicion Posición del nodo en el índice
+     */
+    void dividirNodo(int posicion);
+    
+    /**
+     * @brief Desenlaza un nodo que quedó vacío y reconstruye el índice
+     * @param posicion Posición del nodo en el índice
+     */
+    void desenlazarNodo(int posicion);
+    
+    /**
+     * @brief Rehace el árbol de Fenwick a partir de resumenes en O(número de nodos)
+     */
+    void reconstruirArbol();
+    
+    /**
+     * @brief Suma un cambio al resumen de un nodo y a su rama del árbol
+     * @param posicion Posición del nodo (si es la cola no hay nada que actualizar)
+     * @param cambio Diferencia de tramas, cargas y rotación (0..25)
+     */
+    void actualizarResumen(int posicion, const ResumenNodo& cambio);
+    
+    /**
+     * @brief Ubica el nodo que contiene una trama
+     * @param indice Índice de la trama (0 .. getTamano() - 1)
+     * @param anteriores Recibe el resumen de todas las tramas anteriores al nodo
+     * @return Posición del nodo en el índice
+     * 
+     * Desciende por el árbol de Fenwick con los totales de tramas: O(log n).
+     */
+    int ubicar(int indice, ResumenNodo& anteriores) const;
+    
+    /**
+     * @brief Ubica una trama y el estado del rotor justo antes de ella
+     * @param indice Índice de la trama (0 .. getTamano(); getTamano() es el final)
+     * @param posicionNodo Recibe la posición del nodo en el índice
+     * @param enNodo Recibe la posición de la trama dentro del nodo
+     * @param anteriores Recibe el resumen de todas las tramas anteriores
+     */
+    void ubicarTrama(int indice, int& posicionNodo, int& enNodo, ResumenNodo& anteriores) const;
+    
+    /**
+     * @brief Compacta los nodos de la cabeza que ya no hacen falta para retener la ventana
+     * 
+     * Decodifica los LOAD de cada nodo quitado al texto compactado y deja
+     * el nodo en la lista de libres. El índice se desplaza y reconstruye
+     * una sola vez por llamada; como solo se compacta al pasar de
+     * limiteCompactacion, eso ocurre una vez cada ventana / 4 tramas.
+     */
+    void compactar();
+    
+    // La lista es dueña de sus nodos: no se copia
+    ListaDeCarga(const ListaDeCarga&);
+    ListaDeCarga& operator=(const ListaDeCarga&);
     
 public:
     /**
@@ -48,34 +266,215 @@ public:
     /**
      * @brief Destructor que libera toda la memoria
      * 
-     * IMPORTANTE: También libera las tramas apuntadas (delete trama)
+     * Los nodos viven en la arena, que se libera completa al destruirse;
+     * el índice de nodos se libera aparte
      */
     ~ListaDeCarga();
     
     /**
      * @brief Inserta una trama al final de la lista
-     * @param trama Puntero a la trama a insertar
+     * @param trama Trama compacta a insertar (se copia en el último nodo)
+     */
+    void insertarAlFinal(const TramaCompacta& trama);
+    
+    /**
+     * @brief Inserta una trama LOAD al final
+     * @param caracter Carácter de la trama
+     */
+    void insertarLoad(char caracter) { insertarAlFinal(TramaCompacta::load(caracter)); }
+    
+    /**
+     * @brief Inserta una trama MAP al final
+     * @param rotacion Número de posiciones a rotar
+     */
+    void insertarMap(int rotacion) { insertarAlFinal(TramaCompacta::map(rotacion)); }
+    
+    /**
+     * @brief Recorre las tramas en orden despachándolas a un visitante
+     * @param visitante Objeto con visitarLoad(char) y visitarMap(int)
      */
-    void insertarAlFinal(TramaBase* trama);
+    template <typename Visitante>
+    void recorrer(Visitante& visitante) const {
+        for (NodoCarga* actual = cabeza; actual != nullptr; actual = actual->siguiente) {
+            for (int i = 0; i < actual->usadas; i++) {
+                actual->tramas[i].aceptar(visitante);
+            }
+        }
+    }
+    
+    /**
+     * @brief Obtiene un iterador a la primera trama
+     * @return Iterador (no válido si la lista está vacía)
+     */
+    IteradorCarga primero() const { return IteradorCarga(cabeza, 0); }
+    
+    /**
+     * @brief Obtiene un iterador a la última trama
+     * @return Iterador (no válido si la lista está vacía)
+     */
+    IteradorCarga ultimo() const {
+        return (cola != nullptr) ? IteradorCarga(cola, cola->usadas - 1) : IteradorCarga();
+    }
     
     /**
      * @brief Procesa todas las tramas en orden
      * @param rotor Puntero al rotor de mapeo
      * 
-     * Recorre la lista y ejecuta el método procesar() de cada trama polimórficamente
+     * Recorre la lista, rota el rotor con cada MAP y decodifica cada LOAD.
+     * Con ventana, el rotor se adelanta antes por las tramas compactadas.
      */
     void procesarTramas(RotorDeMapeo* rotor);
     
+    /**
+     * @brief Decodifica todas las tramas en bloque, sin imprimir nada
+     * @param rotor Puntero al rotor de mapeo (queda en el estado final)
+     * @param salida Buffer de al menos getTamano() + 1 caracteres
+     * @return Número de caracteres decodificados escritos en salida
+     * 
+     * Agrupa las tramas LOAD consecutivas y las decodifica con
+     * RotorDeMapeo::mapearBloque(), ya que entre dos tramas MAP
+     * todas comparten el mismo estado del rotor. Con ventana solo se
+     * decodifican las tramas retenidas, con el rotor adelantado antes por
+     * las compactadas.
+     */
+    int decodificarMensaje(RotorDeMapeo* rotor, char* salida);
+    
+    /**
+     * @brief Decodifica todas las tramas en bloque usando varios hilos
+     * @param rotor Puntero al rotor de mapeo (queda en el estado final)
+     * @param salida Buffer de al menos getTamano() + 1 caracteres
+     * @param hilos Número de hilos a usar
+     * @return Número de caracteres decodificados escritos en salida
+     * 
+     * El desplazamiento con que se decodifica cada LOAD es la suma (módulo
+     * 26) de todas las rotaciones anteriores. La lista se divide en tramos
+     * de nodos; cada hilo calcula la rotación total y el número de LOAD de
+     * su tramo, un prefijo exclusivo de esos totales da el desplazamiento
+     * inicial y la posición de salida de cada tramo, y luego todos los
+     * tramos se decodifican a la vez. El resultado es idéntico al de
+     * decodificarMensaje(), también con ventana.
+     */
+    int decodificarParalelo(RotorDeMapeo* rotor, char* salida, int hilos);
+    
+    /**
+     * @brief Busca una trama por índice usando el índice de nodos
+     * @param indice Índice de la trama (0 .. getTamano() - 1)
+     * @param desplazamiento Recibe el desplazamiento del rotor antes de esa trama
+     *                       (partiendo de un rotor recién creado)
+     * @param cargas Recibe el número de tramas LOAD anteriores
+     * @return Iterador a la trama, no válido si el índice está fuera de rango
+     * 
+     * Cuesta O(log n + TRAMAS_POR_NODO), en lugar de repetir todas las tramas
+     * desde la cabeza, aunque la lista se haya editado en medio. Con ventana,
+     * cargas solo cuenta las tramas retenidas (las compactadas suman
+     * getCompactado().cargas) y el desplazamiento incluye las compactadas.
+     */
+    IteradorCarga buscar(int indice, int& desplazamiento, int& cargas) const;
+    
+    /**
+     * @brief Decodifica solo las tramas del rango [inicio, fin)
+     * @param inicio Índice de la primera trama
+     * @param fin Índice siguiente a la última trama (se recorta a getTamano())
+     * @param salida Buffer de al menos fin - inicio + 1 caracteres
+     * @return Número de caracteres decodificados (uno por trama LOAD del rango)
+     * 
+     * El resultado es el mismo fragmento que produce decodificarMensaje()
+     * con un rotor nuevo, pero cuesta O(log n + fin - inicio) en lugar de O(fin).
+     */
+    int decodificarRango(int inicio, int fin, char* salida) const;
+    
+    /**
+     * @brief Inserta una trama antes de la trama número indice
+     * @param indice Posición de la trama nueva (0 .. getTamano(); getTamano() agrega al final)
+     * @param trama Trama a insertar (por ejemplo un MAP que llegó tarde)
+     * @param cambio Si no es nullptr, recibe la parte del mensaje decodificado que cambia
+     * @return false si el índice está fuera de rango
+     * 
+     * Desplaza como máximo TRAMAS_POR_NODO tramas dentro del nodo y actualiza
+     * el índice en O(log n). Si el nodo está lleno se divide en dos, lo que
+     * reconstruye el índice en O(número de nodos), a lo sumo una vez cada
+     * TRAMAS_POR_NODO / 2 inserciones en el mismo nodo.
+     */
+    bool insertarEn(int indice, const TramaCompacta& trama, CambioMensaje* cambio = nullptr);
+    
+    /**
+     * @brief Elimina la trama número indice
+     * @param indice Índice de la trama (0 .. getTamano() - 1)
+     * @param cambio Si no es nullptr, recibe la parte del mensaje decodificado que cambia
+     * @return false si el índice está fuera de rango
+     * 
+     * Un nodo que queda vacío se desenlaza (su memoria sigue en la arena).
+     */
+    bool eliminarEn(int indice, CambioMensaje* cambio = nullptr);
+    
+    /**
+     * @brief Sustituye la trama número indice (por ejemplo un MAP corregido)
+     * @param indice Índice de la trama (0 .. getTamano() - 1)
+     * @param trama Trama nueva
+     * @param cambio Si no es nullptr, recibe la parte del mensaje decodificado que cambia
+     * @return false si el índice está fuera de rango
+     */
+    bool reemplazarEn(int indice, const TramaCompacta& trama, CambioMensaje* cambio = nullptr);
+    
     /**
      * @brief Imprime el mensaje final decodificado
      * 
-     * Extrae y muestra solo los caracteres resultantes de las TramaLoad
+     * Extrae y muestra solo los caracteres resultantes de las TramaLoad.
+     * Con ventana, antes de las tramas retenidas se resumen las compactadas.
      */
     void imprimirMensajeFinal();
     
+    /**
+     * @brief Escribe el mensaje decodificado de toda la sesión
+     * @param salida Flujo de destino
+     * @return false si no se pudo leer el texto compactado
+     * 
+     * Es el texto compactado seguido de la decodificación de la ventana,
+     * igual a lo que daría decodificarMensaje() sin ventana.
+     */
+    bool escribirMensaje(std::ostream& salida) const;
+    
+    /**
+     * @brief Limita las tramas que retiene la lista
+     * @param tramas Tramas recientes que se retienen (0: todas, como sin ventana)
+     * @param rutaDerrame Archivo donde se guarda el texto compactado (nullptr: en memoria)
+     * @return false si no se pudo abrir el archivo de derrame
+     * 
+     * La lista retiene entre tramas y tramas + tramas / 4 + TRAMAS_POR_NODO
+     * tramas, así que su memoria no depende de la duración de la sesión.
+     * Las que salen de la ventana se compactan (ver getCompactado()) y sus
+     * índices dejan de existir: el índice 0 pasa a ser la trama retenida más
+     * antigua. Con derrame, el texto compactado también ocupa memoria fija.
+     */
+    bool setVentana(int tramas, const char* rutaDerrame = nullptr);
+    
+    /**
+     * @brief Obtiene el tamaño de la ventana
+     * @return Tramas retenidas como mínimo (0: sin ventana)
+     */
+    int getVentana() const { return ventana; }
+    
+    /**
+     * @brief Obtiene el resumen de las tramas que salieron de la ventana
+     * @return Tramas, LOAD y desplazamiento del rotor compactados
+     */
+    const EstadoCompactado& getCompactado() const { return compactado; }
+    
+    /**
+     * @brief Obtiene el texto decodificado de las tramas compactadas
+     * @return Texto compactado
+     */
+    const TextoCompactado& getTextoCompactado() const { return texto; }
+    
+    /**
+     * @brief Obtiene el número de tramas de toda la sesión
+     * @return Tramas compactadas más las retenidas
+     */
+    long getTramasTotales() const { return compactado.tramas + tamano; }
+    
     /**
      * @brief Obtiene el tamaño de la lista
-     * @return Número de tramas almacenadas
+     * @return Número de tramas almacenadas (con ventana, las retenidas)
      */
     int getTamano() const { return tamano; }
     
@@ -84,6 +483,12 @@ public:
      * @return true si está vacía, false en caso contrario
      */
     bool estaVacia() const { return cabeza == nullptr; }
+    
+    /**
+     * @brief Obtiene las estadísticas de la arena de la lista
+     * @return Asignaciones, bloques y bytes usados/reservados
+     */
+    const EstadisticasArena& getEstadisticasArena() const { return arena.getEstadisticas(); }
 };
 
-#endif // LISTA_DE_CARGA_H
\ No newline at end of file
+#endif // LISTA_DE_CARGA_H
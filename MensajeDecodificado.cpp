@@ -0,0 +1,77 @@
+/**
+ * @file MensajeDecodificado.cpp
+ * @brief Implementación de la clase MensajeDecodificado
+ * @author Eliezer Mores Oyervides
+ */
+
+#include "MensajeDecodificado.h"
+#include "RotorDeMapeo.h"
+#include <cstring>
+
+MensajeDecodificado::MensajeDecodificado(long capacidadInicial)
+    : texto(nullptr), longitud(0), capacidad(capacidadInicial < 16 ? 16 : capacidadInicial + 1), descartados(0) {
+    texto = new char[capacidad];
+    texto[0] = '\0';
+}
+
+MensajeDecodificado::~MensajeDecodificado() {
+    delete[] texto;
+}
+
+void MensajeDecodificado::crecer(long minima) {
+    long nuevaCapacidad = capacidad;
+    while (nuevaCapacidad < minima) nuevaCapacidad *= 2;
+    
+    char* nuevo = new char[nuevaCapacidad];
+    std::memcpy(nuevo, texto, longitud + 1);
+    delete[] texto;
+    texto = nuevo;
+    capacidad = nuevaCapacidad;
+}
+
+void MensajeDecodificado::agregar(const char* datos, long n) {
+    if (n <= 0) return;
+    if (longitud + n >= capacidad) crecer(longitud + n + 1);
+    std::memcpy(texto + longitud, datos, n);
+    longitud += n;
+    texto[longitud] = '\0';
+}
+
+void MensajeDecodificado::aplicar(const CambioMensaje& cambio) {
+    long posicion = cambio.posicion - descartados;
+    if (posicion < 0 || posicion + cambio.eliminados > longitud) return;
+    
+    long nuevaLongitud = longitud - cambio.eliminados + cambio.insertados;
+    if (nuevaLongitud >= capacidad) crecer(nuevaLongitud + 1);
+    
+    if (cambio.eliminados != cambio.insertados) {
+        // Mover la cola, incluido el '\0'
+        std::memmove(texto + posicion + cambio.insertados, texto + posicion + cambio.eliminados,
+                     longitud - posicion - cambio.eliminados + 1);
+    }
+    if (cambio.insertados > 0) texto[posicion] = cambio.caracter;
+    longitud = nuevaLongitud;
+    
+    long inicioRotado = posicion + cambio.insertados;
+    if (cambio.rotacion != 0 && inicioRotado < longitud) {
+        // Decodificar con d y después con r equivale a decodificar con d + r
+        RotorDeMapeo::mapearBloque(texto + inicioRotado, texto + inicioRotado,
+                                   longitud - inicioRotado, cambio.rotacion);
+    }
+}
+
+void MensajeDecodificado::vaciar() {
+    longitud = 0;
+    descartados = 0;
+    texto[0] = '\0';
+}
+
+void MensajeDecodificado::descartarInicio(long n) {
+    if (n <= 0) return;
+    if (n > longitud) n = longitud;
+    
+    // Mover el final, incluido el '\0'
+    std::memmove(texto, texto + n, longitud - n + 1);
+    longitud -= n;
+    descartados += n;
+}
@@ -0,0 +1,144 @@
+/**
+ * @file MensajeDecodificado.h
+ * @brief Almacén creciente para el mensaje que se va decodificando
+ * @author Eliezer Mores Oyervides
+ * @date 2025
+ */
+
+#ifndef MENSAJE_DECODIFICADO_H
+#define MENSAJE_DECODIFICADO_H
+
+/**
+ * @struct CambioMensaje
+ * @brief Parte del mensaje decodificado que invalida una edición de ListaDeCarga
+ * 
+ * Se aplica en este orden: en la posición se quitan eliminados caracteres
+ * y se ponen insertados (el carácter ya decodificado); después todo lo que
+ * sigue se rota rotacion posiciones más. Cambiar un MAP desplaza igual a
+ * todas las letras posteriores, así que basta una pasada de
+ * RotorDeMapeo::mapearBloque() sobre el texto ya decodificado en lugar de
+ * repetir las tramas.
+ */
+struct CambioMensaje {
+    long posicion;  ///< Posición del mensaje donde empieza el cambio
+    int eliminados; ///< Caracteres que se quitan en la posición (0 o 1)
+    int insertados; ///< Caracteres que se ponen en la posición (0 o 1)
+    char caracter;  ///< Carácter decodificado que se pone, si insertados es 1
+    int rotacion;   ///< Rotación (0..25) de todo el resto del mensaje a partir de la posición + insertados
+};
+
+/**
+ * @class MensajeDecodificado
+ * @brief Cadena terminada en '\0' que duplica su capacidad al llenarse
+ * 
+ * Sustituye al char[1000] fijo del modo en tiempo real, que se desbordaba
+ * en sesiones largas. agregar() es O(1) amortizado.
+ */
+class MensajeDecodificado {
+private:
+    char* texto;    ///< Caracteres decodificados, siempre terminados en '\0'
+    long longitud;  ///< Caracteres almacenados
+    long capacidad; ///< Tamaño de texto (incluye el '\0')
+    long descartados; ///< Caracteres anteriores a texto que ya no se guardan
+    
+    /**
+     * @brief Duplica la capacidad hasta que quepan los caracteres pedidos
+     * @param minima Capacidad mínima requerida (incluye el '\0')
+     */
+    void crecer(long minima);
+    
+    // El mensaje es dueño de su buffer: no se copia
+    MensajeDecodificado(const MensajeDecodificado&);
+    MensajeDecodificado& operator=(const MensajeDecodificado&);
+    
+public:
+    /**
+     * @brief Constructor
+     * @param capacidadInicial Caracteres que caben antes del primer crecimiento
+     */
+    explicit MensajeDecodificado(long capacidadInicial = 256);
+    
+    /**
+     * @brief Destructor que libera el buffer
+     */
+    ~MensajeDecodificado();
+    
+    /**
+     * @brief Agrega un carácter al final del mensaje
+     * @param c Carácter decodificado
+     */
+    void agregar(char c) {
+        if (longitud + 1 >= capacidad) crecer(longitud + 2);
+        texto[longitud++] = c;
+        texto[longitud] = '\0';
+    }
+    
+    /**
+     * @brief Agrega varios caracteres al final del mensaje
+     * @param datos Caracteres a agregar
+     * @param n Número de caracteres
+     */
+    void agregar(const char* datos, long n);
+    
+    /**
+     * @brief Actualiza el mensaje tras editar la lista de tramas de la que salió
+     * @param cambio Cambio devuelto por ListaDeCarga::insertarEn(), eliminarEn() o reemplazarEn()
+     * 
+     * Solo toca lo que invalida la edición: un LOAD cuesta mover la cola del
+     * texto; un MAP, rotar la cola con el kernel SIMD de RotorDeMapeo.
+     */
+    void aplicar(const CambioMensaje& cambio);
+    
+    /**
+     * @brief Vacía el mensaje sin liberar el buffer
+     */
+    void vaciar();
+    
+    /**
+     * @brief Olvida el principio del mensaje y guarda solo el final
+     * @param n Caracteres a olvidar (se recorta a getLongitud())
+     * 
+     * Las posiciones de CambioMensaje siguen siendo las del mensaje
+     * completo: aplicar() descuenta lo olvidado.
+     */
+    void descartarInicio(long n);
+    
+    /**
+     * @brief Cuenta caracteres anteriores al texto guardado que nunca se agregaron
+     * @param n Caracteres (por ejemplo los ya compactados por ListaDeCarga)
+     */
+    void omitirAnteriores(long n) { descartados += n; }
+    
+    /**
+     * @brief Obtiene el mensaje
+     * @return Cadena terminada en '\0', válida hasta la siguiente modificación
+     */
+    const char* getTexto() const { return texto; }
+    
+    /**
+     * @brief Obtiene la longitud del mensaje
+     * @return Número de caracteres
+     */
+    long getLongitud() const { return longitud; }
+    
+    /**
+     * @brief Obtiene cuántos caracteres del principio ya no se guardan
+     * @return Caracteres descartados u omitidos
+     */
+    long getDescartados() const { return descartados; }
+    
+    /**
+     * @brief Obtiene la longitud del mensaje completo, incluido lo descartado
+     * @return getDescartados() + getLongitud()
+     */
+    long getLongitudTotal() const { return descartados + longitud; }
+    
+    /**
+     * @brief Obtiene un carácter del mensaje
+     * @param i Posición (0 <= i < getLongitud())
+     * @return Carácter en la posición i
+     */
+    char operator[](long i) const { return texto[i]; }
+};
+
+#endif // MENSAJE_DECODIFICADO_H
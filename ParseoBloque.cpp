@@ -0,0 +1,348 @@
+/**
+ * @file ParseoBloque.cpp
+ * @brief Implementación de parsearBloque() con SSE2/AVX2
+ * @author Eliezer Mores Oyervides
+ *
+ * El texto se clasifica en bloques de 64 bytes: el kernel devuelve, por
+ * cada bloque, una máscara de 64 bits con las posiciones de '\n' y otra
+ * con las de ','.
+ * Las líneas se recorren saltando de bit en bit (__builtin_ctzll), así que
+ * ni el fin de línea ni la coma se buscan byte por byte. El kernel se elige
+ * una sola vez según las capacidades del CPU, como en RotorDeMapeoSIMD.cpp.
+ */
+
+#include "ParseoBloque.h"
+#include "Tramas.h"
+#include "FormatoBinario.h"
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define PRT7_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/**
+ * @brief Bytes que cubre cada máscara de separadores
+ */
+const size_t BYTES_POR_BLOQUE = 64;
+
+/**
+ * @brief Bloques clasificados por cada llamada al kernel (1 KiB)
+ *
+ * El kernel se llama por puntero: clasificar varios bloques por llamada
+ * reparte el costo de la llamada indirecta entre unas 200 líneas.
+ */
+const size_t BLOQUES_POR_LLAMADA = 16;
+
+typedef void (*KernelSeparadores)(const char*, size_t, unsigned long long*, unsigned long long*);
+
+/**
+ * @brief Versión escalar: un bit por byte
+ */
+void separadoresEscalar(const char* datos, size_t bloques, unsigned long long* saltos,
+                        unsigned long long* comas) {
+    for (size_t b = 0; b < bloques; b++) {
+        const char* bloque = datos + b * BYTES_POR_BLOQUE;
+        unsigned long long s = 0;
+        unsigned long long c = 0;
+        for (size_t i = 0; i < BYTES_POR_BLOQUE; i++) {
+            s |= static_cast<unsigned long long>(bloque[i] == '\n') << i;
+            c |= static_cast<unsigned long long>(bloque[i] == ',') << i;
+        }
+        saltos[b] = s;
+        comas[b] = c;
+    }
+}
+
+#ifdef PRT7_SIMD_X86
+
+void separadoresSSE2(const char* datos, size_t bloques, unsigned long long* saltos,
+                     unsigned long long* comas) {
+    const __m128i salto = _mm_set1_epi8('\n');
+    const __m128i coma = _mm_set1_epi8(',');
+    for (size_t b = 0; b < bloques; b++) {
+        const char* bloque = datos + b * BYTES_POR_BLOQUE;
+        unsigned long long s = 0;
+        unsigned long long c = 0;
+        for (int i = 0; i < 4; i++) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bloque + 16 * i));
+            unsigned int sv = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, salto)));
+            unsigned int cv = static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, coma)));
+            s |= static_cast<unsigned long long>(sv) << (16 * i);
+            c |= static_cast<unsigned long long>(cv) << (16 * i);
+        }
+        saltos[b] = s;
+        comas[b] = c;
+    }
+}
+
+__attribute__((target("avx2")))
+void separadoresAVX2(const char* datos, size_t bloques, unsigned long long* saltos,
+                     unsigned long long* comas) {
+    const __m256i salto = _mm256_set1_epi8('\n');
+    const __m256i coma = _mm256_set1_epi8(',');
+    for (size_t b = 0; b < bloques; b++) {
+        const char* bloque = datos + b * BYTES_POR_BLOQUE;
+        __m256i bajo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bloque));
+        __m256i alto = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bloque + 32));
+        
+        unsigned int sBajo = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bajo, salto)));
+        unsigned int sAlto = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(alto, salto)));
+        unsigned int cBajo = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bajo, coma)));
+        unsigned int cAlto = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(alto, coma)));
+        
+        saltos[b] = (static_cast<unsigned long long>(sAlto) << 32) | sBajo;
+        comas[b] = (static_cast<unsigned long long>(cAlto) << 32) | cBajo;
+    }
+}
+
+#endif // PRT7_SIMD_X86
+
+/**
+ * @brief Kernel elegido según el CPU
+ */
+struct SeleccionKernel {
+    KernelSeparadores kernel;
+    const char* nombre;
+    
+    SeleccionKernel() : kernel(separadoresEscalar), nombre("escalar") {
+#ifdef PRT7_SIMD_X86
+        kernel = separadoresSSE2;
+        nombre = "sse2";
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            kernel = separadoresAVX2;
+            nombre = "avx2";
+        }
+#endif
+    }
+};
+
+const SeleccionKernel& seleccion() {
+    static const SeleccionKernel s;
+    return s;
+}
+
+/**
+ * @brief Decodifica una línea de texto cuya primera coma ya se conoce
+ * @param linea Inicio de la línea
+ * @param fin Fin de la línea (sin '\r')
+ * @param coma Primera coma de la línea, o fin si no tiene
+ * @param trama Trama resultante
+ * @return true si la línea es una trama válida
+ *
+ * Mismas reglas que parsearTrama() en Tramas.cpp.
+ */
+inline bool decodificarLinea(const char* linea, const char* fin, const char* coma, TramaCompacta& trama) {
+    // Los espacios iniciales nunca son comas, así que la coma queda después del tipo
+    while (linea < fin && (*linea == ' ' || *linea == '\t')) linea++;
+    if (linea == fin || coma >= fin) return false;
+    
+    // 'L'/'l' y 'M'/'m' solo difieren en el bit 0x20
+    char tipo = static_cast<char>(*linea | 0x20);
+    
+    const char* valor = coma + 1;
+    while (valor < fin && (*valor == ' ' || *valor == '\t')) valor++;
+    
+    if (tipo == 'l') {
+        if (valor == fin) return false;
+        if (fin - valor >= 5 && std::memcmp(valor, "Space", 5) == 0) {
+            trama = TramaCompacta::load(' ');
+        } else {
+            trama = TramaCompacta::load(valor[0]);
+        }
+        return true;
+    }
+    
+    if (tipo == 'm') {
+        bool negativo = false;
+        if (valor < fin && (*valor == '-' || *valor == '+')) {
+            negativo = (*valor == '-');
+            valor++;
+        }
+        
+        int rotacion = 0;
+        while (valor < fin && static_cast<unsigned char>(*valor - '0') <= 9) {
+            rotacion = rotacion * 10 + (*valor - '0');
+            valor++;
+        }
+        
+        trama = TramaCompacta::map(negativo ? -rotacion : rotacion);
+        return true;
+    }
+    
+    return false;
+}
+
+/**
+ * @brief Resultado de procesar una línea
+ */
+enum EstadoLinea {
+    LINEA_VACIA,    ///< Línea vacía, no cuenta
+    LINEA_TRAMA,    ///< Trama válida
+    LINEA_INVALIDA, ///< No es trama ni END
+    LINEA_FIN       ///< Se encontró END
+};
+
+/**
+ * @brief Camino general: END, tramas binarias y todo lo que no es "L,X"
+ */
+__attribute__((noinline))
+EstadoLinea procesarLineaGeneral(const char* linea, int longitud, const char* coma, TramaCompacta& trama) {
+    if (esTramaFin(linea, longitud)) return LINEA_FIN;
+    
+    bool valida;
+    if (esEtiquetaBinaria(linea[0])) {
+        valida = parsearTrama(linea, longitud, trama);
+    } else {
+        valida = decodificarLinea(linea, linea + longitud, coma, trama);
+    }
+    return valida ? LINEA_TRAMA : LINEA_INVALIDA;
+}
+
+/**
+ * @brief Clasifica y decodifica una línea completa
+ * @param linea Inicio de la línea
+ * @param finLinea Posición del '\n' (o fin de los datos)
+ * @param coma Primera coma de la línea, o finLinea si no tiene
+ * @param trama Trama resultante si la línea es LINEA_TRAMA
+ */
+inline EstadoLinea procesarLinea(const char* linea, const char* finLinea, const char* coma,
+                                 TramaCompacta& trama) {
+    int longitud = static_cast<int>(finLinea - linea);
+    if (longitud > 0 && linea[longitud - 1] == '\r') longitud--;
+    if (longitud == 0) return LINEA_VACIA;
+    
+    // Caso común "L,X": sin espacios y un solo carácter después de la coma
+    if (longitud == 3 && coma == linea + 1 && (linea[0] | 0x20) == 'l' &&
+        linea[2] != ' ' && linea[2] != '\t') {
+        trama = TramaCompacta::load(linea[2]);
+        return LINEA_TRAMA;
+    }
+    
+    // Caso común "M,N": rotación con signo opcional justo después de la coma
+    if (longitud > 2 && coma == linea + 1 && (linea[0] | 0x20) == 'm' &&
+        linea[2] != ' ' && linea[2] != '\t') {
+        const char* valor = linea + 2;
+        const char* fin = linea + longitud;
+        bool negativo = (*valor == '-');
+        valor += (*valor == '-' || *valor == '+');
+        
+        int rotacion = 0;
+        while (valor < fin && static_cast<unsigned char>(*valor - '0') <= 9) {
+            rotacion = rotacion * 10 + (*valor - '0');
+            valor++;
+        }
+        trama = TramaCompacta::map(negativo ? -rotacion : rotacion);
+        return LINEA_TRAMA;
+    }
+    return procesarLineaGeneral(linea, longitud, coma, trama);
+}
+
+} // namespace
+
+ResultadoParseo parsearBloque(const char* datos, size_t n, TramaCompacta* tramas, int capacidad,
+                              bool incluirUltima) {
+    // Los contadores van en variables locales: las escrituras de TramaCompacta
+    // (miembros char) pueden apuntar a cualquier parte y obligarían a
+    // releerlos de memoria si vivieran en el resultado
+    int escritas = 0;
+    long lineas = 0;
+    long invalidas = 0;
+    bool fin = false;
+    size_t inicioLinea = 0;
+    size_t comaPendiente = n; // Primera coma de la línea actual vista en un bloque anterior
+    
+    KernelSeparadores kernel = seleccion().kernel;
+    
+    unsigned long long mascarasSaltos[BLOQUES_POR_LLAMADA];
+    unsigned long long mascarasComas[BLOQUES_POR_LLAMADA];
+    size_t base = 0;
+    
+    while (base < n && escritas < capacidad && !fin) {
+        size_t bloques = (n - base) / BYTES_POR_BLOQUE;
+        if (bloques > BLOQUES_POR_LLAMADA) bloques = BLOQUES_POR_LLAMADA;
+        if (bloques > 0) {
+            kernel(datos + base, bloques, mascarasSaltos, mascarasComas);
+        } else {
+            // Último bloque incompleto: rellenar con ceros (no son '\n' ni ',')
+            char relleno[BYTES_POR_BLOQUE];
+            std::memset(relleno, 0, sizeof(relleno));
+            std::memcpy(relleno, datos + base, n - base);
+            kernel(relleno, 1, mascarasSaltos, mascarasComas);
+            bloques = 1;
+        }
+        
+        for (size_t b = 0; b < bloques && escritas < capacidad && !fin; b++, base += BYTES_POR_BLOQUE) {
+            unsigned long long saltos = mascarasSaltos[b];
+            unsigned long long comas = mascarasComas[b];
+            
+            while (saltos != 0) {
+                int bit = __builtin_ctzll(saltos);
+                size_t finLinea = base + bit;
+                
+                // La primera coma de la línea: de un bloque anterior o la menor de este
+                size_t coma = comaPendiente;
+                if (coma == n && comas != 0 && __builtin_ctzll(comas) < bit) {
+                    coma = base + __builtin_ctzll(comas);
+                }
+                if (coma > finLinea) coma = finLinea;
+                
+                // Se decodifica directamente en el lote: copiar una trama recién
+                // escrita byte a byte forzaría una lectura de 8 bytes sin reenvío
+                EstadoLinea estado = procesarLinea(datos + inicioLinea, datos + finLinea, datos + coma,
+                                                   tramas[escritas]);
+                if (estado == LINEA_TRAMA) {
+                    escritas++;
+                } else if (estado == LINEA_INVALIDA) {
+                    invalidas++;
+                } else if (estado == LINEA_FIN) {
+                    lineas++;
+                    inicioLinea = finLinea;
+                    fin = true;
+                    break;
+                }
+                lineas += (estado != LINEA_VACIA);
+                
+                // Descartar los separadores de la línea ya procesada
+                unsigned long long procesados = (bit == 63) ? ~0ULL : ((2ULL << bit) - 1);
+                saltos &= ~procesados;
+                comas &= ~procesados;
+                comaPendiente = n;
+                inicioLinea = finLinea + 1;
+                
+                if (escritas == capacidad) break;
+            }
+            
+            // La línea sigue en el siguiente bloque: recordar su primera coma
+            if (comaPendiente == n && comas != 0) {
+                comaPendiente = base + __builtin_ctzll(comas);
+            }
+        }
+    }
+    
+    // Línea final sin '\n' (fin de archivo)
+    if (incluirUltima && !fin && escritas < capacidad && inicioLinea < n) {
+        EstadoLinea estado = procesarLinea(datos + inicioLinea, datos + n, datos + comaPendiente,
+                                           tramas[escritas]);
+        if (estado == LINEA_TRAMA) escritas++;
+        if (estado == LINEA_INVALIDA) invalidas++;
+        if (estado == LINEA_FIN) fin = true;
+        lineas += (estado != LINEA_VACIA);
+        inicioLinea = n;
+    }
+    
+    ResultadoParseo resultado;
+    resultado.consumidos = inicioLinea;
+    resultado.tramas = escritas;
+    resultado.lineas = lineas;
+    resultado.lineasInvalidas = invalidas;
+    resultado.finEncontrado = fin;
+    return resultado;
+}
+
+const char* kernelParseo() {
+    return seleccion().nombre;
+}
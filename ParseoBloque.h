@@ -0,0 +1,61 @@
+/**
+ * @file ParseoBloque.h
+ * @brief Parseo de muchas tramas de texto por llamada, con búsqueda SIMD de separadores
+ * @author Eliezer Mores Oyervides
+ * @date 2025
+ */
+
+#ifndef PARSEO_BLOQUE_H
+#define PARSEO_BLOQUE_H
+
+#include <cstddef>
+#include "TramaCompacta.h"
+
+/**
+ * @brief Tramas por lote recomendadas para parsearBloque()
+ */
+const int TRAMAS_POR_LOTE = 1024;
+
+/**
+ * @struct ResultadoParseo
+ * @brief Resultado de una llamada a parsearBloque()
+ */
+struct ResultadoParseo {
+    size_t consumidos;     ///< Bytes procesados; la siguiente llamada empieza aquí
+    int tramas;            ///< Tramas escritas en el lote
+    long lineas;           ///< Líneas no vacías recorridas (incluida la de END)
+    long lineasInvalidas;  ///< Líneas que no son tramas ni END
+    bool finEncontrado;    ///< Se encontró END
+};
+
+/**
+ * @brief Parsea las líneas de un bloque de texto y escribe sus tramas en un lote
+ * @param datos Bytes de texto, una trama por línea ('\\n' con '\\r' opcional)
+ * @param n Número de bytes
+ * @param tramas Lote de salida
+ * @param capacidad Tramas que caben en el lote
+ * @param incluirUltima Procesar también la última línea aunque no termine en '\\n'
+ *                      (fin de archivo); si es false se deja para la siguiente llamada
+ * @return Tramas escritas, bytes consumidos y contadores de líneas
+ *
+ * Acepta exactamente lo mismo que parsearTrama() línea por línea: espacios
+ * al inicio, "l"/"m" en minúscula, rotaciones con signo, "Space" y END.
+ * Los saltos de línea y las comas se buscan en bloques de 64 bytes con
+ * SSE2/AVX2 (o con un bucle escalar si el CPU no los tiene), y cada línea se
+ * decodifica sin volver a recorrerla para encontrar sus separadores.
+ *
+ * Se detiene al llenar el lote o al encontrar END. Con END, consumidos
+ * apunta al final de esa línea (antes de su '\\n'), igual que
+ * ReproductorCaptura. Las líneas que empiezan con una etiqueta binaria se
+ * delegan a parsearTrama().
+ */
+ResultadoParseo parsearBloque(const char* datos, size_t n, TramaCompacta* tramas, int capacidad,
+                              bool incluirUltima);
+
+/**
+ * @brief Indica qué implementación de la búsqueda de separadores se eligió
+ * @return "avx2", "sse2" o "escalar"
+ */
+const char* kernelParseo();
+
+#endif // PARSEO_BLOQUE_H
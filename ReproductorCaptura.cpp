@@ -0,0 +1,148 @@
+/**
+ * @file ReproductorCaptura.cpp
+ * @brief Implementación de la clase ReproductorCaptura
+ * @author Eliezer Mores Oyervides
+ */
+
+#include "ReproductorCaptura.h"
+#include "Tramas.h"
+#include "FormatoBinario.h"
+#include "ParseoBloque.h"
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief Reproduce una captura en formato binario (ver FormatoBinario.h)
+ * @return Posición donde terminó la reproducción
+ */
+const char* reproducirBinario(const char* actual, const char* finArchivo, ListaDeCarga& lista,
+                              EstadisticasReproduccion& estadisticas) {
+    while (actual < finArchivo) {
+        unsigned char etiqueta = static_cast<unsigned char>(*actual);
+        int bytes = longitudTramaBinaria(etiqueta);
+        
+        // Bytes fuera de trama o sincronía: avanzar hasta la siguiente etiqueta
+        if (bytes == 0 || etiqueta == ETIQUETA_SINCRONIA) {
+            actual++;
+            continue;
+        }
+        if (finArchivo - actual < bytes) break;
+        
+        estadisticas.lineas++;
+        if (etiqueta == ETIQUETA_FIN) {
+            estadisticas.finEncontrado = true;
+            return actual + 1;
+        }
+        
+        TramaCompacta trama;
+        if (decodificarTramaBinaria(actual, bytes, trama)) {
+            lista.insertarAlFinal(trama);
+            estadisticas.tramas++;
+            actual += bytes;
+        } else {
+            // Trama cortada: resincronizar en el siguiente byte
+            estadisticas.lineasInvalidas++;
+            actual++;
+        }
+    }
+    return finArchivo;
+}
+
+} // namespace
+
+ReproductorCaptura::ReproductorCaptura() : descriptor(-1), datos(nullptr), tamano(0) {}
+
+ReproductorCaptura::~ReproductorCaptura() {
+    cerrar();
+}
+
+bool ReproductorCaptura::abrir(const char* ruta) {
+    cerrar();
+    
+    descriptor = open(ruta, O_RDONLY | O_CLOEXEC);
+    if (descriptor < 0) {
+        std::cerr << "Error: No se pudo abrir la captura " << ruta << std::endl;
+        return false;
+    }
+    
+    struct stat info;
+    if (fstat(descriptor, &info) != 0) {
+        std::cerr << "Error: No se pudo obtener el tamaño de la captura" << std::endl;
+        cerrar();
+        return false;
+    }
+    
+    tamano = static_cast<size_t>(info.st_size);
+    if (tamano == 0) return true;
+    
+    void* mapeo = mmap(nullptr, tamano, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (mapeo == MAP_FAILED) {
+        std::cerr << "Error: No se pudo mapear la captura en memoria" << std::endl;
+        tamano = 0;
+        cerrar();
+        return false;
+    }
+    
+    // La captura se recorre una sola vez de principio a fin
+    madvise(mapeo, tamano, MADV_SEQUENTIAL);
+    datos = static_cast<const char*>(mapeo);
+    return true;
+}
+
+EstadisticasReproduccion ReproductorCaptura::reproducir(ListaDeCarga& lista) {
+    EstadisticasReproduccion estadisticas;
+    estadisticas.bytes = 0;
+    estadisticas.lineas = 0;
+    estadisticas.tramas = 0;
+    estadisticas.lineasInvalidas = 0;
+    estadisticas.finEncontrado = false;
+    
+    const char* actual = datos;
+    const char* finArchivo = datos + tamano;
+    
+    // Las capturas binarias empiezan con una etiqueta (normalmente la de sincronía)
+    if (tamano > 0 && esEtiquetaBinaria(datos[0])) {
+        estadisticas.bytes = reproducirBinario(actual, finArchivo, lista, estadisticas) - datos;
+        return estadisticas;
+    }
+    
+    // Parsear por lotes: los separadores se buscan con SIMD en todo el mapeo
+    TramaCompacta lote[TRAMAS_POR_LOTE];
+    while (actual < finArchivo) {
+        ResultadoParseo resultado = parsearBloque(actual, finArchivo - actual, lote, TRAMAS_POR_LOTE, true);
+        for (int i = 0; i < resultado.tramas; i++) {
+            lista.insertarAlFinal(lote[i]);
+        }
+        
+        estadisticas.lineas += resultado.lineas;
+        estadisticas.tramas += resultado.tramas;
+        estadisticas.lineasInvalidas += resultado.lineasInvalidas;
+        actual += resultado.consumidos;
+        
+        if (resultado.finEncontrado) {
+            estadisticas.finEncontrado = true;
+            break;
+        }
+    }
+    
+    estadisticas.bytes = actual - datos;
+    return estadisticas;
+}
+
+void ReproductorCaptura::cerrar() {
+    if (datos != nullptr) {
+        munmap(const_cast<char*>(datos), tamano);
+        datos = nullptr;
+    }
+    if (descriptor >= 0) {
+        close(descriptor);
+        descriptor = -1;
+    }
+    tamano = 0;
+}
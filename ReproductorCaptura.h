@@ -0,0 +1,85 @@
+/**
+ * @file ReproductorCaptura.h
+ * @brief Reproducción de archivos de captura PRT-7 mapeados en memoria
+ * @author Eliezer Mores Oyervides
+ * @date 2025
+ */
+
+#ifndef REPRODUCTOR_CAPTURA_H
+#define REPRODUCTOR_CAPTURA_H
+
+#include <cstddef>
+#include "ListaDeCarga.h"
+
+/**
+ * @struct EstadisticasReproduccion
+ * @brief Resultado de una reproducción
+ */
+struct EstadisticasReproduccion {
+    size_t bytes;          ///< Bytes recorridos del archivo
+    long lineas;           ///< Líneas no vacías (o tramas binarias) encontradas
+    long tramas;           ///< Tramas válidas insertadas en la lista
+    long lineasInvalidas;  ///< Líneas que no son tramas ni END
+    bool finEncontrado;    ///< La captura contenía END
+};
+
+/**
+ * @class ReproductorCaptura
+ * @brief Lee un archivo de captura (texto o binario) sin copiarlo
+ * 
+ * El archivo se mapea con mmap y se marca con madvise(MADV_SEQUENTIAL);
+ * las líneas se parsean en su lugar por lotes con parsearBloque(), sin
+ * copiarlas a un buffer intermedio y sin un new por trama. Si el primer byte es una
+ * etiqueta binaria la captura se lee en el formato de FormatoBinario.h.
+ */
+class ReproductorCaptura {
+private:
+    int descriptor;     ///< File descriptor del archivo
+    const char* datos;  ///< Contenido mapeado
+    size_t tamano;      ///< Tamaño del archivo en bytes
+    
+    // El reproductor es dueño del mapeo: no se copia
+    ReproductorCaptura(const ReproductorCaptura&);
+    ReproductorCaptura& operator=(const ReproductorCaptura&);
+    
+public:
+    /**
+     * @brief Constructor
+     */
+    ReproductorCaptura();
+    
+    /**
+     * @brief Destructor que desmapea y cierra el archivo
+     */
+    ~ReproductorCaptura();
+    
+    /**
+     * @brief Abre y mapea un archivo de captura
+     * @param ruta Ruta del archivo
+     * @return true si se pudo mapear, false en caso contrario
+     */
+    bool abrir(const char* ruta);
+    
+    /**
+     * @brief Parsea todas las tramas de la captura y las inserta en la lista
+     * @param lista Lista donde se insertan las tramas en orden
+     * @return Estadísticas de la reproducción
+     * 
+     * Se detiene en la primera línea END, igual que el modo en tiempo real.
+     * Las líneas terminan en '\\n' con un '\\r' opcional antes.
+     */
+    EstadisticasReproduccion reproducir(ListaDeCarga& lista);
+    
+    /**
+     * @brief Obtiene el tamaño del archivo mapeado
+     * @return Tamaño en bytes
+     */
+    size_t getTamano() const { return tamano; }
+    
+    /**
+     * @brief Desmapea y cierra el archivo
+     */
+    void cerrar();
+};
+
+#endif // REPRODUCTOR_CAPTURA_H
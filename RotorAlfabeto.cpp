@@ -0,0 +1,70 @@
+/**
+ * @file RotorAlfabeto.cpp
+ * @brief Implementación de la clase RotorConfigurable
+ * @author Eliezer Mores Oyervides
+ */
+
+#include "RotorAlfabeto.h"
+#include "RotorDeMapeo.h"
+#include <cstring>
+
+RotorConfigurable::RotorConfigurable(TipoAlfabeto alfabeto)
+    : tipo(alfabeto), tamano(0), directas(nullptr), inversas(nullptr), desplazamiento(0), tabla(nullptr) {
+    switch (alfabeto) {
+        case ALFABETO_DIGITOS:
+            tamano = RotorAlfabeto<AlfabetoDigitos>::TAMANO;
+            directas = RotorAlfabeto<AlfabetoDigitos>::tablaDirecta(0);
+            inversas = RotorAlfabeto<AlfabetoDigitos>::tablaInversa(0);
+            break;
+        case ALFABETO_ALFANUMERICO:
+            tamano = RotorAlfabeto<AlfabetoAlfanumerico>::TAMANO;
+            directas = RotorAlfabeto<AlfabetoAlfanumerico>::tablaDirecta(0);
+            inversas = RotorAlfabeto<AlfabetoAlfanumerico>::tablaInversa(0);
+            break;
+        case ALFABETO_IMPRIMIBLE:
+            tamano = RotorAlfabeto<AlfabetoImprimible>::TAMANO;
+            directas = RotorAlfabeto<AlfabetoImprimible>::tablaDirecta(0);
+            inversas = RotorAlfabeto<AlfabetoImprimible>::tablaInversa(0);
+            break;
+        case ALFABETO_LETRAS:
+        default:
+            tipo = ALFABETO_LETRAS;
+            tamano = RotorAlfabeto<AlfabetoLetras>::TAMANO;
+            directas = RotorAlfabeto<AlfabetoLetras>::tablaDirecta(0);
+            inversas = RotorAlfabeto<AlfabetoLetras>::tablaInversa(0);
+            break;
+    }
+    tabla = directas;
+}
+
+void RotorConfigurable::mapearBloque(const char* in, char* out, size_t n) const {
+    if (tipo == ALFABETO_LETRAS) {
+        RotorDeMapeo::mapearBloque(in, out, n, desplazamiento);
+        return;
+    }
+    for (size_t i = 0; i < n; i++) out[i] = tabla[static_cast<unsigned char>(in[i])];
+}
+
+bool RotorConfigurable::parsearTipo(const char* nombre, TipoAlfabeto& alfabeto) {
+    if (std::strcmp(nombre, "letras") == 0) {
+        alfabeto = ALFABETO_LETRAS;
+    } else if (std::strcmp(nombre, "digitos") == 0) {
+        alfabeto = ALFABETO_DIGITOS;
+    } else if (std::strcmp(nombre, "alfanumerico") == 0) {
+        alfabeto = ALFABETO_ALFANUMERICO;
+    } else if (std::strcmp(nombre, "imprimible") == 0) {
+        alfabeto = ALFABETO_IMPRIMIBLE;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* RotorConfigurable::nombreTipo(TipoAlfabeto alfabeto) {
+    switch (alfabeto) {
+        case ALFABETO_DIGITOS:      return "digitos";
+        case ALFABETO_ALFANUMERICO: return "alfanumerico";
+        case ALFABETO_IMPRIMIBLE:   return "imprimible";
+        default:                    return "letras";
+    }
+}
@@ -0,0 +1,368 @@
+/**
+ * @file RotorAlfabeto.h
+ * @brief Rotores especializados por alfabeto con tablas generadas en tiempo de compilación
+ * @author Eliezer Mores Oyervides
+ * @date 2025
+ *
+ * RotorDeMapeo rota solo sobre A-Z y construye su lista circular en el
+ * heap. RotorAlfabeto<Alfabeto> rota sobre cualquier alfabeto descrito
+ * por una estructura con TAMANO, caracter(i) y posicion(c), y sus tablas
+ * de decodificación e inversas (N x 256 bytes cada una) son constexpr:
+ * quedan en la sección de solo lectura del ejecutable, el rotor no
+ * reserva memoria y getMapeo() se reduce a una carga en línea.
+ *
+ * RotorConfigurable elige el alfabeto en tiempo de ejecución (--alfabeto)
+ * y usa las mismas tablas.
+ */
+
+#ifndef ROTOR_ALFABETO_H
+#define ROTOR_ALFABETO_H
+
+#include <cstddef>
+
+/**
+ * @brief Secuencia de enteros 0..N-1 como parámetros de plantilla
+ *
+ * C++11 no tiene std::integer_sequence; se arma a mano partiendo N a la
+ * mitad en cada paso, así que la profundidad de instanciación es log2(N)
+ * y alcanza para las 95 x 256 entradas del alfabeto imprimible.
+ */
+template <int... I>
+struct SecuenciaIndices {};
+
+/**
+ * @brief Une dos secuencias, desplazando la segunda por el tamaño de la primera
+ */
+template <typename A, typename B>
+struct ConcatenarIndices;
+
+template <int... I, int... J>
+struct ConcatenarIndices<SecuenciaIndices<I...>, SecuenciaIndices<J...> > {
+    typedef SecuenciaIndices<I..., (static_cast<int>(sizeof...(I)) + J)...> tipo;
+};
+
+/**
+ * @brief Genera SecuenciaIndices<0, 1, ..., N - 1>
+ */
+template <int N>
+struct GenerarIndices {
+    typedef typename ConcatenarIndices<typename GenerarIndices<N / 2>::tipo,
+                                       typename GenerarIndices<N - N / 2>::tipo>::tipo tipo;
+};
+
+template <>
+struct GenerarIndices<0> {
+    typedef SecuenciaIndices<> tipo;
+};
+
+template <>
+struct GenerarIndices<1> {
+    typedef SecuenciaIndices<0> tipo;
+};
+
+/**
+ * @struct AlfabetoLetras
+ * @brief A-Z; las minúsculas se decodifican como mayúsculas (igual que RotorDeMapeo)
+ */
+struct AlfabetoLetras {
+    static constexpr int TAMANO = 26;
+    static constexpr char caracter(int i) { return static_cast<char>('A' + i); }
+    static constexpr int posicion(char c) {
+        return (c >= 'A' && c <= 'Z') ? c - 'A' : (c >= 'a' && c <= 'z') ? c - 'a' : -1;
+    }
+};
+
+/**
+ * @struct AlfabetoDigitos
+ * @brief 0-9
+ */
+struct AlfabetoDigitos {
+    static constexpr int TAMANO = 10;
+    static constexpr char caracter(int i) { return static_cast<char>('0' + i); }
+    static constexpr int posicion(char c) { return (c >= '0' && c <= '9') ? c - '0' : -1; }
+};
+
+/**
+ * @struct AlfabetoAlfanumerico
+ * @brief A-Z seguido de 0-9; las minúsculas se decodifican como mayúsculas
+ */
+struct AlfabetoAlfanumerico {
+    static constexpr int TAMANO = 36;
+    static constexpr char caracter(int i) {
+        return (i < 26) ? static_cast<char>('A' + i) : static_cast<char>('0' + i - 26);
+    }
+    static constexpr int posicion(char c) {
+        return (c >= 'A' && c <= 'Z') ? c - 'A' : (c >= 'a' && c <= 'z') ? c - 'a' :
+               (c >= '0' && c <= '9') ? 26 + c - '0' : -1;
+    }
+};
+
+/**
+ * @struct AlfabetoImprimible
+ * @brief ASCII imprimible de ' ' a '~' (aquí el espacio también rota)
+ */
+struct AlfabetoImprimible {
+    static constexpr int TAMANO = 95;
+    static constexpr char caracter(int i) { return static_cast<char>(' ' + i); }
+    static constexpr int posicion(char c) { return (c >= ' ' && c <= '~') ? c - ' ' : -1; }
+};
+
+/**
+ * @brief Verifica en tiempo de compilación que posicion() invierte a caracter()
+ */
+template <typename Alfabeto>
+constexpr bool alfabetoValido(int i = 0) {
+    return i == Alfabeto::TAMANO ||
+           (Alfabeto::posicion(Alfabeto::caracter(i)) == i && alfabetoValido<Alfabeto>(i + 1));
+}
+
+/**
+ * @struct TablaAlfabeto
+ * @brief Una tabla de 256 entradas por cada desplazamiento, contiguas
+ */
+template <int N>
+struct TablaAlfabeto {
+    char datos[N * 256]; ///< datos[d * 256 + c]: resultado para el carácter c con desplazamiento d
+};
+
+/**
+ * @brief Entrada de la tabla de decodificación: índice = d * 256 + c
+ *
+ * Los caracteres fuera del alfabeto se devuelven sin cambios.
+ */
+template <typename Alfabeto>
+constexpr char entradaDirecta(int indice) {
+    return (Alfabeto::posicion(static_cast<char>(indice % 256)) < 0)
+        ? static_cast<char>(indice % 256)
+        : Alfabeto::caracter((Alfabeto::posicion(static_cast<char>(indice % 256)) + indice / 256)
+                             % Alfabeto::TAMANO);
+}
+
+/**
+ * @brief Entrada de la tabla inversa (codificación del emisor): índice = d * 256 + c
+ */
+template <typename Alfabeto>
+constexpr char entradaInversa(int indice) {
+    return (Alfabeto::posicion(static_cast<char>(indice % 256)) < 0)
+        ? static_cast<char>(indice % 256)
+        : Alfabeto::caracter((Alfabeto::posicion(static_cast<char>(indice % 256)) - indice / 256
+                              + Alfabeto::TAMANO) % Alfabeto::TAMANO);
+}
+
+template <typename Alfabeto, int... I>
+constexpr TablaAlfabeto<Alfabeto::TAMANO> construirDirecta(SecuenciaIndices<I...>) {
+    return TablaAlfabeto<Alfabeto::TAMANO>{ { entradaDirecta<Alfabeto>(I)... } };
+}
+
+template <typename Alfabeto, int... I>
+constexpr TablaAlfabeto<Alfabeto::TAMANO> construirInversa(SecuenciaIndices<I...>) {
+    return TablaAlfabeto<Alfabeto::TAMANO>{ { entradaInversa<Alfabeto>(I)... } };
+}
+
+/**
+ * @class RotorAlfabeto
+ * @brief Rotor de César sobre un alfabeto fijo en tiempo de compilación
+ * @tparam Alfabeto Estructura con TAMANO, caracter(i) y posicion(c)
+ *
+ * Mismo comportamiento que RotorDeMapeo para AlfabetoLetras, sin nodos en
+ * el heap: el estado es el desplazamiento y un puntero a la tabla.
+ */
+template <typename Alfabeto>
+class RotorAlfabeto {
+    static_assert(Alfabeto::TAMANO > 0 && Alfabeto::TAMANO <= 256, "Tamaño de alfabeto inválido");
+    static_assert(alfabetoValido<Alfabeto>(), "posicion() debe invertir a caracter()");
+    
+public:
+    static constexpr int TAMANO = Alfabeto::TAMANO; ///< Caracteres del alfabeto
+    
+    /// Tablas de decodificación, una por desplazamiento
+    static constexpr TablaAlfabeto<TAMANO> directa =
+        construirDirecta<Alfabeto>(typename GenerarIndices<TAMANO * 256>::tipo());
+    
+    /// Tablas inversas: deshacen directa con el mismo desplazamiento
+    static constexpr TablaAlfabeto<TAMANO> inversa =
+        construirInversa<Alfabeto>(typename GenerarIndices<TAMANO * 256>::tipo());
+        
+private:
+    int desplazamiento; ///< Posición de la cabeza respecto al primer carácter (0..TAMANO-1)
+    const char* tabla;  ///< Tabla de decodificación del desplazamiento actual
+    
+public:
+    /**
+     * @brief Constructor de un rotor sin rotar
+     */
+    RotorAlfabeto() : desplazamiento(0), tabla(directa.datos) {}
+    
+    /**
+     * @brief Rota el rotor N posiciones
+     * @param n Posiciones a rotar (positivo: adelante, negativo: atrás)
+     */
+    void rotar(int n) {
+        n %= TAMANO;
+        if (n < 0) n += TAMANO;
+        desplazamiento = (desplazamiento + n) % TAMANO;
+        tabla = directa.datos + desplazamiento * 256;
+    }
+    
+    /**
+     * @brief Decodifica un carácter con el desplazamiento actual
+     * @param in Carácter de entrada
+     * @return Carácter decodificado (sin cambios si no pertenece al alfabeto)
+     */
+    char getMapeo(char in) const { return tabla[static_cast<unsigned char>(in)]; }
+    
+    /**
+     * @brief Codifica un carácter: la operación inversa de getMapeo()
+     * @param in Carácter en claro
+     * @return Carácter que getMapeo() convierte en in
+     */
+    char getInverso(char in) const {
+        return inversa.datos[desplazamiento * 256 + static_cast<unsigned char>(in)];
+    }
+    
+    /**
+     * @brief Decodifica un bloque con el desplazamiento actual
+     * @param in Caracteres de entrada
+     * @param out Buffer de salida de al menos n caracteres (puede ser igual a in)
+     * @param n Número de caracteres
+     */
+    void mapearBloque(const char* in, char* out, size_t n) const {
+        for (size_t i = 0; i < n; i++) out[i] = tabla[static_cast<unsigned char>(in[i])];
+    }
+    
+    /**
+     * @brief Obtiene el desplazamiento actual
+     * @return Posición de la cabeza (0..TAMANO-1)
+     */
+    int getDesplazamiento() const { return desplazamiento; }
+    
+    /**
+     * @brief Tabla de decodificación de un desplazamiento
+     * @param d Desplazamiento (0..TAMANO-1)
+     * @return Tabla de 256 entradas
+     */
+    static const char* tablaDirecta(int d) { return directa.datos + d * 256; }
+    
+    /**
+     * @brief Tabla inversa de un desplazamiento
+     * @param d Desplazamiento (0..TAMANO-1)
+     * @return Tabla de 256 entradas
+     */
+    static const char* tablaInversa(int d) { return inversa.datos + d * 256; }
+};
+
+template <typename Alfabeto>
+constexpr int RotorAlfabeto<Alfabeto>::TAMANO;
+
+template <typename Alfabeto>
+constexpr TablaAlfabeto<RotorAlfabeto<Alfabeto>::TAMANO> RotorAlfabeto<Alfabeto>::directa;
+
+template <typename Alfabeto>
+constexpr TablaAlfabeto<RotorAlfabeto<Alfabeto>::TAMANO> RotorAlfabeto<Alfabeto>::inversa;
+
+/**
+ * @brief Alfabetos que se pueden elegir en tiempo de ejecución
+ */
+enum TipoAlfabeto {
+    ALFABETO_LETRAS,       ///< A-Z (el de RotorDeMapeo)
+    ALFABETO_DIGITOS,      ///< 0-9
+    ALFABETO_ALFANUMERICO, ///< A-Z y 0-9
+    ALFABETO_IMPRIMIBLE    ///< ASCII imprimible, espacio incluido
+};
+
+/**
+ * @class RotorConfigurable
+ * @brief Rotor con el alfabeto elegido al construirlo (por ejemplo con --alfabeto)
+ *
+ * Usa las tablas constexpr de la especialización correspondiente, así que
+ * getMapeo() cuesta lo mismo que en RotorAlfabeto; solo rotar() paga el
+ * módulo con un tamaño que no se conoce al compilar.
+ */
+class RotorConfigurable {
+private:
+    TipoAlfabeto tipo;    ///< Alfabeto elegido
+    int tamano;           ///< Caracteres del alfabeto
+    const char* directas; ///< Tablas de decodificación de la especialización
+    const char* inversas; ///< Tablas inversas de la especialización
+    int desplazamiento;   ///< Posición de la cabeza (0..tamano-1)
+    const char* tabla;    ///< Tabla de decodificación del desplazamiento actual
+    
+public:
+    /**
+     * @brief Constructor de un rotor sin rotar
+     * @param alfabeto Alfabeto sobre el que rota
+     */
+    explicit RotorConfigurable(TipoAlfabeto alfabeto = ALFABETO_LETRAS);
+    
+    /**
+     * @brief Rota el rotor N posiciones
+     * @param n Posiciones a rotar (positivo: adelante, negativo: atrás)
+     */
+    void rotar(int n) {
+        n %= tamano;
+        if (n < 0) n += tamano;
+        desplazamiento = (desplazamiento + n) % tamano;
+        tabla = directas + desplazamiento * 256;
+    }
+    
+    /**
+     * @brief Decodifica un carácter con el desplazamiento actual
+     * @param in Carácter de entrada
+     * @return Carácter decodificado
+     */
+    char getMapeo(char in) const { return tabla[static_cast<unsigned char>(in)]; }
+    
+    /**
+     * @brief Codifica un carácter: la operación inversa de getMapeo()
+     * @param in Carácter en claro
+     * @return Carácter que getMapeo() convierte en in
+     */
+    char getInverso(char in) const {
+        return inversas[desplazamiento * 256 + static_cast<unsigned char>(in)];
+    }
+    
+    /**
+     * @brief Decodifica un bloque con el desplazamiento actual
+     * @param in Caracteres de entrada
+     * @param out Buffer de salida de al menos n caracteres (puede ser igual a in)
+     * @param n Número de caracteres
+     *
+     * Con ALFABETO_LETRAS usa los kernels SIMD de RotorDeMapeo::mapearBloque().
+     */
+    void mapearBloque(const char* in, char* out, size_t n) const;
+    
+    /**
+     * @brief Obtiene el desplazamiento actual
+     * @return Posición de la cabeza (0..getTamanoAlfabeto()-1)
+     */
+    int getDesplazamiento() const { return desplazamiento; }
+    
+    /**
+     * @brief Obtiene el número de caracteres del alfabeto
+     * @return Tamaño del alfabeto
+     */
+    int getTamanoAlfabeto() const { return tamano; }
+    
+    /**
+     * @brief Obtiene el alfabeto elegido
+     * @return Tipo de alfabeto
+     */
+    TipoAlfabeto getTipo() const { return tipo; }
+    
+    /**
+     * @brief Interpreta el nombre de un alfabeto
+     * @param nombre "letras", "digitos", "alfanumerico" o "imprimible"
+     * @param alfabeto Recibe el alfabeto
+     * @return false si el nombre no es válido
+     */
+    static bool parsearTipo(const char* nombre, TipoAlfabeto& alfabeto);
+    
+    /**
+     * @brief Nombre de un alfabeto
+     * @param alfabeto Tipo de alfabeto
+     * @return Nombre que acepta parsearTipo()
+     */
+    static const char* nombreTipo(TipoAlfabeto alfabeto);
+};
+
+#endif // ROTOR_ALFABETO_H
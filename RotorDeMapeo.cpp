@@ -5,9 +5,18 @@
  */
 
 #include "RotorDeMapeo.h"
+#include "RotorAlfabeto.h"
 #include <iostream>
 
-RotorDeMapeo::RotorDeMapeo() : cabeza(nullptr), tamano(0) {
+static_assert(AlfabetoLetras::TAMANO == TAMANO_ALFABETO, "El rotor A-Z y AlfabetoLetras deben coincidir");
+
+const char* RotorDeMapeo::obtenerTabla(int desplazamiento) {
+    // Las tablas A-Z se generan en tiempo de compilación (RotorAlfabeto.h)
+    return RotorAlfabeto<AlfabetoLetras>::tablaDirecta(desplazamiento);
+}
+
+RotorDeMapeo::RotorDeMapeo()
+    : cabeza(nullptr), tamano(0), desplazamiento(0), tabla(obtenerTabla(0)) {
     // Crear el alfabeto A-Z (SIN espacio, el espacio no se cifra)
     const char alfabeto[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
     
@@ -15,6 +24,7 @@ RotorDeMapeo::RotorDeMapeo() : cabeza(nullptr), tamano(0) {
     
     for (int i = 0; alfabeto[i] != '\0'; i++) {
         NodoRotor* nuevo = new NodoRotor(alfabeto[i]);
+        nodos[i] = nuevo;
         
         if (cabeza == nullptr) {
             // Primer nodo
@@ -59,51 +69,10 @@ void RotorDeMapeo::rotar(int n) {
     n = n % tamano;
     if (n < 0) n += tamano;
     
-    // Rotar moviendo la cabeza
-    for (int i = 0; i < n; i++) {
-        cabeza = cabeza->siguiente;
-    }
-}
-
-char RotorDeMapeo::getMapeo(char in) {
-    if (cabeza == nullptr) return in;
-    
-    // Convertir a mayúscula si es letra
-    if (in >= 'a' && in <= 'z') {
-        in = in - 'a' + 'A';
-    }
-    
-    // IMPORTANTE: El espacio NO se cifra, siempre retorna espacio
-    if (in == ' ') {
-        return ' ';
-    }
-    
-    // Si no es una letra mayúscula, devolver sin cambios
-    if (in < 'A' || in > 'Z') {
-        return in;
-    }
-    
-    // Crear un rotor de referencia (sin rotación) para encontrar posición original
-    const char alfabeto[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
-    int posicionOriginal = -1;
-    
-    // Encontrar la posición del carácter en el alfabeto original
-    for (int i = 0; alfabeto[i] != '\0'; i++) {
-        if (alfabeto[i] == in) {
-            posicionOriginal = i;
-            break;
-        }
-    }
-    
-    if (posicionOriginal == -1) return in;
-    
-    // Ahora encontrar qué carácter está en esa posición en el rotor rotado
-    NodoRotor* resultado = cabeza;
-    for (int i = 0; i < posicionOriginal; i++) {
-        resultado = resultado->siguiente;
-    }
-    
-    return resultado->dato;
+    // Mover la cabeza directamente al nodo destino y cambiar de tabla
+    desplazamiento = (desplazamiento + n) % tamano;
+    cabeza = nodos[desplazamiento];
+    tabla = obtenerTabla(desplazamiento);
 }
 
 void RotorDeMapeo::imprimirEstado() {
@@ -8,6 +8,13 @@
 #ifndef ROTOR_DE_MAPEO_H
 #define ROTOR_DE_MAPEO_H
 
+#include <cstddef>
+
+/**
+ * @brief Número de letras del alfabeto del rotor (A-Z)
+ */
+const int TAMANO_ALFABETO = 26;
+
 /**
  * @struct NodoRotor
  * @brief Nodo de la lista circular que contiene un carácter
@@ -29,12 +36,20 @@ struct NodoRotor {
  * @brief Lista circular doblemente enlazada que simula un disco de cifrado
  * 
  * Funciona como una Rueda de César que puede rotar para cambiar
- * el mapeo entre caracteres de entrada y salida
+ * el mapeo entre caracteres de entrada y salida.
+ *
+ * Además de la lista circular, el rotor guarda su desplazamiento como
+ * un entero y apunta a una tabla de traducción de 256 entradas
+ * precalculada para ese desplazamiento. Así rotar() y getMapeo()
+ * cuestan O(1) en lugar de recorrer hasta 25 nodos por trama.
  */
 class RotorDeMapeo {
 private:
     NodoRotor* cabeza;  ///< Puntero a la posición 'cero' actual del rotor
     int tamano;         ///< Número de elementos en el rotor
+    NodoRotor* nodos[TAMANO_ALFABETO]; ///< Acceso directo a cada nodo por posición
+    int desplazamiento; ///< Posición de la cabeza respecto a 'A' (0..25)
+    const char* tabla;  ///< Tabla de traducción del desplazamiento actual
     
 public:
     /**
@@ -64,9 +79,54 @@ public:
      * @return Carácter decodificado según la posición del rotor
      * 
      * La lógica: encuentra 'in' en el rotor, calcula su distancia
-     * desde cabeza, y devuelve el carácter que está a esa distancia
+     * desde cabeza, y devuelve el carácter que está a esa distancia.
+     * Se resuelve con una sola consulta a la tabla precalculada.
+     */
+    char getMapeo(char in) const { return tabla[static_cast<unsigned char>(in)]; }
+    
+    /**
+     * @brief Decodifica un bloque de caracteres con el estado actual del rotor
+     * @param in Caracteres de entrada (fragmentos de tramas LOAD consecutivas)
+     * @param out Buffer de salida de al menos n caracteres (puede ser igual a in)
+     * @param n Número de caracteres a decodificar
+     * 
+     * Equivale a llamar getMapeo() sobre cada carácter, pero procesa
+     * 16 o 32 bytes por instrucción con SSE2/AVX2 cuando el CPU lo permite
+     */
+    void mapearBloque(const char* in, char* out, size_t n) const {
+        mapearBloque(in, out, n, desplazamiento);
+    }
+    
+    /**
+     * @brief Decodifica un bloque de caracteres con un desplazamiento dado
+     * @param in Caracteres de entrada
+     * @param out Buffer de salida de al menos n caracteres (puede ser igual a in)
+     * @param n Número de caracteres a decodificar
+     * @param desplazamiento Posición de la cabeza respecto a 'A' (0..25)
+     */
+    static void mapearBloque(const char* in, char* out, size_t n, int desplazamiento);
+    
+    /**
+     * @brief Indica qué implementación de mapearBloque() se eligió en tiempo de ejecución
+     * @return "avx2", "sse2" o "escalar"
+     */
+    static const char* kernelBloque();
+    
+    /**
+     * @brief Obtiene el desplazamiento actual del rotor
+     * @return Posición de la cabeza respecto a 'A' (0..25)
+     */
+    int getDesplazamiento() const { return desplazamiento; }
+    
+    /**
+     * @brief Obtiene la tabla de traducción para un desplazamiento dado
+     * @param desplazamiento Posición de la cabeza respecto a 'A' (0..25)
+     * @return Tabla de 256 entradas indexada por el carácter de entrada
+     * 
+     * Las 26 tablas son las de RotorAlfabeto<AlfabetoLetras>, generadas en
+     * tiempo de compilación y compartidas entre rotores
      */
-    char getMapeo(char in);
+    static const char* obtenerTabla(int desplazamiento);
     
     /**
      * @brief Imprime el estado actual del rotor (para debugging)
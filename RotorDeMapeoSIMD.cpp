@@ -0,0 +1,135 @@
+/**
+ * @file RotorDeMapeoSIMD.cpp
+ * @brief Decodificación en bloque del RotorDeMapeo con SSE2/AVX2
+ * @author Eliezer Mores Oyervides
+ * 
+ * Entre dos tramas MAP todas las tramas LOAD usan el mismo desplazamiento,
+ * así que sus caracteres pueden decodificarse juntos. Cada kernel hace en
+ * paralelo lo mismo que la tabla de getMapeo(): pasar minúsculas a
+ * mayúsculas, detectar las letras A-Z y sumarles el desplazamiento módulo 26.
+ * El kernel se elige una sola vez según las capacidades del CPU.
+ */
+
+#include "RotorDeMapeo.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define PRT7_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+typedef void (*KernelMapeo)(const char*, char*, size_t, int);
+
+/**
+ * @brief Versión escalar basada en la tabla de traducción
+ */
+void mapearEscalar(const char* in, char* out, size_t n, int desplazamiento) {
+    const char* tabla = RotorDeMapeo::obtenerTabla(desplazamiento);
+    for (size_t i = 0; i < n; i++) {
+        out[i] = tabla[static_cast<unsigned char>(in[i])];
+    }
+}
+
+#ifdef PRT7_SIMD_X86
+
+/**
+ * @brief Decodifica 16 bytes
+ * 
+ * Las comparaciones son con signo, por lo que los bytes >= 0x80 nunca se
+ * consideran letras y se devuelven sin cambios, igual que en la tabla.
+ */
+inline __m128i mapear16(__m128i v, __m128i desp) {
+    // Minúsculas a mayúsculas
+    __m128i esMinuscula = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('a' - 1)),
+                                        _mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), v));
+    v = _mm_sub_epi8(v, _mm_and_si128(esMinuscula, _mm_set1_epi8('a' - 'A')));
+    
+    // Solo las letras A-Z se desplazan
+    __m128i esLetra = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)),
+                                    _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), v));
+    __m128i desplazado = _mm_add_epi8(v, desp);
+    __m128i seSale = _mm_cmpgt_epi8(desplazado, _mm_set1_epi8('Z'));
+    desplazado = _mm_sub_epi8(desplazado, _mm_and_si128(seSale, _mm_set1_epi8(TAMANO_ALFABETO)));
+    
+    return _mm_or_si128(_mm_and_si128(esLetra, desplazado), _mm_andnot_si128(esLetra, v));
+}
+
+void mapearSSE2(const char* in, char* out, size_t n, int desplazamiento) {
+    const __m128i desp = _mm_set1_epi8(static_cast<char>(desplazamiento));
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), mapear16(v, desp));
+    }
+    mapearEscalar(in + i, out + i, n - i, desplazamiento);
+}
+
+__attribute__((target("avx2")))
+void mapearAVX2(const char* in, char* out, size_t n, int desplazamiento) {
+    const __m256i desp = _mm256_set1_epi8(static_cast<char>(desplazamiento));
+    const __m256i menorA = _mm256_set1_epi8('A' - 1);
+    const __m256i mayorZ = _mm256_set1_epi8('Z' + 1);
+    const __m256i menora = _mm256_set1_epi8('a' - 1);
+    const __m256i mayorz = _mm256_set1_epi8('z' + 1);
+    const __m256i letraZ = _mm256_set1_epi8('Z');
+    const __m256i difMayus = _mm256_set1_epi8('a' - 'A');
+    const __m256i alfabeto = _mm256_set1_epi8(TAMANO_ALFABETO);
+    
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        
+        __m256i esMinuscula = _mm256_and_si256(_mm256_cmpgt_epi8(v, menora),
+                                               _mm256_cmpgt_epi8(mayorz, v));
+        v = _mm256_sub_epi8(v, _mm256_and_si256(esMinuscula, difMayus));
+        
+        __m256i esLetra = _mm256_and_si256(_mm256_cmpgt_epi8(v, menorA),
+                                           _mm256_cmpgt_epi8(mayorZ, v));
+        __m256i desplazado = _mm256_add_epi8(v, desp);
+        __m256i seSale = _mm256_cmpgt_epi8(desplazado, letraZ);
+        desplazado = _mm256_sub_epi8(desplazado, _mm256_and_si256(seSale, alfabeto));
+        
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                            _mm256_blendv_epi8(v, desplazado, esLetra));
+    }
+    mapearSSE2(in + i, out + i, n - i, desplazamiento);
+}
+
+#endif // PRT7_SIMD_X86
+
+/**
+ * @brief Kernel elegido según el CPU
+ */
+struct SeleccionKernel {
+    KernelMapeo kernel;
+    const char* nombre;
+    
+    SeleccionKernel() : kernel(mapearEscalar), nombre("escalar") {
+#ifdef PRT7_SIMD_X86
+        // SSE2 está garantizado al compilar con __SSE2__; AVX2 se detecta
+        kernel = mapearSSE2;
+        nombre = "sse2";
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            kernel = mapearAVX2;
+            nombre = "avx2";
+        }
+#endif
+    }
+};
+
+const SeleccionKernel& seleccion() {
+    static const SeleccionKernel s;
+    return s;
+}
+
+} // namespace
+
+void RotorDeMapeo::mapearBloque(const char* in, char* out, size_t n, int desplazamiento) {
+    seleccion().kernel(in, out, n, desplazamiento);
+}
+
+const char* RotorDeMapeo::kernelBloque() {
+    return seleccion().nombre;
+}
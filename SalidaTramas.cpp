@@ -0,0 +1,192 @@
+/**
+ * @file SalidaTramas.cpp
+ * @brief Implementación de la clase SalidaTramas
+ * @author Eliezer Mores Oyervides
+ */
+
+#include "SalidaTramas.h"
+#include <cstring>
+#include <ostream>
+
+namespace {
+
+/**
+ * @brief Caracteres finales del mensaje que muestra cada resumen
+ */
+const long COLA_RESUMEN = 40;
+
+} // namespace
+
+SalidaTramas::SalidaTramas(std::ostream& flujo, ModoSalida modoInicial)
+    : destino(flujo), modo(modoInicial), intervaloResumen(1000), tramas(0), rotaciones(0),
+      buffer(new char[TAMANO_BUFFER_SALIDA]), usado(0) {}
+
+SalidaTramas::~SalidaTramas() {
+    vaciar();
+    delete[] buffer;
+}
+
+void SalidaTramas::entregar() {
+    if (usado > 0) {
+        destino.write(buffer, usado);
+        usado = 0;
+    }
+}
+
+void SalidaTramas::vaciar() {
+    entregar();
+    destino.flush();
+}
+
+void SalidaTramas::escribir(const char* datos, int n) {
+    while (n > 0) {
+        if (usado == TAMANO_BUFFER_SALIDA) entregar();
+        int cabe = TAMANO_BUFFER_SALIDA - usado;
+        int parte = (n < cabe) ? n : cabe;
+        std::memcpy(buffer + usado, datos, parte);
+        usado += parte;
+        datos += parte;
+        n -= parte;
+    }
+}
+
+void SalidaTramas::escribir(const char* cadena) {
+    escribir(cadena, static_cast<int>(std::strlen(cadena)));
+}
+
+void SalidaTramas::escribirEntero(long valor) {
+    char digitos[24];
+    int n = 0;
+    unsigned long magnitud = (valor < 0) ? 0UL - static_cast<unsigned long>(valor)
+                                         : static_cast<unsigned long>(valor);
+    do {
+        digitos[n++] = static_cast<char>('0' + magnitud % 10);
+        magnitud /= 10;
+    } while (magnitud != 0);
+    if (valor < 0) escribir('-');
+    while (n > 0) escribir(digitos[--n]);
+}
+
+void SalidaTramas::escribirEncabezado(const char* trama, int longitud) {
+    escribir("Trama recibida: [");
+    escribir(trama, longitud);
+    escribir("] -> ");
+}
+
+void SalidaTramas::resumirSiToca(const MensajeDecodificado& mensaje) {
+    if (tramas % intervaloResumen != 0) return;
+    
+    escribir("Resumen: ");
+    escribirEntero(tramas);
+    escribir(" tramas (");
+    escribirEntero(tramas - rotaciones);
+    escribir(" LOAD, ");
+    escribirEntero(rotaciones);
+    escribir(" MAP). Mensaje de ");
+    escribirEntero(mensaje.getLongitudTotal());
+    escribir(" caracteres: ");
+    
+    // Solo la parte final, para que la línea no crezca con la sesión
+    long inicio = mensaje.getLongitud() - COLA_RESUMEN;
+    if (inicio > 0 || mensaje.getDescartados() > 0) {
+        if (inicio < 0) inicio = 0;
+        escribir("...");
+    } else {
+        inicio = 0;
+    }
+    escribir('[');
+    escribir(mensaje.getTexto() + inicio, static_cast<int>(mensaje.getLongitud() - inicio));
+    escribir("]\n");
+}
+
+void SalidaTramas::registrarCarga(const char* trama, int longitud, char original, char decodificado,
+                                  const MensajeDecodificado& mensaje) {
+    tramas++;
+    
+    switch (modo) {
+        case SALIDA_COMPLETA:
+            escribirEncabezado(trama, longitud);
+            escribir("Procesando... -> Fragmento '");
+            escribir(original);
+            escribir("' decodificado como '");
+            escribir(decodificado);
+            escribir("'. Mensaje: [");
+            
+            // Formato original [X][X][X]: crece con el mensaje (con --ventana, solo el final)
+            if (mensaje.getDescartados() > 0) escribir("...");
+            for (long i = 0; i < mensaje.getLongitud(); i++) {
+                escribir('[');
+                escribir(mensaje[i]);
+                escribir(']');
+            }
+            escribir("]\n\n");
+            break;
+        
+        case SALIDA_INCREMENTAL:
+            escribirEncabezado(trama, longitud);
+            escribir("Fragmento '");
+            escribir(original);
+            escribir("' decodificado como '");
+            escribir(decodificado);
+            escribir("'. Mensaje += [");
+            escribir(decodificado);
+            escribir("] (");
+            escribirEntero(mensaje.getLongitudTotal());
+            escribir(")\n");
+            break;
+        
+        case SALIDA_RESUMEN:
+            resumirSiToca(mensaje);
+            break;
+        
+        case SALIDA_SILENCIOSA:
+            break;
+    }
+}
+
+void SalidaTramas::registrarRotacion(const char* trama, int longitud, int rotacion, char mapeoA,
+                                     const MensajeDecodificado& mensaje) {
+    tramas++;
+    rotaciones++;
+    
+    if (modo == SALIDA_COMPLETA || modo == SALIDA_INCREMENTAL) {
+        escribirEncabezado(trama, longitud);
+        if (modo == SALIDA_COMPLETA) escribir("Procesando... -> ");
+        escribir("ROTANDO ROTOR ");
+        if (rotacion >= 0) escribir('+');
+        escribirEntero(rotacion);
+        escribir(". (Ahora 'A' se mapea a '");
+        escribir(mapeoA);
+        escribir(modo == SALIDA_COMPLETA ? "')\n\n" : "')\n");
+    } else if (modo == SALIDA_RESUMEN) {
+        resumirSiToca(mensaje);
+    }
+}
+
+void SalidaTramas::registrarOmitidas(long cargas, long rotacionesOmitidas) {
+    long omitidas = cargas + rotacionesOmitidas;
+    if (omitidas <= 0) return;
+    tramas += omitidas;
+    rotaciones += rotacionesOmitidas;
+    
+    if (modo == SALIDA_COMPLETA || modo == SALIDA_INCREMENTAL) {
+        escribir("(");
+        escribirEntero(omitidas);
+        escribir(" tramas decodificadas sin mostrar: la salida no alcanzó al puerto)\n");
+    }
+}
+
+void SalidaTramas::avisar(const char* texto) {
+    escribir(texto);
+    escribir('\n');
+    vaciar();
+}
+
+bool SalidaTramas::parsearModo(const char* nombre, ModoSalida& modo) {
+    if (std::strcmp(nombre, "completa") == 0) modo = SALIDA_COMPLETA;
+    else if (std::strcmp(nombre, "incremental") == 0) modo = SALIDA_INCREMENTAL;
+    else if (std::strcmp(nombre, "resumen") == 0) modo = SALIDA_RESUMEN;
+    else if (std::strcmp(nombre, "silenciosa") == 0) modo = SALIDA_SILENCIOSA;
+    else return false;
+    return true;
+}
@@ -0,0 +1,168 @@
+/**
+ * @file SalidaTramas.h
+ * @brief Salida en consola del modo en tiempo real, con escritura por bloques
+ * @author Eliezer Mores Oyervides
+ * @date 2025
+ */
+
+#ifndef SALIDA_TRAMAS_H
+#define SALIDA_TRAMAS_H
+
+#include <iosfwd>
+#include "MensajeDecodificado.h"
+
+/**
+ * @brief Capacidad del buffer de SalidaTramas
+ */
+const int TAMANO_BUFFER_SALIDA = 64 * 1024;
+
+/**
+ * @brief Qué se muestra por cada trama procesada
+ */
+enum ModoSalida {
+    SALIDA_COMPLETA,    ///< Formato original: reimprime el mensaje completo en cada LOAD
+    SALIDA_INCREMENTAL, ///< Una línea por trama con solo el carácter nuevo
+    SALIDA_RESUMEN,     ///< Una línea de resumen cada cierto número de tramas
+    SALIDA_SILENCIOSA   ///< Nada hasta el mensaje final
+};
+
+/**
+ * @class SalidaTramas
+ * @brief Da formato a las tramas procesadas y las escribe en bloques grandes
+ *
+ * El texto se acumula en un buffer propio y solo se entrega al flujo de
+ * salida cuando el buffer se llena o al llamar a vaciar(), en lugar de
+ * hacer un flush con std::endl en cada línea. El modo en tiempo real
+ * llama a vaciar() una vez por cada lectura del puerto.
+ */
+class SalidaTramas {
+private:
+    std::ostream& destino;  ///< Flujo donde se escribe (normalmente std::cout)
+    ModoSalida modo;        ///< Modo actual
+    long intervaloResumen;  ///< Tramas entre líneas de SALIDA_RESUMEN
+    long tramas;            ///< Tramas registradas
+    long rotaciones;        ///< Tramas MAP registradas
+    char* buffer;           ///< Texto pendiente de escribir
+    int usado;              ///< Bytes ocupados de buffer
+    
+    /**
+     * @brief Agrega bytes al buffer, vaciándolo si no caben
+     */
+    void escribir(const char* datos, int n);
+    
+    /**
+     * @brief Agrega un carácter al buffer
+     */
+    void escribir(char c) {
+        if (usado == TAMANO_BUFFER_SALIDA) entregar();
+        buffer[usado++] = c;
+    }
+    
+    /**
+     * @brief Agrega una cadena terminada en '\0' al buffer
+     */
+    void escribir(const char* cadena);
+    
+    /**
+     * @brief Agrega un entero en decimal al buffer
+     */
+    void escribirEntero(long valor);
+    
+    /**
+     * @brief Agrega "Trama recibida: [trama] -> "
+     */
+    void escribirEncabezado(const char* trama, int longitud);
+    
+    /**
+     * @brief Escribe la línea de SALIDA_RESUMEN si toca
+     */
+    void resumirSiToca(const MensajeDecodificado& mensaje);
+    
+    /**
+     * @brief Pasa el buffer al flujo de destino sin hacer flush
+     */
+    void entregar();
+    
+    // La salida es dueña de su buffer: no se copia
+    SalidaTramas(const SalidaTramas&);
+    SalidaTramas& operator=(const SalidaTramas&);
+    
+public:
+    /**
+     * @brief Constructor
+     * @param flujo Flujo de salida
+     * @param modoInicial Modo inicial
+     */
+    explicit SalidaTramas(std::ostream& flujo, ModoSalida modoInicial = SALIDA_COMPLETA);
+    
+    /**
+     * @brief Destructor que vacía lo pendiente y libera el buffer
+     */
+    ~SalidaTramas();
+    
+    /**
+     * @brief Cambia el modo de salida
+     * @param nuevoModo Modo a usar desde la siguiente trama
+     */
+    void setModo(ModoSalida nuevoModo) { modo = nuevoModo; }
+    
+    /**
+     * @brief Cambia cada cuántas tramas se escribe el resumen
+     * @param intervalo Tramas entre resúmenes (mínimo 1)
+     */
+    void setIntervaloResumen(long intervalo) { intervaloResumen = (intervalo > 0) ? intervalo : 1; }
+    
+    /**
+     * @brief Registra una trama LOAD ya decodificada
+     * @param trama Texto de la trama (ej: "L,A"), no necesita '\0'
+     * @param longitud Caracteres de la trama
+     * @param original Carácter recibido
+     * @param decodificado Carácter después del rotor
+     * @param mensaje Mensaje completo, ya con el carácter nuevo
+     */
+    void registrarCarga(const char* trama, int longitud, char original, char decodificado,
+                        const MensajeDecodificado& mensaje);
+    
+    /**
+     * @brief Registra una trama MAP ya aplicada al rotor
+     * @param trama Texto de la trama (ej: "M,2"), no necesita '\0'
+     * @param longitud Caracteres de la trama
+     * @param rotacion Rotación aplicada
+     * @param mapeoA Carácter al que se mapea 'A' después de rotar
+     * @param mensaje Mensaje decodificado hasta ahora
+     */
+    void registrarRotacion(const char* trama, int longitud, int rotacion, char mapeoA,
+                           const MensajeDecodificado& mensaje);
+    
+    /**
+     * @brief Cuenta tramas que se procesaron sin pasar por la salida
+     * @param cargas Tramas LOAD omitidas
+     * @param rotacionesOmitidas Tramas MAP omitidas
+     * 
+     * La usa la tubería cuando descarta lotes de salida para no frenar al
+     * decodificador: los contadores del resumen siguen cuadrando y, en los
+     * modos que muestran cada trama, se avisa del hueco.
+     */
+    void registrarOmitidas(long cargas, long rotacionesOmitidas);
+    
+    /**
+     * @brief Escribe una línea de aviso (por ejemplo de inactividad) y vacía la salida
+     * @param texto Línea sin el fin de línea
+     */
+    void avisar(const char* texto);
+    
+    /**
+     * @brief Entrega el texto pendiente y hace flush del flujo de destino
+     */
+    void vaciar();
+    
+    /**
+     * @brief Convierte un nombre de modo ("completa", "incremental", "resumen", "silenciosa")
+     * @param nombre Nombre del modo
+     * @param modo Modo resultante
+     * @return true si el nombre es válido
+     */
+    static bool parsearModo(const char* nombre, ModoSalida& modo);
+};
+
+#endif // SALIDA_TRAMAS_H
@@ -5,16 +5,36 @@
  */
 
 #include "SerialReader.h"
+#include "FormatoBinario.h"
+#include "Instrumentacion.h"
 #include <iostream>
+#include <cerrno>
 #include <cstring>
+#include <poll.h>
 
-SerialReader::SerialReader() : puerto(-1), conectado(false) {}
+SerialReader::SerialReader()
+    : puerto(-1), conectado(false), inicioDatos(0), finDatos(0),
+      modo(MODO_AUTO), binarioDetectado(false), baudiosEfectivos(0), bajaLatencia(false) {}
 
 SerialReader::~SerialReader() {
     cerrar();
 }
 
 bool SerialReader::conectar(const char* nombrePuerto, int baudRate) {
+    ConfiguracionSerial configuracion;
+    configuracion.baudios = baudRate;
+    return conectar(nombrePuerto, configuracion);
+}
+
+bool SerialReader::conectar(const char* nombrePuerto, const ConfiguracionSerial& configuracion) {
+    if (configuracion.baudios <= 0 ||
+        configuracion.vmin < 0 || configuracion.vmin > MAXIMO_VMIN_VTIME ||
+        configuracion.vtime < 0 || configuracion.vtime > MAXIMO_VMIN_VTIME) {
+        std::cerr << "Error: Configuración del puerto fuera de rango (baudios > 0, VMIN y VTIME 0-"
+                  << MAXIMO_VMIN_VTIME << ")" << std::endl;
+        return false;
+    }
+    
     // Abrir el puerto serial
     puerto = open(nombrePuerto, O_RDWR | O_NOCTTY);
     
@@ -33,16 +53,7 @@ bool SerialReader::conectar(const char* nombrePuerto, int baudRate) {
         return false;
     }
     
-    // Configurar velocidad (baud rate)
-    speed_t speed = B9600;
-    if (baudRate == 115200) speed = B115200;
-    else if (baudRate == 57600) speed = B57600;
-    else if (baudRate == 38400) speed = B38400;
-    else if (baudRate == 19200) speed = B19200;
-    else if (baudRate == 4800) speed = B4800;
-    
-    cfsetospeed(&tty, speed);
-    cfsetispeed(&tty, speed);
+    // La velocidad se fija después con termios2, que acepta cualquier valor
     
     // Configuración 8N1 (8 bits, sin paridad, 1 bit de parada)
     tty.c_cflag &= ~PARENB;        // Sin paridad
@@ -73,9 +84,9 @@ bool SerialReader::conectar(const char* nombrePuerto, int baudRate) {
     tty.c_oflag &= ~OPOST;
     tty.c_oflag &= ~ONLCR;
     
-    // Configurar timeout de lectura
-    tty.c_cc[VTIME] = 1;  // Timeout de 0.1 segundos
-    tty.c_cc[VMIN] = 0;   // Retornar inmediatamente con datos disponibles
+    // Configurar timeout de lectura (por defecto: 0.1 s, volver con lo que haya)
+    tty.c_cc[VTIME] = static_cast<cc_t>(configuracion.vtime);
+    tty.c_cc[VMIN] = static_cast<cc_t>(configuracion.vmin);
     
     // Aplicar configuración
     if (tcsetattr(puerto, TCSANOW, &tty) != 0) {
@@ -85,46 +96,254 @@ bool SerialReader::conectar(const char* nombrePuerto, int baudRate) {
         return false;
     }
     
+    if (!fijarVelocidad(puerto, configuracion.baudios, baudiosEfectivos)) {
+        std::cerr << "Error: El puerto no acepta " << configuracion.baudios << " baudios" << std::endl;
+        close(puerto);
+        puerto = -1;
+        return false;
+    }
+    
+    // La baja latencia es una mejora opcional: sin soporte solo se avisa
+    bajaLatencia = false;
+    if (configuracion.bajaLatencia) {
+        bajaLatencia = fijarBajaLatencia(puerto, true);
+        if (!bajaLatencia) {
+            std::cerr << "Aviso: El driver de " << nombrePuerto << " no admite baja latencia" << std::endl;
+        }
+    }
+    
     // Limpiar buffers
     tcflush(puerto, TCIOFLUSH);
+    inicioDatos = 0;
+    finDatos = 0;
+    binarioDetectado = false;
     
     conectado = true;
     return true;
 }
 
-bool SerialReader::leerLinea(char* buffer, int maxLen) {
-    if (!conectado || puerto < 0) return false;
+int SerialReader::leerDisponible() {
+    if (!conectado || puerto < 0) return -1;
+    
+    // Compactar: mover los bytes pendientes al inicio
+    if (inicioDatos > 0) {
+        int pendientes = finDatos - inicioDatos;
+        if (pendientes > 0) {
+            std::memmove(bufferLectura, bufferLectura + inicioDatos, pendientes);
+        }
+        inicioDatos = 0;
+        finDatos = pendientes;
+    }
+    
+    // Buffer lleno de una línea sin terminar: extraerLinea() la entrega sin leer más
+    if (finDatos == TAMANO_BUFFER_SERIAL) return 0;
     
-    int pos = 0;
+    // Un solo read() trae todo lo disponible que quepa
+    int n;
+    {
+        MedicionEtapa medicion(ETAPA_LECTURA);
+        n = read(puerto, bufferLectura + finDatos, TAMANO_BUFFER_SERIAL - finDatos);
+    }
+    
+    if (n < 0) {
+        // Sin datos en modo no bloqueante
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) return 0;
+        
+        // Error de lectura
+        contar(CONTADOR_ERRORES_LECTURA);
+        std::cerr << "Error al leer del puerto serial" << std::endl;
+        return -1;
+    }
+    
+    // Fin de archivo: el otro extremo colgó (sin datos es EAGAIN, no 0)
+    if (n == 0) return -1;
     
-    while (pos < maxLen - 1) {
-        char c;
-        int n = read(puerto, &c, 1);
+    contar(CONTADOR_BYTES, n);
+    finDatos += n;
+    return n;
+}
+
+bool SerialReader::empiezaTramaTexto(int posicion) const {
+    char c = bufferLectura[posicion];
+    return (c == 'L' || c == 'l' || c == 'M' || c == 'm') && posicion + 1 < finDatos &&
+           bufferLectura[posicion + 1] == ',';
+}
+
+int SerialReader::confirmarBinario() const {
+    int posicion = inicioDatos;
+    int validas = 0;
+    while (validas < TRAMAS_CONFIRMACION_BINARIO) {
+        if (posicion >= finDatos) return 0;
+        unsigned char etiqueta = static_cast<unsigned char>(bufferLectura[posicion]);
+        if (etiqueta == ETIQUETA_SINCRONIA) return 1;
+        
+        int bytes = longitudTramaBinaria(etiqueta);
+        if (bytes == 0) return -1;
+        if (finDatos - posicion < bytes) return 0;
         
-        if (n < 0) {
-            // Error de lectura
-            std::cerr << "Error al leer del puerto serial" << std::endl;
-            return false;
-        } else if (n == 0) {
-            // No hay datos disponibles, continuar esperando
+        // END tras al menos una trama válida cierra un flujo binario corto
+        if (etiqueta == ETIQUETA_FIN) return (validas > 0) ? 1 : -1;
+        
+        TramaCompacta trama;
+        if (!decodificarTramaBinaria(bufferLectura + posicion, bytes, trama)) return -1;
+        posicion += bytes;
+        validas++;
+    }
+    return 1;
+}
+
+bool SerialReader::extraerTramaBinaria(const char*& trama, int& longitud) {
+    while (inicioDatos < finDatos) {
+        unsigned char etiqueta = static_cast<unsigned char>(bufferLectura[inicioDatos]);
+        int bytes = longitudTramaBinaria(etiqueta);
+        
+        // Byte fuera de trama: descartarlo y buscar la siguiente etiqueta
+        if (bytes == 0) {
+            // En MODO_AUTO una trama de texto entre tramas vuelve al formato de texto
+            if (modo == MODO_AUTO) {
+                char c = bufferLectura[inicioDatos];
+                if ((c == 'L' || c == 'l' || c == 'M' || c == 'm') && inicioDatos + 1 == finDatos) return false;
+                if (empiezaTramaTexto(inicioDatos)) {
+                    binarioDetectado = false;
+                    return false;
+                }
+            }
+            inicioDatos++;
             continue;
         }
         
-        // Verificar fin de línea
-        if (c == '\n' || c == '\r') {
-            if (pos > 0) {
-                buffer[pos] = '\0';
-                return true;
-            }
-            // Ignorar líneas vacías
-        } else {
-            buffer[pos++] = c;
+        if (finDatos - inicioDatos < bytes) return false;
+        
+        // Una etiqueta dentro de la carga indica una trama cortada
+        int i = 1;
+        while (i < bytes && !esEtiquetaBinaria(bufferLectura[inicioDatos + i])) i++;
+        if (i < bytes) {
+            inicioDatos += i;
+            continue;
+        }
+        
+        if (etiqueta == ETIQUETA_SINCRONIA) {
+            inicioDatos++;
+            continue;
+        }
+        
+        trama = bufferLectura + inicioDatos;
+        longitud = bytes;
+        inicioDatos += bytes;
+        return true;
+    }
+    
+    return false;
+}
+
+bool SerialReader::extraerLinea(const char*& linea, int& longitud) {
+    if (esBinario()) {
+        if (extraerTramaBinaria(linea, longitud)) return true;
+        
+        // Sigue en binario esperando datos, salvo que MODO_AUTO haya vuelto a texto
+        if (esBinario()) return false;
+    }
+    
+    // Ignorar líneas vacías
+    while (inicioDatos < finDatos &&
+           (bufferLectura[inicioDatos] == '\n' || bufferLectura[inicioDatos] == '\r')) {
+        inicioDatos++;
+    }
+    
+    // Detección automática: bytes altos al inicio de línea solo cambian de
+    // formato si forman tramas binarias válidas; si no, son ruido y se saltan
+    if (modo == MODO_AUTO && inicioDatos < finDatos && esEtiquetaBinaria(bufferLectura[inicioDatos])) {
+        int confirmacion = confirmarBinario();
+        if (confirmacion == 0) return false;
+        if (confirmacion > 0) {
+            binarioDetectado = true;
+            return extraerTramaBinaria(linea, longitud);
+        }
+        while (inicioDatos < finDatos && esEtiquetaBinaria(bufferLectura[inicioDatos])) inicioDatos++;
+        while (inicioDatos < finDatos &&
+               (bufferLectura[inicioDatos] == '\n' || bufferLectura[inicioDatos] == '\r')) {
+            inicioDatos++;
+        }
+    }
+    
+    int pendientes = finDatos - inicioDatos;
+    if (pendientes == 0) return false;
+    
+    const char* inicio = bufferLectura + inicioDatos;
+    
+    // Buscar el fin de línea ('\n' o '\r', lo que aparezca primero)
+    const char* fin = static_cast<const char*>(std::memchr(inicio, '\n', pendientes));
+    int alcance = (fin != nullptr) ? static_cast<int>(fin - inicio) : pendientes;
+    const char* retorno = static_cast<const char*>(std::memchr(inicio, '\r', alcance));
+    if (retorno != nullptr) fin = retorno;
+    
+    if (fin != nullptr) {
+        linea = inicio;
+        longitud = static_cast<int>(fin - inicio);
+        inicioDatos += longitud + 1;
+        return true;
+    }
+    
+    if (pendientes == TAMANO_BUFFER_SERIAL) {
+        // Buffer lleno sin fin de línea: entregar lo que hay
+        linea = inicio;
+        longitud = pendientes;
+        inicioDatos = finDatos;
+        return true;
+    }
+    
+    return false;
+}
+
+bool SerialReader::leerLineaVista(const char*& linea, int& longitud) {
+    if (!conectado || puerto < 0) return false;
+    
+    // Leer hasta tener una línea completa; sin datos (puerto no bloqueante)
+    // se espera en poll() en lugar de girar sobre read()
+    while (!extraerLinea(linea, longitud)) {
+        int leidos = leerDisponible();
+        if (leidos < 0) return false;
+        if (leidos == 0) {
+            struct pollfd vigilado;
+            vigilado.fd = puerto;
+            vigilado.events = POLLIN;
+            vigilado.revents = 0;
+            if (poll(&vigilado, 1, -1) < 0 && errno != EINTR) return false;
+            
+            // Colgado sin datos pendientes: no llegará la línea
+            if ((vigilado.revents & (POLLHUP | POLLERR | POLLNVAL)) && !(vigilado.revents & POLLIN)) return false;
         }
     }
     
-    // Buffer lleno
-    buffer[pos] = '\0';
-    return pos > 0;
+    return true;
+}
+
+bool SerialReader::setNoBloqueante(bool activar) {
+    if (puerto < 0) return false;
+    
+    int banderas = fcntl(puerto, F_GETFL, 0);
+    if (banderas < 0) return false;
+    
+    banderas = activar ? (banderas | O_NONBLOCK) : (banderas & ~O_NONBLOCK);
+    return fcntl(puerto, F_SETFL, banderas) == 0;
+}
+
+bool SerialReader::leerLinea(char* buffer, int maxLen) {
+    const char* linea;
+    int longitud;
+    
+    if (!leerLineaVista(linea, longitud)) return false;
+    
+    // Si no cabe en el buffer, copiar lo que quepa y dejar el resto de la
+    // línea pendiente para la siguiente llamada
+    if (longitud > maxLen - 1) {
+        if (!esBinario()) inicioDatos = static_cast<int>(linea - bufferLectura) + (maxLen - 1);
+        longitud = maxLen - 1;
+    }
+    std::memcpy(buffer, linea, longitud);
+    buffer[longitud] = '\0';
+    
+    return longitud > 0;
 }
 
 void SerialReader::cerrar() {
@@ -132,5 +351,7 @@ void SerialReader::cerrar() {
         close(puerto);
         puerto = -1;
         conectado = false;
+        inicioDatos = 0;
+        finDatos = 0;
     }
 }
\ No newline at end of file
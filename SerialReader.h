@@ -11,18 +11,82 @@
 #include <fcntl.h>
 #include <termios.h>
 #include <unistd.h>
+#include "ConfiguracionSerial.h"
+
+/**
+ * @brief Capacidad del buffer interno de lectura de SerialReader
+ */
+const int TAMANO_BUFFER_SERIAL = 4096;
+
+/**
+ * @brief Tramas binarias válidas seguidas que confirman el formato binario en MODO_AUTO (sin sincronía)
+ */
+const int TRAMAS_CONFIRMACION_BINARIO = 4;
+
+/**
+ * @brief Formato de las tramas que entrega SerialReader
+ */
+enum ModoTrama {
+    MODO_AUTO,    ///< Texto hasta que llega la sincronía o varias tramas binarias seguidas
+    MODO_TEXTO,   ///< Líneas "L,A" / "M,5" terminadas en fin de línea
+    MODO_BINARIO  ///< Tramas binarias de FormatoBinario.h
+};
 
 /**
  * @class SerialReader
  * @brief Maneja la comunicación con el puerto serial (Arduino) en Linux
  * 
  * Proporciona métodos para conectar y leer datos desde un puerto
- * /dev/ttyUSB0 o /dev/ttyACM0
+ * /dev/ttyUSB0 o /dev/ttyACM0.
+ * 
+ * La lectura es por bloques: cada read() trae todos los bytes disponibles
+ * a un buffer interno y las líneas se separan con memchr, en lugar de
+ * hacer una llamada al sistema por carácter.
+ * 
+ * En modo binario las "líneas" que entregan extraerLinea() y
+ * leerLineaVista() son tramas binarias completas, que parsearTrama()
+ * reconoce por su etiqueta; el resto del programa no cambia.
+ * 
+ * La velocidad puede ser cualquiera que acepte el driver (1M-2M baud en
+ * placas recientes), vía termios2/BOTHER (ver ConfiguracionSerial.h).
  */
 class SerialReader {
 private:
     int puerto;      ///< File descriptor del puerto
     bool conectado;  ///< Estado de la conexión
+    char bufferLectura[TAMANO_BUFFER_SERIAL]; ///< Bytes leídos pendientes de entregar
+    int inicioDatos; ///< Primer byte pendiente en bufferLectura
+    int finDatos;    ///< Fin de los bytes válidos en bufferLectura
+    ModoTrama modo;  ///< Formato configurado
+    bool binarioDetectado; ///< En MODO_AUTO, el flujo se confirmó binario
+    int baudiosEfectivos;  ///< Velocidad que el driver dejó configurada
+    bool bajaLatencia;     ///< El driver aceptó ASYNC_LOW_LATENCY
+    
+    /**
+     * @brief Extrae una trama binaria completa del buffer interno
+     * @param trama Recibe un puntero a la etiqueta dentro del buffer interno
+     * @param longitud Recibe el número de bytes de la trama
+     * @return true si había una trama completa, false si hay que leer más datos
+     * 
+     * Descarta los bytes que no pertenecen a ninguna trama y los de
+     * sincronía, de modo que el flujo se resincroniza en la siguiente etiqueta.
+     */
+    bool extraerTramaBinaria(const char*& trama, int& longitud);
+    
+    /**
+     * @brief En MODO_AUTO, decide si los bytes altos al inicio de línea son un flujo binario
+     * @return 1 si es binario (sincronía o TRAMAS_CONFIRMACION_BINARIO tramas
+     *         válidas seguidas), 0 si faltan datos para decidir, -1 si es ruido
+     * 
+     * Un solo byte >= 0x80 (ruido de línea, un byte UTF-8) no basta para
+     * cambiar de formato.
+     */
+    int confirmarBinario() const;
+    
+    /**
+     * @brief Indica si en la posición indicada empieza una trama de texto ("L," / "M,")
+     */
+    bool empiezaTramaTexto(int posicion) const;
     
 public:
     /**
@@ -43,16 +107,83 @@ public:
      */
     bool conectar(const char* nombrePuerto, int baudRate = 9600);
     
+    /**
+     * @brief Conecta al puerto serial con velocidad, VMIN/VTIME y latencia elegidos
+     * @param nombrePuerto Nombre del puerto (ej: "/dev/ttyUSB0")
+     * @param configuracion Parámetros del puerto
+     * @return true si la conexión fue exitosa, false en caso contrario
+     * 
+     * Falla si los parámetros están fuera de rango o el driver rechaza la
+     * velocidad. Si el driver no admite baja latencia solo se avisa (ver
+     * getBajaLatencia()). La velocidad final se consulta con getBaudios().
+     */
+    bool conectar(const char* nombrePuerto, const ConfiguracionSerial& configuracion);
+    
     /**
      * @brief Lee una línea del puerto serial
      * @param buffer Buffer donde se almacenará la línea leída
      * @param maxLen Tamaño máximo del buffer
      * @return true si se leyó una línea completa, false si hubo error
      * 
-     * Lee hasta encontrar '\n' o hasta llenar el buffer
+     * Lee hasta encontrar '\n' o hasta llenar el buffer. Si la línea no cabe,
+     * el resto se entrega en la siguiente llamada.
      */
     bool leerLinea(char* buffer, int maxLen);
     
+    /**
+     * @brief Lee una línea sin copiarla
+     * @param linea Recibe un puntero al inicio de la línea dentro del buffer interno
+     * @param longitud Recibe el número de caracteres de la línea (sin '\r' ni '\n')
+     * @return true si se obtuvo una línea, false si hubo error
+     * 
+     * IMPORTANTE: La línea no termina en '\0' y solo es válida hasta la
+     * siguiente llamada a leerLinea() o leerLineaVista(). Una línea más
+     * larga que TAMANO_BUFFER_SERIAL se entrega en pedazos.
+     */
+    bool leerLineaVista(const char*& linea, int& longitud);
+    
+    /**
+     * @brief Lee del puerto todos los bytes disponibles que quepan en el buffer interno
+     * @return Bytes leídos (0 si no había datos o el buffer está lleno), o -1
+     *         si hubo error o desconexión (read() devolvió 0)
+     * 
+     * Antes de leer mueve los bytes pendientes al inicio del buffer.
+     * Pensado para usarse con BucleEventos: una llamada por cada EVENTO_DATOS
+     * y luego extraerLinea() hasta que devuelva false.
+     */
+    int leerDisponible();
+    
+    /**
+     * @brief Extrae una línea completa del buffer interno sin leer del puerto
+     * @param linea Recibe un puntero al inicio de la línea dentro del buffer interno
+     * @param longitud Recibe el número de caracteres de la línea
+     * @return true si había una línea completa, false si hay que leer más datos
+     * 
+     * Misma validez que leerLineaVista(): hasta la siguiente lectura
+     */
+    bool extraerLinea(const char*& linea, int& longitud);
+    
+    /**
+     * @brief Activa o desactiva el modo no bloqueante (O_NONBLOCK) del puerto
+     * @param activar true para que read() nunca bloquee
+     * @return true si se pudo cambiar el modo
+     * 
+     * Necesario para usar el puerto con BucleEventos
+     */
+    bool setNoBloqueante(bool activar);
+    
+    /**
+     * @brief Selecciona el formato de las tramas
+     * @param nuevoModo MODO_AUTO (por defecto), MODO_TEXTO o MODO_BINARIO
+     */
+    void setModo(ModoTrama nuevoModo) { modo = nuevoModo; binarioDetectado = false; }
+    
+    /**
+     * @brief Indica si las tramas se están leyendo en formato binario
+     * @return true en MODO_BINARIO o si MODO_AUTO ya detectó el formato binario
+     */
+    bool esBinario() const { return modo == MODO_BINARIO || (modo == MODO_AUTO && binarioDetectado); }
+    
     /**
      * @brief Cierra la conexión con el puerto
      */
@@ -63,6 +194,24 @@ public:
      * @return true si está conectado, false en caso contrario
      */
     bool estaConectado() const { return conectado; }
+    
+    /**
+     * @brief Obtiene el file descriptor del puerto
+     * @return Descriptor abierto, o -1 si no está conectado
+     */
+    int getDescriptor() const { return puerto; }
+    
+    /**
+     * @brief Obtiene la velocidad que quedó configurada
+     * @return Baudios efectivos (puede diferir de los pedidos si el driver redondea)
+     */
+    int getBaudios() const { return baudiosEfectivos; }
+    
+    /**
+     * @brief Indica si el driver quedó en modo de baja latencia
+     * @return true si se pidió y el driver lo aceptó
+     */
+    bool getBajaLatencia() const { return bajaLatencia; }
 };
 
 #endif // SERIAL_READER_H
\ No newline at end of file
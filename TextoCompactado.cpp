@@ -0,0 +1,130 @@
+/**
+ * @file TextoCompactado.cpp
+ * @brief Implementación de la clase TextoCompactado
+ * @author Eliezer Mores Oyervides
+ */
+
+#include "TextoCompactado.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief Capacidad inicial del buffer en memoria
+ */
+const size_t CAPACIDAD_INICIAL_TEXTO = 4096;
+
+/**
+ * @brief Escribe todos los bytes, reintentando escrituras parciales
+ */
+bool escribirTodo(int descriptor, const char* datos, size_t n) {
+    while (n > 0) {
+        ssize_t escritos = write(descriptor, datos, n);
+        if (escritos < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        datos += escritos;
+        n -= static_cast<size_t>(escritos);
+    }
+    return true;
+}
+
+} // namespace
+
+TextoCompactado::TextoCompactado()
+    : buffer(new char[CAPACIDAD_INICIAL_TEXTO]), usados(0), capacidad(CAPACIDAD_INICIAL_TEXTO),
+      longitud(0), descriptor(-1), fallo(false) {}
+
+TextoCompactado::~TextoCompactado() {
+    if (descriptor >= 0) {
+        escribirPendiente();
+        close(descriptor);
+    }
+    delete[] buffer;
+}
+
+bool TextoCompactado::derramarEn(const char* ruta) {
+    int nuevo = open(ruta, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (nuevo < 0) {
+        std::cerr << "Error: No se pudo abrir el archivo de derrame " << ruta << ": "
+                  << std::strerror(errno) << std::endl;
+        return false;
+    }
+    if (descriptor >= 0) {
+        escribirPendiente();
+        close(descriptor);
+    }
+    descriptor = nuevo;
+    
+    // Lo que ya estaba en memoria va al archivo y el buffer vuelve a su tamaño fijo
+    escribirPendiente();
+    if (capacidad != BYTES_BUFFER_DERRAME) {
+        delete[] buffer;
+        buffer = new char[BYTES_BUFFER_DERRAME];
+        capacidad = BYTES_BUFFER_DERRAME;
+    }
+    return !fallo;
+}
+
+void TextoCompactado::escribirPendiente() {
+    if (usados == 0) return;
+    if (!escribirTodo(descriptor, buffer, usados) && !fallo) {
+        std::cerr << "Error: No se pudo escribir el archivo de derrame: " << std::strerror(errno) << std::endl;
+        fallo = true;
+    }
+    usados = 0;
+}
+
+void TextoCompactado::agregar(const char* datos, size_t n) {
+    longitud += static_cast<long>(n);
+    if (descriptor >= 0) {
+        while (n > 0) {
+            size_t copiar = capacidad - usados;
+            if (copiar > n) copiar = n;
+            std::memcpy(buffer + usados, datos, copiar);
+            usados += copiar;
+            datos += copiar;
+            n -= copiar;
+            if (usados == capacidad) escribirPendiente();
+        }
+        return;
+    }
+    
+    if (usados + n > capacidad) {
+        size_t nuevaCapacidad = capacidad * 2;
+        while (nuevaCapacidad < usados + n) nuevaCapacidad *= 2;
+        char* nuevo = new char[nuevaCapacidad];
+        std::memcpy(nuevo, buffer, usados);
+        delete[] buffer;
+        buffer = nuevo;
+        capacidad = nuevaCapacidad;
+    }
+    std::memcpy(buffer + usados, datos, n);
+    usados += n;
+}
+
+bool TextoCompactado::escribir(std::ostream& salida) const {
+    if (descriptor >= 0) {
+        // Lo ya derramado se relee por bloques con pread(), sin mover el final del archivo
+        char bloque[8192];
+        off_t desplazamiento = 0;
+        for (;;) {
+            ssize_t leidos = pread(descriptor, bloque, sizeof(bloque), desplazamiento);
+            if (leidos < 0) {
+                if (errno == EINTR) continue;
+                std::cerr << "Error: No se pudo leer el archivo de derrame: " << std::strerror(errno) << std::endl;
+                return false;
+            }
+            if (leidos == 0) break;
+            salida.write(bloque, leidos);
+            desplazamiento += leidos;
+        }
+    }
+    salida.write(buffer, static_cast<std::streamsize>(usados));
+    return !fallo;
+}
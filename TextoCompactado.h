@@ -0,0 +1,98 @@
+/**
+ * @file TextoCompactado.h
+ * @brief Texto decodificado de las tramas que ya salieron de la ventana de ListaDeCarga
+ * @author Eliezer Mores Oyervides
+ * @date 2025
+ */
+
+#ifndef TEXTO_COMPACTADO_H
+#define TEXTO_COMPACTADO_H
+
+#include <cstddef>
+#include <ostream>
+
+/**
+ * @brief Bytes que se acumulan en memoria antes de escribirlos al archivo de derrame
+ */
+const size_t BYTES_BUFFER_DERRAME = 64 * 1024;
+
+/**
+ * @class TextoCompactado
+ * @brief Cadena que solo crece por el final, en memoria o derramada a disco
+ *
+ * En memoria ocupa un byte por carácter (contra los 8 de cada trama en la
+ * lista) y duplica su capacidad al llenarse. Con derramarEn() los
+ * caracteres se juntan en un buffer de BYTES_BUFFER_DERRAME y se escriben
+ * al archivo en bloques, así que la memoria residente queda fija sin
+ * importar cuánto dure la sesión.
+ */
+class TextoCompactado {
+private:
+    char* buffer;       ///< Texto completo (en memoria) o pendiente de escribir (derramado)
+    size_t usados;      ///< Bytes ocupados de buffer
+    size_t capacidad;   ///< Tamaño de buffer
+    long longitud;      ///< Caracteres totales, escritos al archivo o no
+    int descriptor;     ///< Archivo de derrame (-1: todo en memoria)
+    bool fallo;         ///< Falló una escritura al archivo: el texto quedó incompleto
+    
+    /**
+     * @brief Escribe el buffer pendiente al archivo de derrame
+     */
+    void escribirPendiente();
+    
+    // El texto es dueño de su buffer y su archivo: no se copia
+    TextoCompactado(const TextoCompactado&);
+    TextoCompactado& operator=(const TextoCompactado&);
+    
+public:
+    /**
+     * @brief Constructor de un texto vacío en memoria
+     */
+    TextoCompactado();
+    
+    /**
+     * @brief Destructor que libera el buffer y cierra el archivo
+     */
+    ~TextoCompactado();
+    
+    /**
+     * @brief Pasa a guardar el texto en un archivo (se crea o se trunca)
+     * @param ruta Ruta del archivo de derrame
+     * @return false si no se pudo abrir o escribir lo que ya había en memoria
+     */
+    bool derramarEn(const char* ruta);
+    
+    /**
+     * @brief Agrega caracteres al final
+     * @param datos Caracteres a agregar
+     * @param n Número de caracteres
+     */
+    void agregar(const char* datos, size_t n);
+    
+    /**
+     * @brief Escribe el texto completo en un flujo
+     * @param salida Flujo de destino
+     * @return false si no se pudo leer el archivo de derrame
+     */
+    bool escribir(std::ostream& salida) const;
+    
+    /**
+     * @brief Obtiene el número de caracteres
+     * @return Caracteres totales
+     */
+    long getLongitud() const { return longitud; }
+    
+    /**
+     * @brief Obtiene los bytes que ocupa en memoria
+     * @return Capacidad del buffer
+     */
+    size_t getBytesResidentes() const { return capacidad; }
+    
+    /**
+     * @brief Indica si el texto está derramado a disco
+     * @return true si hay archivo de derrame
+     */
+    bool estaDerramado() const { return descriptor >= 0; }
+};
+
+#endif // TEXTO_COMPACTADO_H
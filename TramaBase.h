@@ -8,6 +8,8 @@
 #ifndef TRAMA_BASE_H
 #define TRAMA_BASE_H
 
+#include "TramaCompacta.h"
+
 // Forward declaration
 class RotorDeMapeo;
 
@@ -27,6 +29,12 @@ public:
      * de objetos derivados cuando se eliminan a través de un puntero base
      */
     virtual ~TramaBase() {}
+    
+    /**
+     * @brief Convierte la trama a su representación compacta por valor
+     * @return TramaCompacta equivalente, que es lo que guarda ListaDeCarga
+     */
+    virtual TramaCompacta compactar() const = 0;
 };
 
 #endif // TRAMA_BASE_H
\ No newline at end of file
@@ -0,0 +1,88 @@
+/**
+ * @file TramaCompacta.h
+ * @brief Representación compacta por valor de una trama PRT-7
+ * @author Eliezer Mores Oyervides
+ * @date 2025
+ */
+
+#ifndef TRAMA_COMPACTA_H
+#define TRAMA_COMPACTA_H
+
+/**
+ * @brief Etiqueta que identifica el tipo de una TramaCompacta
+ */
+enum TipoTrama {
+    TRAMA_LOAD = 1, ///< Trama de carga (L,X)
+    TRAMA_MAP = 2   ///< Trama de mapeo (M,N)
+};
+
+/**
+ * @struct TramaCompacta
+ * @brief Trama almacenada por valor: una etiqueta más su carga útil en 8 bytes
+ * 
+ * Sustituye al par "objeto en el heap + puntero polimórfico" dentro de la
+ * lista. El tipo se consulta con la etiqueta y el despacho se hace con
+ * aceptar(), que llama a visitarLoad() o visitarMap() del visitante sin
+ * usar RTTI ni dynamic_cast. TramaLoad y TramaMap siguen disponibles y
+ * se convierten a este formato con TramaBase::compactar().
+ */
+struct TramaCompacta {
+    unsigned char tipo; ///< TRAMA_LOAD o TRAMA_MAP
+    char caracter;      ///< Carácter de una trama LOAD
+    int rotacion;       ///< Rotación de una trama MAP
+    
+    /**
+     * @brief Crea una trama LOAD
+     * @param c Carácter de la trama
+     * @return Trama compacta de tipo TRAMA_LOAD
+     */
+    static TramaCompacta load(char c) {
+        TramaCompacta t;
+        t.tipo = TRAMA_LOAD;
+        t.caracter = c;
+        t.rotacion = 0;
+        return t;
+    }
+    
+    /**
+     * @brief Crea una trama MAP
+     * @param n Número de posiciones a rotar
+     * @return Trama compacta de tipo TRAMA_MAP
+     */
+    static TramaCompacta map(int n) {
+        TramaCompacta t;
+        t.tipo = TRAMA_MAP;
+        t.caracter = 0;
+        t.rotacion = n;
+        return t;
+    }
+    
+    /**
+     * @brief Indica si es una trama LOAD
+     * @return true si el tipo es TRAMA_LOAD
+     */
+    bool esLoad() const { return tipo == TRAMA_LOAD; }
+    
+    /**
+     * @brief Indica si es una trama MAP
+     * @return true si el tipo es TRAMA_MAP
+     */
+    bool esMap() const { return tipo == TRAMA_MAP; }
+    
+    /**
+     * @brief Despacha la trama al visitante según su etiqueta
+     * @param visitante Objeto con visitarLoad(char) y visitarMap(int)
+     */
+    template <typename Visitante>
+    void aceptar(Visitante& visitante) const {
+        if (tipo == TRAMA_LOAD) {
+            visitante.visitarLoad(caracter);
+        } else {
+            visitante.visitarMap(rotacion);
+        }
+    }
+};
+
+static_assert(sizeof(TramaCompacta) == 8, "TramaCompacta debe ocupar 8 bytes");
+
+#endif // TRAMA_COMPACTA_H
@@ -1,10 +1,117 @@
 /**
  * @file Tramas.cpp
- * @brief Implementación de las clases TramaLoad y TramaMap
+ * @brief Implementación de las clases TramaLoad y TramaMap y del parser de tramas
  * @author Eliezer Mores Oyervides
  */
 
 #include "Tramas.h"
+#include "FormatoBinario.h"
+#include <cstring>
 
 // Las tramas ya no tienen método procesar()
 // La lógica de procesamiento está en ListaDeCarga::procesarTramas()
+
+TramaBase* expandirTrama(const TramaCompacta& trama) {
+    if (trama.esLoad()) {
+        return new TramaLoad(trama.caracter);
+    }
+    return new TramaMap(trama.rotacion);
+}
+
+bool parsearTrama(const char* linea, int longitud, TramaCompacta& trama) {
+    // Trama en formato binario (etiqueta con el bit alto)
+    if (longitud > 0 && esEtiquetaBinaria(linea[0])) {
+        return decodificarTramaBinaria(linea, longitud, trama);
+    }
+    
+    const char* fin = linea + longitud;
+    
+    // Eliminar espacios en blanco al inicio
+    while (linea < fin && (*linea == ' ' || *linea == '\t')) linea++;
+    
+    if (linea == fin) return false;
+    
+    char tipo = linea[0];
+    
+    // Buscar la coma
+    const char* coma = linea;
+    while (coma < fin && *coma != ',') coma++;
+    
+    if (coma == fin) {
+        return false;
+    }
+    
+    coma++; // Saltar la coma
+    
+    // Eliminar espacios después de la coma
+    while (coma < fin && (*coma == ' ' || *coma == '\t')) coma++;
+    
+    if (tipo == 'L' || tipo == 'l') {
+        // Trama LOAD
+        if (coma == fin) {
+            return false;
+        }
+        
+        // Manejar "Space" como carácter especial
+        if (fin - coma >= 5 && coma[0] == 'S' && coma[1] == 'p' && coma[2] == 'a' && 
+            coma[3] == 'c' && coma[4] == 'e') {
+            trama = TramaCompacta::load(' ');
+            return true;
+        }
+        
+        trama = TramaCompacta::load(coma[0]);
+        return true;
+    }
+    else if (tipo == 'M' || tipo == 'm') {
+        // Trama MAP
+        int rotacion = 0;
+        
+        // Parsear el número (puede ser negativo)
+        bool negativo = false;
+        if (coma < fin && *coma == '-') {
+            negativo = true;
+            coma++;
+        } else if (coma < fin && *coma == '+') {
+            coma++;
+        }
+        
+        while (coma < fin && *coma >= '0' && *coma <= '9') {
+            rotacion = rotacion * 10 + (*coma - '0');
+            coma++;
+        }
+        
+        if (negativo) rotacion = -rotacion;
+        
+        trama = TramaCompacta::map(rotacion);
+        return true;
+    }
+    
+    return false;
+}
+
+bool leerMarcasTrama(const char* linea, int longitud, MarcasTrama& marcas) {
+    marcas.secuencia = -1;
+    marcas.envioNs = 0;
+    
+    // Las tramas normales no tienen ';': un memchr y listo
+    const char* fin = linea + longitud;
+    const char* campo = static_cast<const char*>(std::memchr(linea, ';', longitud));
+    bool encontradas = false;
+    while (campo != nullptr && fin - campo >= 3) {
+        char nombre = campo[1];
+        const char* digito = campo + 3;
+        if (campo[2] == '=' && (nombre == 's' || nombre == 't') && digito < fin &&
+            *digito >= '0' && *digito <= '9') {
+            unsigned long long valor = 0;
+            while (digito < fin && *digito >= '0' && *digito <= '9') {
+                valor = valor * 10 + static_cast<unsigned long long>(*digito - '0');
+                digito++;
+            }
+            if (nombre == 's') marcas.secuencia = static_cast<long long>(valor);
+            else marcas.envioNs = valor;
+            encontradas = true;
+        }
+        campo = static_cast<const char*>(std::memchr(campo + 1, ';', fin - campo - 1));
+    }
+    return encontradas;
+}
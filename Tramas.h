@@ -10,6 +10,7 @@
 
 #include "TramaBase.h"
 #include "RotorDeMapeo.h"
+#include "FormatoBinario.h"
 
 /**
  * @class TramaLoad
@@ -34,6 +35,12 @@ public:
      * @return Carácter almacenado
      */
     char getCaracter() const { return caracter; }
+    
+    /**
+     * @brief Convierte la trama a formato compacto
+     * @return TramaCompacta de tipo TRAMA_LOAD
+     */
+    TramaCompacta compactar() const { return TramaCompacta::load(caracter); }
 };
 
 /**
@@ -59,6 +66,66 @@ public:
      * @return Número de posiciones a rotar
      */
     int getRotacion() const { return rotacion; }
+    
+    /**
+     * @brief Convierte la trama a formato compacto
+     * @return TramaCompacta de tipo TRAMA_MAP
+     */
+    TramaCompacta compactar() const { return TramaCompacta::map(rotacion); }
 };
 
+/**
+ * @brief Reconstruye un objeto polimórfico a partir de una trama compacta
+ * @param trama Trama compacta
+ * @return Nueva TramaLoad o TramaMap (el llamador debe hacer delete)
+ */
+TramaBase* expandirTrama(const TramaCompacta& trama);
+
+/**
+ * @brief Parsea una línea de trama a su representación compacta
+ * @param linea Línea leída del puerto serial (ej: "L,A" o "M,5"), no necesita '\0'.
+ *              Si empieza con una etiqueta binaria se decodifica como trama
+ *              binaria completa (ver FormatoBinario.h)
+ * @param longitud Número de caracteres de la línea
+ * @param trama Trama resultante (TRAMA_LOAD o TRAMA_MAP)
+ * @return true si la línea es una trama válida, false si hay error
+ */
+bool parsearTrama(const char* linea, int longitud, TramaCompacta& trama);
+
+/**
+ * @brief Verifica si una línea es la señal de finalización del flujo
+ * @param linea Línea leída del puerto serial
+ * @param longitud Número de caracteres de la línea
+ * @return true si la línea empieza con "END" o es la trama binaria de fin
+ *
+ * En línea porque se consulta una vez por cada línea recibida.
+ */
+inline bool esTramaFin(const char* linea, int longitud) {
+    if (longitud == 1 && static_cast<unsigned char>(linea[0]) == ETIQUETA_FIN) return true;
+    return longitud >= 3 && linea[0] == 'E' && linea[1] == 'N' && linea[2] == 'D';
+}
+
+/**
+ * @struct MarcasTrama
+ * @brief Campos opcionales que un emisor de pruebas agrega tras la trama
+ * 
+ * "L,A;s=41;t=123456789" es la trama L,A con número de secuencia 41 y
+ * enviada en el instante 123456789 ns del reloj monótono del sistema
+ * (el mismo de ahoraNs(), así que solo sirve con el emisor en la misma
+ * máquina, como prt7_simulador). parsearTrama() ignora estos campos.
+ */
+struct MarcasTrama {
+    long long secuencia;        ///< ";s=": número de trama del emisor (-1 si no viene)
+    unsigned long long envioNs; ///< ";t=": instante de envío en ns (0 si no viene)
+};
+
+/**
+ * @brief Lee los campos ";s=" y ";t=" de una línea de texto
+ * @param linea Línea recibida (sin fin de línea)
+ * @param longitud Número de caracteres de la línea
+ * @param marcas Marcas leídas (las ausentes quedan en -1 y 0)
+ * @return true si la línea trae al menos una marca
+ */
+bool leerMarcasTrama(const char* linea, int longitud, MarcasTrama& marcas);
+
 #endif // TRAMAS_H
\ No newline at end of file
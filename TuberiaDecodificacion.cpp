@@ -0,0 +1,494 @@
+/**
+ * @file TuberiaDecodificacion.cpp
+ * @brief Implementación de la clase TuberiaDecodificacion
+ * @author Eliezer Mores Oyervides
+ */
+
+#include "TuberiaDecodificacion.h"
+#include "FormatoBinario.h"
+#include "Tramas.h"
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <ostream>
+#include <poll.h>
+
+namespace {
+
+/**
+ * @brief Milisegundos que el lector espera datos antes de revisar la parada
+ */
+const int MS_ESPERA_LECTOR = 100;
+
+/**
+ * @brief Intentos cediendo el CPU antes de que una etapa ociosa duerma
+ */
+const int INTENTOS_ANTES_DE_DORMIR = 64;
+
+/**
+ * @brief Microsegundos que duerme una etapa ociosa entre intentos
+ */
+const int US_PAUSA_ETAPA = 100;
+
+/**
+ * @brief Nombres estables de las colas (se usan como llaves del JSON)
+ */
+const char* const NOMBRES_COLAS[NUM_COLAS_TUBERIA] = { "lineas", "tramas", "salida" };
+
+/**
+ * @brief Espera un turno: primero cede el CPU y, si la espera sigue, duerme un poco
+ */
+void pausar(int& intentos) {
+    if (++intentos < INTENTOS_ANTES_DE_DORMIR) {
+        std::this_thread::yield();
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(US_PAUSA_ETAPA));
+    }
+}
+
+/**
+ * @brief Suma a una métrica que solo escribe un hilo
+ */
+void sumar(std::atomic<long>& metrica, long cantidad) {
+    metrica.store(metrica.load(std::memory_order_relaxed) + cantidad, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Obtiene una posición libre de la cola, esperando si está llena
+ */
+template <typename Lote>
+Lote* esperarEspacio(ColaSPSC<Lote, LOTES_POR_COLA>& cola, EstadisticasCola& estadisticas) {
+    Lote* espacio = cola.espacioLibre();
+    if (espacio != nullptr) return espacio;
+    
+    sumar(estadisticas.esperasLlena, 1);
+    int intentos = 0;
+    while ((espacio = cola.espacioLibre()) == nullptr) pausar(intentos);
+    return espacio;
+}
+
+/**
+ * @brief Obtiene el lote más antiguo de la cola, esperando si está vacía
+ */
+template <typename Lote>
+Lote* esperarLote(ColaSPSC<Lote, LOTES_POR_COLA>& cola) {
+    Lote* lote;
+    int intentos = 0;
+    while ((lote = cola.frente()) == nullptr) pausar(intentos);
+    return lote;
+}
+
+/**
+ * @brief Publica la posición llenada y actualiza las métricas de la cola
+ */
+template <typename Lote>
+void publicarLote(ColaSPSC<Lote, LOTES_POR_COLA>& cola, EstadisticasCola& estadisticas, int elementos) {
+    cola.publicar();
+    long profundidad = static_cast<long>(cola.tamano());
+    sumar(estadisticas.lotes, 1);
+    sumar(estadisticas.elementos, elementos);
+    sumar(estadisticas.sumaProfundidad, profundidad);
+    if (profundidad > estadisticas.profundidadMaxima.load(std::memory_order_relaxed)) {
+        estadisticas.profundidadMaxima.store(profundidad, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Deja un lote de tramas vacío del tipo indicado
+ */
+void prepararLote(LoteTramas& lote, TipoLote tipo, unsigned long long marca) {
+    lote.tipo = tipo;
+    lote.numeroTramas = 0;
+    lote.inicios[0] = 0;
+    lote.cargasOmitidas = 0;
+    lote.rotacionesOmitidas = 0;
+    lote.marcaLectura = marca;
+}
+
+/**
+ * @brief Copia la parte ocupada de un lote de tramas
+ */
+void copiarLote(const LoteTramas& origen, LoteTramas& destino) {
+    int n = origen.numeroTramas;
+    destino.tipo = origen.tipo;
+    destino.numeroTramas = n;
+    std::memcpy(destino.tramas, origen.tramas, n * sizeof(TramaCompacta));
+    std::memcpy(destino.resultados, origen.resultados, n);
+    std::memcpy(destino.inicios, origen.inicios, (n + 1) * sizeof(int));
+    std::memcpy(destino.textos, origen.textos, origen.inicios[n]);
+    destino.marcaLectura = origen.marcaLectura;
+}
+
+} // namespace
+
+EstadisticasCola::EstadisticasCola()
+    : lotes(0), elementos(0), sumaProfundidad(0), profundidadMaxima(0), esperasLlena(0), descartados(0) {}
+
+TuberiaDecodificacion::TuberiaDecodificacion(SerialReader& puerto, ListaDeCarga& listaTramas,
+                                             RotorConfigurable& rotorActivo, CascadaRotores* cascadaActiva,
+                                             MensajeDecodificado& mensajeCompleto, SalidaTramas& salidaConsola,
+                                             DiarioTramas* diarioActivo)
+    : serial(puerto), lista(listaTramas), rotor(rotorActivo), cascada(cascadaActiva), mensaje(mensajeCompleto),
+      salida(salidaConsola), diario(diarioActivo), politica(PRESION_BLOQUEAR), msInactividad(0), ventana(0),
+      colaLineas(new ColaSPSC<LoteLineas, LOTES_POR_COLA>()),
+      colaTramas(new ColaSPSC<LoteTramas, LOTES_POR_COLA>()),
+      colaSalida(new ColaSPSC<LoteTramas, LOTES_POR_COLA>()),
+      iniciada(false), detenido(false), finRecibido(false), desconectado(false), salidaTerminada(false) {}
+
+TuberiaDecodificacion::~TuberiaDecodificacion() {
+    detener();
+    esperar();
+    delete colaLineas;
+    delete colaTramas;
+    delete colaSalida;
+}
+
+bool TuberiaDecodificacion::iniciar(PoliticaPresion politicaSalida, int msSinDatos) {
+    if (iniciada) return false;
+    
+    politica = politicaSalida;
+    msInactividad = msSinDatos;
+    ventana = lista.getVentana();
+    
+    // La salida parte del mensaje que ya había (por ejemplo el recuperado del diario)
+    espejo.omitirAnteriores(mensaje.getDescartados());
+    espejo.agregar(mensaje.getTexto(), mensaje.getLongitud());
+    
+    iniciada = true;
+    hilos[0] = std::thread(&TuberiaDecodificacion::leer, this);
+    hilos[1] = std::thread(&TuberiaDecodificacion::parsear, this);
+    hilos[2] = std::thread(&TuberiaDecodificacion::decodificar, this);
+    hilos[3] = std::thread(&TuberiaDecodificacion::mostrar, this);
+    return true;
+}
+
+void TuberiaDecodificacion::esperar() {
+    for (int i = 0; i < 4; i++) {
+        if (hilos[i].joinable()) hilos[i].join();
+    }
+}
+
+void TuberiaDecodificacion::leer() {
+    struct pollfd vigilado;
+    vigilado.fd = serial.getDescriptor();
+    vigilado.events = POLLIN;
+    
+    const char* linea;
+    int longitud;
+    std::chrono::steady_clock::time_point ultimosDatos = std::chrono::steady_clock::now();
+    bool avisado = false;
+    EstadisticasCola& metricas = estadisticas[COLA_LINEAS];
+    
+    while (!detenido.load(std::memory_order_relaxed)) {
+        // Dormir hasta que haya datos (o revisar la parada periódicamente)
+        int listo = poll(&vigilado, 1, MS_ESPERA_LECTOR);
+        if (listo < 0 && errno == EINTR) continue;
+        if (listo < 0) {
+            desconectado.store(true);
+            break;
+        }
+        if (listo == 0) {
+            // Avisar una sola vez por periodo de inactividad (con steady_clock:
+            // ahoraNs() vale 0 cuando la instrumentación está deshabilitada)
+            if (!avisado && std::chrono::steady_clock::now() - ultimosDatos >=
+                                std::chrono::milliseconds(msInactividad)) {
+                LoteLineas* aviso = esperarEspacio(*colaLineas, metricas);
+                aviso->tipo = LOTE_INACTIVIDAD;
+                aviso->numeroLineas = 0;
+                publicarLote(*colaLineas, metricas, 0);
+                avisado = true;
+            }
+            continue;
+        }
+        
+        unsigned long long marca = ahoraNs();
+        int leidos = serial.leerDisponible();
+        if (leidos < 0) {
+            // read() falló o llegó al fin de archivo: el puerto colgó
+            desconectado.store(true);
+            break;
+        }
+        if (leidos == 0) continue;
+        ultimosDatos = std::chrono::steady_clock::now();
+        avisado = false;
+        
+        // Copiar las líneas completas al lote; uno nuevo cuando no caben
+        LoteLineas* lote = nullptr;
+        while (serial.extraerLinea(linea, longitud)) {
+            if (lote != nullptr && (lote->numeroLineas == TRAMAS_POR_LOTE ||
+                                    lote->inicios[lote->numeroLineas] + longitud > BYTES_POR_LOTE)) {
+                publicarLote(*colaLineas, metricas, lote->numeroLineas);
+                lote = nullptr;
+            }
+            if (lote == nullptr) {
+                lote = esperarEspacio(*colaLineas, metricas);
+                lote->tipo = LOTE_TRAMAS;
+                lote->numeroLineas = 0;
+                lote->inicios[0] = 0;
+                lote->marcaLectura = marca;
+            }
+            int inicio = lote->inicios[lote->numeroLineas];
+            std::memcpy(lote->bytes + inicio, linea, longitud);
+            lote->inicios[++lote->numeroLineas] = inicio + longitud;
+        }
+        if (lote != nullptr) publicarLote(*colaLineas, metricas, lote->numeroLineas);
+    }
+    
+    LoteLineas* fin = esperarEspacio(*colaLineas, metricas);
+    fin->tipo = LOTE_FIN;
+    fin->numeroLineas = 0;
+    publicarLote(*colaLineas, metricas, 0);
+}
+
+void TuberiaDecodificacion::parsear() {
+    EstadisticasCola& metricas = estadisticas[COLA_TRAMAS];
+    bool finVisto = false;
+    long long secuenciaEsperada = -1;
+    
+    for (;;) {
+        LoteLineas* entrada = esperarLote(*colaLineas);
+        TipoLote tipo = entrada->tipo;
+        
+        if (tipo == LOTE_TRAMAS && !finVisto) {
+            LoteTramas* lote = nullptr;
+            for (int i = 0; i < entrada->numeroLineas; i++) {
+                const char* linea = entrada->bytes + entrada->inicios[i];
+                int longitud = entrada->inicios[i + 1] - entrada->inicios[i];
+                
+                if (esTramaFin(linea, longitud)) {
+                    // Lo que siga a END se ignora, como en el bucle de un hilo
+                    finVisto = true;
+                    finRecibido.store(true);
+                    detenido.store(true);
+                    break;
+                }
+                
+                // Ignorar líneas que no sean tramas válidas
+                if (longitud == 0) continue;
+                bool binaria = esEtiquetaBinaria(linea[0]);
+                if (!binaria && linea[0] != 'L' && linea[0] != 'l' && linea[0] != 'M' && linea[0] != 'm') {
+                    continue;
+                }
+                
+                TramaCompacta trama;
+                bool valida;
+                {
+                    MedicionEtapa medicion(ETAPA_PARSEO);
+                    valida = parsearTrama(linea, longitud, trama);
+                }
+                if (!valida) {
+                    contar(CONTADOR_LINEAS_INVALIDAS);
+                    continue;
+                }
+                
+                // Marcas de un emisor de pruebas (prt7_simulador): la latencia se mide al decodificar
+                MarcasTrama marcas;
+                marcas.envioNs = 0;
+                if (instrumentacionActiva() && !binaria && leerMarcasTrama(linea, longitud, marcas) &&
+                    marcas.secuencia >= 0) {
+                    registrarSecuencia(marcas.secuencia, secuenciaEsperada);
+                }
+                
+                // Las tramas binarias se muestran con su equivalente en texto
+                char texto[16];
+                if (binaria) {
+                    longitud = escribirTramaTexto(trama, texto);
+                    linea = texto;
+                }
+                
+                if (lote != nullptr && (lote->numeroTramas == TRAMAS_POR_LOTE ||
+                                        lote->inicios[lote->numeroTramas] + longitud > BYTES_POR_LOTE)) {
+                    publicarLote(*colaTramas, metricas, lote->numeroTramas);
+                    lote = nullptr;
+                }
+                if (lote == nullptr) {
+                    lote = esperarEspacio(*colaTramas, metricas);
+                    prepararLote(*lote, LOTE_TRAMAS, entrada->marcaLectura);
+                }
+                int inicio = lote->inicios[lote->numeroTramas];
+                std::memcpy(lote->textos + inicio, linea, longitud);
+                lote->tramas[lote->numeroTramas] = trama;
+                lote->envios[lote->numeroTramas] = marcas.envioNs;
+                lote->inicios[++lote->numeroTramas] = inicio + longitud;
+            }
+            if (lote != nullptr) publicarLote(*colaTramas, metricas, lote->numeroTramas);
+        } else if (tipo != LOTE_TRAMAS && !(tipo == LOTE_INACTIVIDAD && finVisto)) {
+            LoteTramas* aviso = esperarEspacio(*colaTramas, metricas);
+            prepararLote(*aviso, tipo, entrada->marcaLectura);
+            publicarLote(*colaTramas, metricas, 0);
+        }
+        
+        colaLineas->liberar();
+        if (tipo == LOTE_FIN) break;
+    }
+}
+
+void TuberiaDecodificacion::decodificar() {
+    EstadisticasCola& metricas = estadisticas[COLA_SALIDA];
+    long cargasOmitidas = 0;
+    long rotacionesOmitidas = 0;
+    
+    for (;;) {
+        LoteTramas* entrada = esperarLote(*colaTramas);
+        TipoLote tipo = entrada->tipo;
+        int cargas = 0;
+        
+        for (int i = 0; i < entrada->numeroTramas; i++) {
+            const TramaCompacta& trama = entrada->tramas[i];
+            {
+                MedicionEtapa medicion(ETAPA_INSERCION);
+                lista.insertarAlFinal(trama);
+            }
+            if (diario != nullptr) diario->agregar(trama);
+            
+            MedicionEtapa medicion(ETAPA_ROTOR);
+            if (trama.esLoad()) {
+                char decodificado = (cascada != nullptr) ? cascada->decodificar(trama.caracter)
+                                                         : rotor.getMapeo(trama.caracter);
+                mensaje.agregar(decodificado);
+                entrada->resultados[i] = decodificado;
+                cargas++;
+            } else if (cascada != nullptr) {
+                cascada->rotar(trama.rotacion);
+                entrada->resultados[i] = cascada->getMapeo('A');
+            } else {
+                rotor.rotar(trama.rotacion);
+                entrada->resultados[i] = rotor.getMapeo('A');
+            }
+            contar(CONTADOR_TRAMAS);
+            registrarLatencia(ETAPA_EXTREMO_A_EXTREMO, entrada->marcaLectura);
+            if (entrada->envios[i] != 0) registrarLatencia(ETAPA_DESDE_EMISOR, entrada->envios[i]);
+        }
+        
+        if (entrada->numeroTramas > 0) {
+            // El diario recibe el lote completo; si dejó de escribir, se sigue sin él
+            if (diario != nullptr) {
+                diario->vaciar();
+                if (diario->getFallido()) {
+                    std::cerr << "Error: El diario dejó de escribirse; la sesión sigue sin diario" << std::endl;
+                    diario = nullptr;
+                }
+            }
+            
+            // Con ventana el mensaje completo está en la lista: aquí basta lo de la ventana
+            if (ventana > 0 && mensaje.getLongitud() > 2L * ventana) {
+                mensaje.descartarInicio(lista.getCompactado().cargas - mensaje.getDescartados());
+            }
+        }
+        
+        // Solo la salida puede perder lotes, y nunca los avisos ni el final
+        LoteTramas* destino;
+        if (tipo == LOTE_TRAMAS && politica == PRESION_DESCARTAR) {
+            destino = colaSalida->espacioLibre();
+            if (destino == nullptr) {
+                sumar(metricas.esperasLlena, 1);
+                sumar(metricas.descartados, 1);
+                cargasOmitidas += cargas;
+                rotacionesOmitidas += entrada->numeroTramas - cargas;
+                colaTramas->liberar();
+                continue;
+            }
+        } else {
+            destino = esperarEspacio(*colaSalida, metricas);
+        }
+        
+        copiarLote(*entrada, *destino);
+        destino->cargasOmitidas = cargasOmitidas;
+        destino->rotacionesOmitidas = rotacionesOmitidas;
+        cargasOmitidas = 0;
+        rotacionesOmitidas = 0;
+        publicarLote(*colaSalida, metricas, destino->numeroTramas);
+        
+        colaTramas->liberar();
+        if (tipo == LOTE_FIN) break;
+    }
+}
+
+void TuberiaDecodificacion::mostrar() {
+    for (;;) {
+        LoteTramas* lote = esperarLote(*colaSalida);
+        TipoLote tipo = lote->tipo;
+        
+        if (lote->cargasOmitidas > 0 || lote->rotacionesOmitidas > 0) {
+            // Tras un hueco la copia mostrada sigue desde aquí, con "..."
+            salida.registrarOmitidas(lote->cargasOmitidas, lote->rotacionesOmitidas);
+            espejo.descartarInicio(espejo.getLongitud());
+            espejo.omitirAnteriores(lote->cargasOmitidas);
+        }
+        
+        for (int i = 0; i < lote->numeroTramas; i++) {
+            const TramaCompacta& trama = lote->tramas[i];
+            const char* texto = lote->textos + lote->inicios[i];
+            int longitud = lote->inicios[i + 1] - lote->inicios[i];
+            
+            MedicionEtapa medicion(ETAPA_SALIDA);
+            if (trama.esLoad()) {
+                espejo.agregar(lote->resultados[i]);
+                salida.registrarCarga(texto, longitud, trama.caracter, lote->resultados[i], espejo);
+            } else {
+                salida.registrarRotacion(texto, longitud, trama.rotacion, lote->resultados[i], espejo);
+            }
+        }
+        
+        if (tipo == LOTE_INACTIVIDAD) {
+            char aviso[80];
+            std::snprintf(aviso, sizeof(aviso), "(Sin tramas durante %d s, esperando...)", msInactividad / 1000);
+            salida.avisar(aviso);
+        } else {
+            salida.vaciar();
+        }
+        
+        if (ventana > 0 && espejo.getLongitud() > 2L * ventana) {
+            espejo.descartarInicio(espejo.getLongitud() - ventana);
+        }
+        
+        colaSalida->liberar();
+        if (tipo == LOTE_FIN) break;
+    }
+    salidaTerminada.store(true);
+}
+
+void TuberiaDecodificacion::volcarColas(std::ostream& destino, FormatoVolcado formato) const {
+    if (formato == VOLCADO_JSON) {
+        destino << "{\"colas\": {";
+        for (int c = 0; c < NUM_COLAS_TUBERIA; c++) {
+            const EstadisticasCola& e = estadisticas[c];
+            long lotes = e.lotes.load(std::memory_order_relaxed);
+            destino << (c ? ", " : "") << "\"" << NOMBRES_COLAS[c] << "\": {"
+                    << "\"lotes\": " << lotes
+                    << ", \"elementos\": " << e.elementos.load(std::memory_order_relaxed)
+                    << ", \"profundidad_media\": "
+                    << (lotes ? static_cast<double>(e.sumaProfundidad.load(std::memory_order_relaxed)) / lotes : 0.0)
+                    << ", \"profundidad_max\": " << e.profundidadMaxima.load(std::memory_order_relaxed)
+                    << ", \"capacidad\": " << LOTES_POR_COLA
+                    << ", \"esperas_llena\": " << e.esperasLlena.load(std::memory_order_relaxed)
+                    << ", \"descartados\": " << e.descartados.load(std::memory_order_relaxed) << "}";
+        }
+        destino << "}}" << std::endl;
+        return;
+    }
+    
+    destino << "=== Colas de la tuberia ===" << std::endl;
+    destino << "cola          lotes  elementos  prof.media  prof.max  capacidad  esperas  descartados" << std::endl;
+    for (int c = 0; c < NUM_COLAS_TUBERIA; c++) {
+        const EstadisticasCola& e = estadisticas[c];
+        long lotes = e.lotes.load(std::memory_order_relaxed);
+        char fila[160];
+        std::snprintf(fila, sizeof(fila), "%-8s %10ld %10ld %11.2f %9ld %10ld %8ld %12ld", NOMBRES_COLAS[c], lotes,
+                      e.elementos.load(std::memory_order_relaxed),
+                      lotes ? static_cast<double>(e.sumaProfundidad.load(std::memory_order_relaxed)) / lotes : 0.0,
+                      e.profundidadMaxima.load(std::memory_order_relaxed), static_cast<long>(LOTES_POR_COLA),
+                      e.esperasLlena.load(std::memory_order_relaxed), e.descartados.load(std::memory_order_relaxed));
+        destino << fila << std::endl;
+    }
+    destino << "===========================" << std::endl;
+}
+
+bool TuberiaDecodificacion::parsearPolitica(const char* nombre, PoliticaPresion& politicaLeida) {
+    if (std::strcmp(nombre, "bloquear") == 0) politicaLeida = PRESION_BLOQUEAR;
+    else if (std::strcmp(nombre, "descartar") == 0) politicaLeida = PRESION_DESCARTAR;
+    else return false;
+    return true;
+}
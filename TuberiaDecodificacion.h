@@ -0,0 +1,280 @@
+/**
+ * @file TuberiaDecodificacion.h
+ * @brief Decodificación de un puerto en cuatro hilos: lectura, parseo, decodificación y salida
+ * @author Eliezer Mores Oyervides
+ * @date 2025
+ */
+
+#ifndef TUBERIA_DECODIFICACION_H
+#define TUBERIA_DECODIFICACION_H
+
+#include <atomic>
+#include <iosfwd>
+#include <thread>
+#include "CascadaRotores.h"
+#include "ColaSPSC.h"
+#include "DiarioTramas.h"
+#include "Instrumentacion.h"
+#include "ListaDeCarga.h"
+#include "MensajeDecodificado.h"
+#include "RotorAlfabeto.h"
+#include "SalidaTramas.h"
+#include "SerialReader.h"
+#include "TramaCompacta.h"
+
+/**
+ * @brief Máximo de líneas o tramas por lote
+ */
+const int TRAMAS_POR_LOTE = 64;
+
+/**
+ * @brief Bytes de texto por lote (cabe cualquier línea del SerialReader)
+ */
+const int BYTES_POR_LOTE = TAMANO_BUFFER_SERIAL;
+
+/**
+ * @brief Lotes que caben en cada cola entre dos etapas
+ */
+const size_t LOTES_POR_COLA = 32;
+
+/**
+ * @brief Qué hace el decodificador cuando la cola de salida está llena
+ */
+enum PoliticaPresion {
+    PRESION_BLOQUEAR, ///< Esperar: nada se pierde, pero una consola lenta termina frenando la lectura
+    PRESION_DESCARTAR ///< No mostrar ese lote: la lista, el diario y el mensaje siguen completos
+};
+
+/**
+ * @brief Contenido de un lote
+ */
+enum TipoLote {
+    LOTE_TRAMAS,      ///< Líneas o tramas recibidas
+    LOTE_INACTIVIDAD, ///< Pasó el intervalo de inactividad sin datos
+    LOTE_FIN          ///< Último lote: la etapa que lo recibe lo reenvía y termina
+};
+
+/**
+ * @struct LoteLineas
+ * @brief Líneas crudas de una lectura del puerto (lector → parser)
+ *
+ * Las vistas del SerialReader dejan de ser válidas en la siguiente
+ * lectura, así que el lector copia las líneas al lote.
+ */
+struct LoteLineas {
+    TipoLote tipo;                       ///< Contenido del lote
+    int numeroLineas;                    ///< Líneas del lote
+    int inicios[TRAMAS_POR_LOTE + 1];    ///< Inicio de cada línea en bytes (inicios[numeroLineas] es el final)
+    char bytes[BYTES_POR_LOTE];          ///< Líneas una tras otra, sin fin de línea
+    unsigned long long marcaLectura;     ///< ahoraNs() del read() que trajo las líneas
+};
+
+/**
+ * @struct LoteTramas
+ * @brief Tramas parseadas con el texto para mostrarlas (parser → decodificador → salida)
+ *
+ * El decodificador llena resultados en el mismo lote y lo pasa a la
+ * salida. Si antes descartó lotes de salida, el siguiente que entrega
+ * lleva cuántas tramas se omitieron.
+ */
+struct LoteTramas {
+    TipoLote tipo;                       ///< Contenido del lote
+    int numeroTramas;                    ///< Tramas del lote
+    TramaCompacta tramas[TRAMAS_POR_LOTE]; ///< Tramas en orden de llegada
+    char resultados[TRAMAS_POR_LOTE];    ///< LOAD: carácter decodificado; MAP: a qué se mapea 'A' después
+    int inicios[TRAMAS_POR_LOTE + 1];    ///< Inicio del texto de cada trama (inicios[numeroTramas] es el final)
+    char textos[BYTES_POR_LOTE];         ///< Texto de cada trama ("L,A", "M,-2"), sin '\0'
+    unsigned long long envios[TRAMAS_POR_LOTE]; ///< Marca ";t=" del emisor (0 sin ella o sin instrumentación)
+    long cargasOmitidas;                 ///< LOAD decodificadas sin mostrar antes de este lote
+    long rotacionesOmitidas;             ///< MAP aplicadas sin mostrar antes de este lote
+    unsigned long long marcaLectura;     ///< ahoraNs() del read() que trajo las tramas
+};
+
+/**
+ * @brief Colas entre etapas
+ */
+enum ColaTuberia {
+    COLA_LINEAS, ///< Lector → parser
+    COLA_TRAMAS, ///< Parser → decodificador
+    COLA_SALIDA, ///< Decodificador → salida
+    NUM_COLAS_TUBERIA
+};
+
+/**
+ * @struct EstadisticasCola
+ * @brief Métricas de una cola, escritas solo por su productor
+ *
+ * Son atómicas para poder volcarlas desde otro hilo (SIGUSR1) mientras
+ * la tubería trabaja.
+ */
+struct EstadisticasCola {
+    std::atomic<long> lotes;             ///< Lotes publicados
+    std::atomic<long> elementos;         ///< Líneas o tramas publicadas
+    std::atomic<long> sumaProfundidad;   ///< Suma de la profundidad al publicar (para el promedio)
+    std::atomic<long> profundidadMaxima; ///< Mayor profundidad observada
+    std::atomic<long> esperasLlena;      ///< Veces que el productor encontró la cola llena
+    std::atomic<long> descartados;       ///< Lotes descartados (solo COLA_SALIDA con PRESION_DESCARTAR)
+    
+    /**
+     * @brief Constructor con todo en cero
+     */
+    EstadisticasCola();
+};
+
+/**
+ * @class TuberiaDecodificacion
+ * @brief Modo en tiempo real de un puerto repartido en etapas con colas sin bloqueos
+ *
+ * En el bucle de un solo hilo, una consola lenta frena la lectura del
+ * puerto y el buffer del tty puede desbordarse. Aquí cada etapa tiene su
+ * hilo y las etapas se conectan con ColaSPSC de lotes, que se llenan en
+ * su lugar (sin copiar) y se entregan de una vez:
+ *
+ *   lector (poll + read) → parser → decodificador (rotor, lista, diario) → salida
+ *
+ * El lector, el parser y el decodificador nunca pierden tramas: si la
+ * cola siguiente está llena esperan. Solo la cola de salida aplica la
+ * PoliticaPresion. El mensaje completo lo arma el decodificador; la
+ * salida lleva su propia copia para mostrarlo, que tras un descarte
+ * continúa con "...".
+ *
+ * Ejemplo:
+ * @code
+ * TuberiaDecodificacion tuberia(serial, lista, rotor, nullptr, mensaje, salida, nullptr);
+ * tuberia.iniciar(PRESION_DESCARTAR, 5000);
+ * while (!tuberia.terminada()) { ... atender señales ... }
+ * tuberia.esperar();
+ * @endcode
+ */
+class TuberiaDecodificacion {
+private:
+    SerialReader& serial;         ///< Puerto, en modo no bloqueante (solo el lector)
+    ListaDeCarga& lista;          ///< Lista de tramas (solo el decodificador)
+    RotorConfigurable& rotor;     ///< Rotor (solo el decodificador)
+    CascadaRotores* cascada;      ///< Cascada que reemplaza a rotor (nullptr sin ella)
+    MensajeDecodificado& mensaje; ///< Mensaje completo (solo el decodificador)
+    SalidaTramas& salida;         ///< Salida en consola (solo la etapa de salida)
+    DiarioTramas* diario;         ///< Diario en disco (nullptr sin --diario o tras un fallo de escritura)
+    MensajeDecodificado espejo;   ///< Copia del mensaje que muestra la etapa de salida
+    PoliticaPresion politica;     ///< Qué hacer con la cola de salida llena
+    int msInactividad;            ///< Milisegundos sin datos antes de avisar
+    int ventana;                  ///< Ventana de la lista (0: sin ventana), para recortar los mensajes
+    
+    ColaSPSC<LoteLineas, LOTES_POR_COLA>* colaLineas; ///< Lector → parser
+    ColaSPSC<LoteTramas, LOTES_POR_COLA>* colaTramas; ///< Parser → decodificador
+    ColaSPSC<LoteTramas, LOTES_POR_COLA>* colaSalida; ///< Decodificador → salida
+    EstadisticasCola estadisticas[NUM_COLAS_TUBERIA]; ///< Métricas de cada cola
+    
+    std::thread hilos[4];             ///< Lector, parser, decodificador y salida
+    bool iniciada;                    ///< Los hilos se arrancaron
+    std::atomic<bool> detenido;       ///< El lector debe dejar de leer
+    std::atomic<bool> finRecibido;    ///< Llegó la trama END
+    std::atomic<bool> desconectado;   ///< El puerto se cerró o falló
+    std::atomic<bool> salidaTerminada; ///< La última etapa ya procesó el lote final
+    
+    /**
+     * @brief Cuerpo del hilo lector
+     */
+    void leer();
+    
+    /**
+     * @brief Cuerpo del hilo parser
+     */
+    void parsear();
+    
+    /**
+     * @brief Cuerpo del hilo decodificador
+     */
+    void decodificar();
+    
+    /**
+     * @brief Cuerpo del hilo de salida
+     */
+    void mostrar();
+    
+    // La tubería es dueña de sus hilos y colas: no se copia
+    TuberiaDecodificacion(const TuberiaDecodificacion&);
+    TuberiaDecodificacion& operator=(const TuberiaDecodificacion&);
+    
+public:
+    /**
+     * @brief Constructor
+     * @param puerto Puerto ya conectado y en modo no bloqueante
+     * @param listaTramas Lista donde se guardan las tramas (puede traer una sesión recuperada)
+     * @param rotorActivo Rotor que decodifica las tramas LOAD
+     * @param cascadaActiva Cascada que reemplaza al rotor (nullptr sin ella)
+     * @param mensajeCompleto Mensaje ensamblado (puede traer el de una sesión recuperada)
+     * @param salidaConsola Salida donde se muestran las tramas
+     * @param diarioActivo Diario en disco (nullptr sin --diario)
+     *
+     * Mientras la tubería trabaja, ningún otro hilo debe tocar estos objetos.
+     */
+    TuberiaDecodificacion(SerialReader& puerto, ListaDeCarga& listaTramas, RotorConfigurable& rotorActivo,
+                          CascadaRotores* cascadaActiva, MensajeDecodificado& mensajeCompleto,
+                          SalidaTramas& salidaConsola, DiarioTramas* diarioActivo);
+    
+    /**
+     * @brief Destructor que detiene y espera los hilos
+     */
+    ~TuberiaDecodificacion();
+    
+    /**
+     * @brief Arranca las cuatro etapas
+     * @param politicaSalida Qué hacer cuando la salida no alcanza al decodificador
+     * @param msSinDatos Milisegundos sin datos tras los cuales se avisa inactividad
+     * @return false si ya se había iniciado
+     */
+    bool iniciar(PoliticaPresion politicaSalida, int msSinDatos);
+    
+    /**
+     * @brief Pide al lector que deje de leer; las demás etapas vacían sus colas y terminan
+     */
+    void detener() { detenido.store(true); }
+    
+    /**
+     * @brief Espera a que terminen todos los hilos
+     */
+    void esperar();
+    
+    /**
+     * @brief Indica si la última etapa terminó (END, desconexión o detener())
+     * @return true si ya se puede llamar a esperar() sin bloquear
+     */
+    bool terminada() const { return salidaTerminada.load(); }
+    
+    /**
+     * @brief Indica si el emisor envió END
+     * @return true si la tubería terminó por la trama END
+     */
+    bool getFinRecibido() const { return finRecibido.load(); }
+    
+    /**
+     * @brief Indica si se perdió el puerto
+     * @return true si la tubería terminó por desconexión o error de lectura
+     */
+    bool getDesconectado() const { return desconectado.load(); }
+    
+    /**
+     * @brief Obtiene las métricas de una cola
+     * @param cola Cola consultada
+     * @return Estadísticas (se pueden leer mientras la tubería trabaja)
+     */
+    const EstadisticasCola& getEstadisticas(ColaTuberia cola) const { return estadisticas[cola]; }
+    
+    /**
+     * @brief Escribe la profundidad y las esperas de cada cola
+     * @param destino Flujo de salida
+     * @param formato VOLCADO_TEXTO o VOLCADO_JSON
+     */
+    void volcarColas(std::ostream& destino, FormatoVolcado formato) const;
+    
+    /**
+     * @brief Convierte un nombre de política ("bloquear", "descartar")
+     * @param nombre Nombre de la política
+     * @param politicaLeida Política resultante
+     * @return true si el nombre es válido
+     */
+    static bool parsearPolitica(const char* nombre, PoliticaPresion& politicaLeida);
+};
+
+#endif // TUBERIA_DECODIFICACION_H
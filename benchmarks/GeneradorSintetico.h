@@ -0,0 +1,117 @@
+/**
+ * @file GeneradorSintetico.h
+ * @brief Flujos de tramas sintéticas y utilidades comunes de los benchmarks
+ * @author Eliezer Mores Oyervides
+ * @date 2025
+ *
+ * Todos los benchmarks generan sus tramas con el mismo generador lineal
+ * congruente, así los flujos son reproducibles entre plataformas y entre
+ * ejecuciones. Cada benchmark elige la semilla, cada cuántas tramas hay una
+ * MAP, la magnitud de las rotaciones y los caracteres de las LOAD.
+ */
+
+#ifndef GENERADOR_SINTETICO_H
+#define GENERADOR_SINTETICO_H
+
+#include "TramaCompacta.h"
+#include <chrono>
+#include <cstring>
+
+/**
+ * @brief Letras mayúsculas, el alfabeto por defecto
+ */
+const char CARACTERES_LETRAS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+/**
+ * @brief Letras, minúsculas, espacio y dígitos: caracteres propios y ajenos del rotor
+ */
+const char CARACTERES_MEZCLA[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz 0123456789";
+
+/**
+ * @brief Todo el ASCII imprimible, para que cada alfabeto vea caracteres propios y ajenos
+ */
+const char CARACTERES_IMPRIMIBLES[] =
+    " !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~";
+
+/**
+ * @struct FlujoSintetico
+ * @brief Generador reproducible de tramas LOAD y MAP
+ */
+struct FlujoSintetico {
+    unsigned int semilla;   ///< Estado del generador lineal congruente
+    int cadaMap;            ///< En promedio una trama MAP de cada cadaMap
+    int magnitud;           ///< Las rotaciones van de -magnitud a +magnitud
+    const char* caracteres; ///< Caracteres de las tramas LOAD
+    int numeroCaracteres;   ///< Número de caracteres
+    
+    /**
+     * @brief Crea el flujo
+     * @param semillaInicial Semilla del generador
+     * @param unaMapCada Una trama MAP de cada unaMapCada (en promedio)
+     * @param magnitudMaxima Magnitud máxima de las rotaciones
+     * @param juego Caracteres de las tramas LOAD (por ejemplo CARACTERES_LETRAS)
+     */
+    FlujoSintetico(unsigned int semillaInicial, int unaMapCada, int magnitudMaxima, const char* juego)
+        : semilla(semillaInicial), cadaMap(unaMapCada), magnitud(magnitudMaxima), caracteres(juego),
+          numeroCaracteres(static_cast<int>(std::strlen(juego))) {}
+    
+    /**
+     * @brief Siguiente número pseudoaleatorio (24 bits)
+     */
+    unsigned int aleatorio() {
+        semilla = semilla * 1103515245u + 12345u;
+        return semilla >> 8;
+    }
+    
+    /**
+     * @brief Siguiente trama del flujo
+     */
+    TramaCompacta siguiente() {
+        unsigned int r = aleatorio();
+        if (r % cadaMap == 0) {
+            return TramaCompacta::map(static_cast<int>((r >> 4) % (2 * magnitud + 1)) - magnitud);
+        }
+        return TramaCompacta::load(caracteres[(r >> 4) % numeroCaracteres]);
+    }
+    
+    /**
+     * @brief Llena un arreglo con las n tramas siguientes
+     */
+    void llenar(TramaCompacta* tramas, long n) {
+        for (long i = 0; i < n; i++) tramas[i] = siguiente();
+    }
+};
+
+/**
+ * @brief Trama i de un flujo fijo que no depende de una semilla (una MAP cada diez)
+ */
+inline TramaCompacta tramaPorIndice(long i) {
+    if (i % 10 == 0) return TramaCompacta::map(static_cast<int>(i % 7) - 3);
+    return TramaCompacta::load(static_cast<char>('A' + i % 26));
+}
+
+/**
+ * @brief Decodifica todo el flujo y devuelve una suma de control
+ * @param rotor Cualquier tipo con rotar(int) y getMapeo(char)
+ */
+template <typename Rotor>
+unsigned long sumaDeControl(Rotor& rotor, const TramaCompacta* tramas, long n) {
+    unsigned long suma = 0;
+    for (long i = 0; i < n; i++) {
+        if (tramas[i].esMap()) {
+            rotor.rotar(tramas[i].rotacion);
+        } else {
+            suma = suma * 31 + static_cast<unsigned char>(rotor.getMapeo(tramas[i].caracter));
+        }
+    }
+    return suma;
+}
+
+/**
+ * @brief Segundos transcurridos desde una marca
+ */
+inline double segundosDesde(std::chrono::steady_clock::time_point inicio) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+}
+
+#endif // GENERADOR_SINTETICO_H
@@ -0,0 +1,213 @@
+/**
+ * @file bench_alfabetos.cpp
+ * @brief Rotores especializados por alfabeto contra el código genérico
+ * @author Eliezer Mores Oyervides
+ *
+ * Para cada alfabeto decodifica el mismo flujo sintético de tramas (90%
+ * LOAD, 10% MAP) con:
+ *  - un rotor genérico que busca el carácter en la cadena del alfabeto y
+ *    aplica el módulo en cada consulta (lo que haría falta para soportar
+ *    otros alfabetos sin tablas);
+ *  - RotorDeMapeo, el rotor actual (solo A-Z);
+ *  - RotorConfigurable, con el alfabeto elegido en tiempo de ejecución;
+ *  - RotorAlfabeto<Alfabeto>, con tablas constexpr y tamaño constante.
+ * Mide también construir un rotor (RotorDeMapeo reserva 26 nodos) y la
+ * decodificación en bloque. Todas las variantes deben dar la misma suma.
+ *
+ * Uso: bench_alfabetos [numeroDeTramas]
+ */
+
+#include "GeneradorSintetico.h"
+#include "RotorAlfabeto.h"
+#include "RotorDeMapeo.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+/**
+ * @brief Rotor genérico: alfabeto en una cadena, búsqueda y módulo por carácter
+ */
+class RotorGenerico {
+private:
+    const char* alfabeto;
+    int tamano;
+    bool plegarMinusculas;
+    int desplazamiento;
+    
+public:
+    RotorGenerico(const char* letras, bool plegar)
+        : alfabeto(letras), tamano(static_cast<int>(std::strlen(letras))),
+          plegarMinusculas(plegar), desplazamiento(0) {}
+    
+    void rotar(int n) {
+        n %= tamano;
+        if (n < 0) n += tamano;
+        desplazamiento = (desplazamiento + n) % tamano;
+    }
+    
+    char getMapeo(char in) const {
+        if (plegarMinusculas && in >= 'a' && in <= 'z') in = in - 'a' + 'A';
+        const void* encontrado = std::memchr(alfabeto, in, tamano);
+        if (encontrado == nullptr) return in;
+        int posicion = static_cast<int>(static_cast<const char*>(encontrado) - alfabeto);
+        return alfabeto[(posicion + desplazamiento) % tamano];
+    }
+};
+
+/**
+ * @brief Mejor de tres pasadas, en ns por trama
+ */
+template <typename Rotor>
+double medir(const Rotor& prototipo, const TramaCompacta* tramas, long n, unsigned long& suma) {
+    double mejor = 1e30;
+    for (int repeticion = 0; repeticion < 3; repeticion++) {
+        Rotor rotor(prototipo);
+        std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+        suma = sumaDeControl(rotor, tramas, n);
+        double t = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - inicio).count();
+        if (t < mejor) mejor = t;
+    }
+    return mejor / n;
+}
+
+/**
+ * @brief RotorDeMapeo no se copia: se mide aparte
+ */
+double medirRotorDeMapeo(const TramaCompacta* tramas, long n, unsigned long& suma) {
+    double mejor = 1e30;
+    for (int repeticion = 0; repeticion < 3; repeticion++) {
+        RotorDeMapeo rotor;
+        std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+        suma = sumaDeControl(rotor, tramas, n);
+        double t = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - inicio).count();
+        if (t < mejor) mejor = t;
+    }
+    return mejor / n;
+}
+
+/**
+ * @brief Compara las variantes de un alfabeto sobre el mismo flujo
+ * @return false si alguna suma no coincide con la del rotor genérico
+ */
+template <typename Alfabeto>
+bool compararAlfabeto(const char* nombre, const char* letras, bool plegar, TipoAlfabeto tipo,
+                      const TramaCompacta* tramas, long n) {
+    unsigned long sumaGenerico, sumaConfigurable, sumaEspecializado, sumaActual = 0;
+    double tGenerico = medir(RotorGenerico(letras, plegar), tramas, n, sumaGenerico);
+    double tConfigurable = medir(RotorConfigurable(tipo), tramas, n, sumaConfigurable);
+    double tEspecializado = medir(RotorAlfabeto<Alfabeto>(), tramas, n, sumaEspecializado);
+    
+    std::printf("%-13s %3d  generico %6.2f", nombre, Alfabeto::TAMANO, tGenerico);
+    bool correcto = sumaConfigurable == sumaGenerico && sumaEspecializado == sumaGenerico;
+    if (tipo == ALFABETO_LETRAS) {
+        double tActual = medirRotorDeMapeo(tramas, n, sumaActual);
+        std::printf("  RotorDeMapeo %6.2f", tActual);
+        correcto = correcto && sumaActual == sumaGenerico;
+    } else {
+        std::printf("  RotorDeMapeo    -  ");
+    }
+    std::printf("  configurable %6.2f  especializado %6.2f ns/trama (%.1fx)\n",
+                tConfigurable, tEspecializado, tGenerico / tEspecializado);
+    return correcto;
+}
+
+/**
+ * @brief Nanosegundos por construcción y destrucción de un rotor
+ */
+template <typename Rotor>
+double medirConstruccion(long repeticiones, unsigned long& suma) {
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    for (long i = 0; i < repeticiones; i++) {
+        Rotor rotor;
+        rotor.rotar(static_cast<int>(i));
+        suma += static_cast<unsigned char>(rotor.getMapeo('A'));
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - inicio).count() / repeticiones;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    long n = (argc > 1) ? std::atol(argv[1]) : 5000000;
+    if (n <= 0) n = 5000000;
+    
+    // Flujo sintético reproducible sobre todo el ASCII imprimible, así cada
+    // alfabeto ve caracteres propios y ajenos
+    TramaCompacta* tramas = new TramaCompacta[n];
+    FlujoSintetico flujo(12345, 10, 100, CARACTERES_IMPRIMIBLES);
+    flujo.llenar(tramas, n);
+    
+    std::cout << n << " tramas (90% LOAD, 10% MAP), mejor de 3 pasadas" << std::endl;
+    bool correcto = true;
+    correcto = compararAlfabeto<AlfabetoLetras>("letras", "ABCDEFGHIJKLMNOPQRSTUVWXYZ", true,
+                                                ALFABETO_LETRAS, tramas, n) && correcto;
+    correcto = compararAlfabeto<AlfabetoDigitos>("digitos", "0123456789", false,
+                                                 ALFABETO_DIGITOS, tramas, n) && correcto;
+    correcto = compararAlfabeto<AlfabetoAlfanumerico>("alfanumerico", "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789", true,
+                                                      ALFABETO_ALFANUMERICO, tramas, n) && correcto;
+    char imprimibles[96];
+    for (int i = 0; i < 95; i++) imprimibles[i] = static_cast<char>(' ' + i);
+    imprimibles[95] = '\0';
+    correcto = compararAlfabeto<AlfabetoImprimible>("imprimible", imprimibles, false,
+                                                    ALFABETO_IMPRIMIBLE, tramas, n) && correcto;
+    
+    // Construcción: RotorDeMapeo reserva y libera 26 nodos
+    const long repeticiones = 1000000;
+    unsigned long sumaConstruccion = 0;
+    double tConstruirActual = medirConstruccion<RotorDeMapeo>(repeticiones, sumaConstruccion);
+    double tConstruirEspecializado = medirConstruccion<RotorAlfabeto<AlfabetoLetras> >(repeticiones, sumaConstruccion);
+    std::printf("construir y destruir: RotorDeMapeo %.1f ns, RotorAlfabeto<AlfabetoLetras> %.1f ns (suma %lu)\n",
+                tConstruirActual, tConstruirEspecializado, sumaConstruccion);
+    
+    // Bloque: kernels SIMD de RotorDeMapeo contra el bucle de tabla especializado
+    const size_t bytes = 1 << 24;
+    char* entrada = new char[bytes];
+    char* salidaActual = new char[bytes];
+    char* salidaEspecializada = new char[bytes];
+    for (size_t i = 0; i < bytes; i++) entrada[i] = static_cast<char>(' ' + i * 7 % 95);
+    RotorAlfabeto<AlfabetoLetras> letras;
+    RotorAlfabeto<AlfabetoImprimible> imprimible;
+    letras.rotar(7);
+    imprimible.rotar(7);
+    
+    // Los buffers se tocan antes para no medir fallos de página
+    std::memset(salidaActual, 0, bytes);
+    std::memset(salidaEspecializada, 0, bytes);
+    double tBloqueActual = 1e30, tBloqueLetras = 1e30, tBloqueImprimible = 1e30;
+    for (int repeticion = 0; repeticion < 3; repeticion++) {
+        std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+        RotorDeMapeo::mapearBloque(entrada, salidaActual, bytes, 7);
+        double t = segundosDesde(inicio);
+        if (t < tBloqueActual) tBloqueActual = t;
+        
+        inicio = std::chrono::steady_clock::now();
+        letras.mapearBloque(entrada, salidaEspecializada, bytes);
+        t = segundosDesde(inicio);
+        if (t < tBloqueLetras) tBloqueLetras = t;
+    }
+    correcto = correcto && std::memcmp(salidaActual, salidaEspecializada, bytes) == 0;
+    for (int repeticion = 0; repeticion < 3; repeticion++) {
+        std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+        imprimible.mapearBloque(entrada, salidaEspecializada, bytes);
+        double t = segundosDesde(inicio);
+        if (t < tBloqueImprimible) tBloqueImprimible = t;
+    }
+    std::printf("bloque de %zu MB: RotorDeMapeo (%s) %.2f GB/s, RotorAlfabeto letras %.2f GB/s, imprimible %.2f GB/s\n",
+                bytes >> 20, RotorDeMapeo::kernelBloque(), bytes / tBloqueActual / 1e9,
+                bytes / tBloqueLetras / 1e9, bytes / tBloqueImprimible / 1e9);
+    
+    delete[] entrada;
+    delete[] salidaActual;
+    delete[] salidaEspecializada;
+    delete[] tramas;
+    
+    if (!correcto) {
+        std::cerr << "Error: las variantes no decodifican igual" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file bench_arena.cpp
+ * @brief Benchmark de inserción y destrucción de ListaDeCarga: heap vs arena
+ * @author Eliezer Mores Oyervides
+ * 
+ * Compara el camino con objetos del heap (new TramaLoad/TramaMap,
+ * insertarAlFinal de su compactar() y delete) con insertarLoad()/insertarMap(), que solo construyen
+ * el nodo en la arena de la lista. Mide por separado la inserción y la
+ * destrucción.
+ * 
+ * Uso: bench_arena [numeroDeTramas]
+ */
+
+#include "ListaDeCarga.h"
+#include "Tramas.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+
+double nsDesde(std::chrono::steady_clock::time_point inicio) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - inicio).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    long n = (argc > 1) ? std::atol(argv[1]) : 5000000;
+    if (n <= 0) n = 5000000;
+    
+    // Camino con objetos del heap: un new por trama además del nodo
+    ListaDeCarga* listaHeap = new ListaDeCarga();
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    for (long i = 0; i < n; i++) {
+        TramaBase* trama;
+        if (i % 10 == 0) {
+            trama = new TramaMap(static_cast<int>(i % 7) - 3);
+        } else {
+            trama = new TramaLoad(static_cast<char>('A' + i % 26));
+        }
+        listaHeap->insertarAlFinal(trama->compactar());
+        delete trama;
+    }
+    double insercionHeap = nsDesde(inicio);
+    inicio = std::chrono::steady_clock::now();
+    delete listaHeap;
+    double destruccionHeap = nsDesde(inicio);
+    
+    // Camino con arena
+    ListaDeCarga* listaArena = new ListaDeCarga();
+    inicio = std::chrono::steady_clock::now();
+    for (long i = 0; i < n; i++) {
+        if (i % 10 == 0) {
+            listaArena->insertarMap(static_cast<int>(i % 7) - 3);
+        } else {
+            listaArena->insertarLoad(static_cast<char>('A' + i % 26));
+        }
+    }
+    double insercionArena = nsDesde(inicio);
+    EstadisticasArena estadisticas = listaArena->getEstadisticasArena();
+    inicio = std::chrono::steady_clock::now();
+    delete listaArena;
+    double destruccionArena = nsDesde(inicio);
+    
+    std::cout << "Tramas: " << n << std::endl;
+    std::cout << "Heap:  insercion " << insercionHeap / n << " ns/trama, destruccion "
+              << destruccionHeap / 1e6 << " ms" << std::endl;
+    std::cout << "Arena: insercion " << insercionArena / n << " ns/trama, destruccion "
+              << destruccionArena / 1e6 << " ms" << std::endl;
+    std::cout << "Arena: " << estadisticas.asignaciones << " asignaciones en "
+              << estadisticas.bloques << " bloques, "
+              << estadisticas.bytesUsados / n << " bytes/trama usados, "
+              << estadisticas.bytesReservados / (1024 * 1024) << " MiB reservados" << std::endl;
+    
+    return 0;
+}
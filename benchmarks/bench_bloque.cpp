@@ -0,0 +1,110 @@
+/**
+ * @file bench_bloque.cpp
+ * @brief Benchmark de RotorDeMapeo::mapearBloque contra getMapeo carácter por carácter
+ * @author Eliezer Mores Oyervides
+ * 
+ * Simula la reproducción de una captura: bloques de caracteres LOAD
+ * separados por rotaciones. Reporta GB/s de ambos caminos y verifica que
+ * el kernel elegido coincida con getMapeo para los 256 valores de byte.
+ * 
+ * Uso: bench_bloque [megabytes] [longitudDeBloque]
+ */
+
+#include "GeneradorSintetico.h"
+#include "RotorDeMapeo.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+/**
+ * @brief Compara mapearBloque con getMapeo en todos los bytes y desplazamientos
+ */
+bool verificarKernel() {
+    char entrada[256 + 7];
+    char salida[256 + 7];
+    for (int i = 0; i < 256 + 7; i++) entrada[i] = static_cast<char>(i);
+    
+    RotorDeMapeo rotor;
+    for (int d = 0; d < TAMANO_ALFABETO; d++) {
+        // El desfase de 7 bytes ejercita también la cola escalar
+        rotor.mapearBloque(entrada, salida, sizeof(entrada));
+        for (int i = 0; i < 256 + 7; i++) {
+            if (salida[i] != rotor.getMapeo(entrada[i])) return false;
+        }
+        rotor.rotar(1);
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    long megas = (argc > 1) ? std::atol(argv[1]) : 64;
+    long bloque = (argc > 2) ? std::atol(argv[2]) : 4096;
+    if (megas <= 0) megas = 64;
+    if (bloque <= 0) bloque = 4096;
+    
+    if (!verificarKernel()) {
+        std::cerr << "ERROR: mapearBloque no coincide con getMapeo" << std::endl;
+        return 1;
+    }
+    
+    const long n = megas * 1024 * 1024;
+    char* entrada = new char[n];
+    char* salidaEscalar = new char[n];
+    char* salidaBloque = new char[n];
+    
+    FlujoSintetico flujo(777, 10, 25, CARACTERES_MEZCLA);
+    for (long i = 0; i < n; i++) entrada[i] = CARACTERES_MEZCLA[flujo.aleatorio() % flujo.numeroCaracteres];
+    
+    // Tocar las páginas de salida para no medir fallos de página
+    std::memset(salidaEscalar, 0, n);
+    std::memset(salidaBloque, 0, n);
+    
+    // Camino carácter por carácter
+    RotorDeMapeo rotorEscalar;
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    for (long i = 0; i < n; i += bloque) {
+        long fin = (i + bloque < n) ? i + bloque : n;
+        for (long j = i; j < fin; j++) salidaEscalar[j] = rotorEscalar.getMapeo(entrada[j]);
+        rotorEscalar.rotar(7);
+    }
+    double tEscalar = segundosDesde(inicio);
+    
+    // Camino en bloque
+    RotorDeMapeo rotorBloque;
+    inicio = std::chrono::steady_clock::now();
+    for (long i = 0; i < n; i += bloque) {
+        long fin = (i + bloque < n) ? i + bloque : n;
+        rotorBloque.mapearBloque(entrada + i, salidaBloque + i, fin - i);
+        rotorBloque.rotar(7);
+    }
+    double tBloque = segundosDesde(inicio);
+    
+    bool iguales = true;
+    for (long i = 0; i < n; i++) {
+        if (salidaEscalar[i] != salidaBloque[i]) {
+            iguales = false;
+            break;
+        }
+    }
+    
+    const double gb = static_cast<double>(n) / 1e9;
+    std::cout << "Datos: " << megas << " MiB, bloques de " << bloque << " tramas LOAD" << std::endl;
+    std::cout << "Kernel de bloque: " << RotorDeMapeo::kernelBloque() << std::endl;
+    std::cout << "getMapeo por caracter: " << gb / tEscalar << " GB/s" << std::endl;
+    std::cout << "mapearBloque:          " << gb / tBloque << " GB/s" << std::endl;
+    
+    delete[] entrada;
+    delete[] salidaEscalar;
+    delete[] salidaBloque;
+    
+    if (!iguales) {
+        std::cerr << "ERROR: los resultados no coinciden" << std::endl;
+        return 1;
+    }
+    return 0;
+}
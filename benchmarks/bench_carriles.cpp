@@ -0,0 +1,237 @@
+/**
+ * @file bench_carriles.cpp
+ * @brief Benchmark del reordenamiento y de la recepción repartida en varios carriles
+ * @author Eliezer Mores Oyervides
+ *
+ * Primero mide BufferReordenamiento solo: las tramas llegan barajadas en
+ * bloques (como las intercala un emisor de varios carriles) y se reporta
+ * el costo por trama y el máximo retenido. También comprueba que un solo
+ * ";s=" corrupto muy adelantado no haga descartar el resto del flujo, y
+ * que un salto real (confirmado por las tramas siguientes) sí se acepte.
+ *
+ * Después abre 1, 2, 4 y 8 pseudo-terminales. Un hilo por carril escribe
+ * "L,X;s=N" a una tasa fija por carril, como un enlace serial de ancho de
+ * banda limitado, y el hilo principal lee todos los carriles con poll() y
+ * SerialReader y los reordena. Con el enlace como cuello de botella el
+ * total de tramas/s debe crecer con los carriles, y el mensaje debe salir
+ * en el orden original.
+ *
+ * Uso: bench_carriles [tramasPorCarril] [tramasPorSegundoPorCarril]
+ */
+
+#include "BufferReordenamiento.h"
+#include "GeneradorSintetico.h"
+#include "SerialReader.h"
+#include "Tramas.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <poll.h>
+#include <thread>
+
+namespace {
+
+/**
+ * @brief Receptor que comprueba que las tramas salen en el orden de secuencia
+ */
+struct VerificadorOrden {
+    long entregadas; ///< Tramas recibidas del buffer
+    long errores;    ///< Tramas cuyo carácter no corresponde a su turno
+    
+    void entregar(const TramaCompacta& trama, unsigned long long) {
+        if (trama.caracter != static_cast<char>('A' + entregadas % 26)) errores++;
+        entregadas++;
+    }
+};
+
+double cpuHilo() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Mide el buffer con secuencias barajadas dentro de bloques de tamaño desorden
+ */
+bool medirBuffer(long n, int desorden) {
+    long long* secuencias = new long long[n];
+    for (long i = 0; i < n; i++) secuencias[i] = i;
+    FlujoSintetico flujo(2025, 10, 25, CARACTERES_LETRAS);
+    for (long inicio = 0; inicio < n; inicio += desorden) {
+        long fin = (inicio + desorden < n) ? inicio + desorden : n;
+        for (long i = fin - 1; i > inicio; i--) {
+            long j = inicio + static_cast<long>(flujo.aleatorio() % static_cast<unsigned int>(i - inicio + 1));
+            long long temporal = secuencias[i];
+            secuencias[i] = secuencias[j];
+            secuencias[j] = temporal;
+        }
+    }
+    
+    BufferReordenamiento reorden(2 * desorden, 1000);
+    VerificadorOrden verificador = { 0, 0 };
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    for (long i = 0; i < n; i++) {
+        reorden.agregar(secuencias[i], TramaCompacta::load(static_cast<char>('A' + secuencias[i] % 26)), 0,
+                        verificador);
+    }
+    double segundos = segundosDesde(inicio);
+    delete[] secuencias;
+    
+    std::printf("Buffer (desorden %5d): %7.2f ns/trama, retenidas max %d\n", desorden, segundos * 1e9 / n,
+                reorden.getEstadisticas().pendientesMaximo);
+    return verificador.entregadas == n && verificador.errores == 0;
+}
+
+/**
+ * @brief Una secuencia corrupta muy adelantada entre tramas válidas no debe desviar el buffer
+ */
+bool verificarSaltoFalso(long n) {
+    BufferReordenamiento reorden;
+    VerificadorOrden verificador = { 0, 0 };
+    reorden.agregar(0, TramaCompacta::load('A'), 0, verificador);
+    reorden.agregar(1, TramaCompacta::load('B'), 0, verificador);
+    bool descartada = !reorden.agregar(9000000001LL, TramaCompacta::load('Z'), 0, verificador);
+    for (long i = 2; i < n; i++) {
+        reorden.agregar(i, TramaCompacta::load(static_cast<char>('A' + i % 26)), 0, verificador);
+    }
+    reorden.vaciar(verificador);
+    const EstadisticasReordenamiento& e = reorden.getEstadisticas();
+    long validas = verificador.entregadas;
+    long descartados = e.saltosDescartados;
+    bool correcto = descartada && validas == n && verificador.errores == 0 && e.atrasadas == 0 &&
+                    e.perdidas == 0 && descartados == 1;
+    
+    // Un salto real: las tramas que siguen lo confirman y el buffer avanza
+    long long base = 1000000000LL;
+    for (int i = 0; i < CONFIRMACIONES_SALTO + 10; i++) {
+        reorden.agregar(base + i, TramaCompacta::load('A'), 0, verificador);
+    }
+    reorden.vaciar(verificador);
+    correcto = correcto && reorden.getSiguiente() == base + CONFIRMACIONES_SALTO + 10;
+    
+    std::printf("Secuencia corrupta: %ld de %ld tramas validas entregadas, %ld saltos descartados, "
+                "salto real %s\n", validas, n, descartados, correcto ? "aceptado" : "NO aceptado");
+    return correcto;
+}
+
+/**
+ * @brief Escribe las tramas de un carril (secuencias carril, carril + carriles, ...) a la tasa pedida
+ */
+void escribirCarril(int maestro, int carril, int carriles, long tramas, long tasa) {
+    const int RAFAGA = 16;
+    char bloque[RAFAGA * 32];
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    std::chrono::nanoseconds periodo(1000000000LL * RAFAGA / tasa);
+    for (long enviadas = 0, rafaga = 0; enviadas < tramas; rafaga++) {
+        std::this_thread::sleep_until(inicio + periodo * rafaga);
+        int usado = 0;
+        for (int i = 0; i < RAFAGA && enviadas < tramas; i++, enviadas++) {
+            long long secuencia = enviadas * carriles + carril;
+            usado += std::snprintf(bloque + usado, sizeof(bloque) - usado, "L,%c;s=%lld\r\n",
+                                   static_cast<char>('A' + secuencia % 26), secuencia);
+        }
+        for (int escrito = 0; escrito < usado;) {
+            ssize_t r = write(maestro, bloque + escrito, usado - escrito);
+            if (r <= 0) return;
+            escrito += static_cast<int>(r);
+        }
+    }
+    ssize_t r = write(maestro, "END\r\n", 5);
+    (void)r;
+}
+
+/**
+ * @brief Recibe los carriles con poll(), los reordena y reporta tramas/s
+ * @return false si faltaron tramas o salieron desordenadas
+ */
+bool medirCarriles(int carriles, long tramasPorCarril, long tasa) {
+    int maestros[8];
+    SerialReader lectores[8];
+    struct pollfd vigilados[8];
+    for (int c = 0; c < carriles; c++) {
+        maestros[c] = posix_openpt(O_RDWR | O_NOCTTY);
+        if (maestros[c] < 0 || grantpt(maestros[c]) != 0 || unlockpt(maestros[c]) != 0 ||
+            !lectores[c].conectar(ptsname(maestros[c]), 115200) || !lectores[c].setNoBloqueante(true)) {
+            std::cerr << "No se pudo crear el pseudo-terminal" << std::endl;
+            return false;
+        }
+        vigilados[c].fd = lectores[c].getDescriptor();
+        vigilados[c].events = POLLIN;
+    }
+    
+    BufferReordenamiento reorden;
+    VerificadorOrden verificador = { 0, 0 };
+    std::thread escritores[8];
+    double cpuInicio = cpuHilo();
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    for (int c = 0; c < carriles; c++) {
+        escritores[c] = std::thread(escribirCarril, maestros[c], c, carriles, tramasPorCarril, tasa);
+    }
+    
+    int activos = carriles;
+    const char* linea;
+    int longitud;
+    while (activos > 0) {
+        if (poll(vigilados, carriles, 1000) <= 0) break;
+        for (int c = 0; c < carriles; c++) {
+            if (vigilados[c].fd < 0 || !(vigilados[c].revents & POLLIN)) continue;
+            if (lectores[c].leerDisponible() < 0) return false;
+            while (lectores[c].extraerLinea(linea, longitud)) {
+                TramaCompacta trama;
+                MarcasTrama marcas;
+                if (esTramaFin(linea, longitud)) {
+                    vigilados[c].fd = -1;
+                    activos--;
+                    break;
+                }
+                if (parsearTrama(linea, longitud, trama) && leerMarcasTrama(linea, longitud, marcas)) {
+                    reorden.agregar(marcas.secuencia, trama, 0, verificador);
+                }
+            }
+        }
+        reorden.vencer(verificador);
+    }
+    reorden.vaciar(verificador);
+    
+    double segundos = segundosDesde(inicio);
+    double cpu = cpuHilo() - cpuInicio;
+    for (int c = 0; c < carriles; c++) {
+        escritores[c].join();
+        lectores[c].cerrar();
+        close(maestros[c]);
+    }
+    
+    std::printf("%d carril(es): %9.0f tramas/s en total, CPU del lector %5.1f%%, retenidas max %d\n", carriles,
+                verificador.entregadas / segundos, 100.0 * cpu / segundos,
+                reorden.getEstadisticas().pendientesMaximo);
+    return verificador.entregadas == carriles * tramasPorCarril && verificador.errores == 0 &&
+           reorden.getEstadisticas().perdidas == 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    long tramasPorCarril = (argc > 1) ? std::atol(argv[1]) : 20000;
+    if (tramasPorCarril <= 0) tramasPorCarril = 20000;
+    long tasa = (argc > 2) ? std::atol(argv[2]) : 20000;
+    if (tasa <= 0) tasa = 20000;
+    
+    bool correcto = medirBuffer(10000000, 1);
+    correcto = medirBuffer(10000000, 64) && correcto;
+    correcto = medirBuffer(10000000, 1024) && correcto;
+    correcto = verificarSaltoFalso(100000) && correcto;
+    
+    std::cout << "Tramas por carril: " << tramasPorCarril << ", tasa por carril: " << tasa
+              << " tramas/s" << std::endl;
+    for (int carriles = 1; carriles <= 8; carriles *= 2) {
+        correcto = medirCarriles(carriles, tramasPorCarril, tasa) && correcto;
+    }
+    
+    if (!correcto) {
+        std::cerr << "ERROR: las tramas no salieron completas y en orden" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,158 @@
+/**
+ * @file bench_cascada.cpp
+ * @brief Cascada de rotores con tablas compuestas contra recorrer k rotores por LOAD
+ * @author Eliezer Mores Oyervides
+ *
+ * Decodifica el mismo flujo sintético (90% LOAD, 10% MAP) con una cascada
+ * directa, que atraviesa los k rotores en cada LOAD, y con CascadaRotores,
+ * que consulta la tabla compuesta en caché. Se mide con solo tramas MAP
+ * moviendo el rotor 0 y con avance tipo odómetro en cada LOAD, para
+ * varios k. Ambas deben dar la misma suma, y una cascada de un rotor con
+ * cableado identidad debe coincidir con RotorDeMapeo.
+ *
+ * Uso: bench_cascada [numeroDeTramas]
+ */
+
+#include "CascadaRotores.h"
+#include "GeneradorSintetico.h"
+#include "RotorDeMapeo.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+
+/**
+ * @brief Cableados de ejemplo (rotores I a VIII de la Enigma)
+ */
+const char* const CABLEADOS[MAX_ROTORES_CASCADA] = {
+    "EKMFLGDQVZNTOWYHXUSPAIBRCJ", "AJDKSIRUXBLHWTMCQGZNPYFVOE", "BDFHJLCPRTXVZNYEIWGAKMUSQO",
+    "ESOVPZJAYQUIRHXLNFTGKDCMWB", "VZBRGITYUPSDNHLXAWMJQOFECK", "JPGVOUMFYQBENHZRDKASXLICTW",
+    "NZJHGRCXMYSWBOUFAIVLPEKQDT", "FKQHTLXOCBJSPDZRAMEWNIUYGV"
+};
+
+/**
+ * @brief Muescas de los mismos rotores
+ */
+const char* const MUESCAS[MAX_ROTORES_CASCADA] = { "Q", "E", "V", "J", "Z", "ZM", "ZM", "ZM" };
+
+/**
+ * @brief Cascada sin caché: atraviesa cada rotor en cada LOAD
+ */
+class CascadaDirecta {
+private:
+    int numeroRotores;
+    int desplazamientos[MAX_ROTORES_CASCADA];
+    char cableados[MAX_ROTORES_CASCADA][256];
+    bool muescas[MAX_ROTORES_CASCADA][TAMANO_ALFABETO];
+    bool avancePorCarga;
+    
+public:
+    CascadaDirecta(int numero, bool avance) : numeroRotores(numero), avancePorCarga(avance) {
+        for (int i = 0; i < numero; i++) {
+            desplazamientos[i] = 0;
+            for (int c = 0; c < 256; c++) cableados[i][c] = static_cast<char>(c);
+            for (int l = 0; l < TAMANO_ALFABETO; l++) {
+                cableados[i]['A' + l] = CABLEADOS[i][l];
+                muescas[i][l] = false;
+            }
+            for (int j = 0; MUESCAS[i][j] != '\0'; j++) muescas[i][MUESCAS[i][j] - 'A'] = true;
+        }
+    }
+    
+    void rotar(int n) {
+        n %= TAMANO_ALFABETO;
+        if (n < 0) n += TAMANO_ALFABETO;
+        desplazamientos[0] = (desplazamientos[0] + n) % TAMANO_ALFABETO;
+    }
+    
+    char decodificar(char in) {
+        unsigned char x = static_cast<unsigned char>(in);
+        for (int i = 0; i < numeroRotores; i++) {
+            x = static_cast<unsigned char>(cableados[i][static_cast<unsigned char>(
+                RotorDeMapeo::obtenerTabla(desplazamientos[i])[x])]);
+        }
+        if (avancePorCarga) {
+            for (int i = 0; i < numeroRotores; i++) {
+                bool arrastra = muescas[i][desplazamientos[i]];
+                desplazamientos[i] = (desplazamientos[i] + 1) % TAMANO_ALFABETO;
+                if (!arrastra) break;
+            }
+        }
+        return static_cast<char>(x);
+    }
+};
+
+/**
+ * @brief Presenta decodificar() (con el avance por carga) como getMapeo() para sumaDeControl()
+ */
+template <typename Cascada>
+struct ConAvance {
+    Cascada& cascada;
+    void rotar(int n) { cascada.rotar(n); }
+    char getMapeo(char in) { return cascada.decodificar(in); }
+};
+
+/**
+ * @brief Compara ambas cascadas con k rotores
+ * @return false si las sumas no coinciden
+ */
+bool comparar(int k, bool avance, const TramaCompacta* tramas, long n) {
+    double tDirecta = 1e30, tCompuesta = 1e30;
+    unsigned long sumaDirecta = 0, sumaCompuesta = 0;
+    long composiciones = 0;
+    for (int repeticion = 0; repeticion < 3; repeticion++) {
+        CascadaDirecta directa(k, avance);
+        ConAvance<CascadaDirecta> decodificadorDirecto = { directa };
+        std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+        sumaDirecta = sumaDeControl(decodificadorDirecto, tramas, n);
+        double t = segundosDesde(inicio);
+        if (t < tDirecta) tDirecta = t;
+        
+        CascadaRotores compuesta;
+        compuesta.definirRotores(k, CABLEADOS, MUESCAS, nullptr, avance);
+        ConAvance<CascadaRotores> decodificadorCompuesto = { compuesta };
+        inicio = std::chrono::steady_clock::now();
+        sumaCompuesta = sumaDeControl(decodificadorCompuesto, tramas, n);
+        t = segundosDesde(inicio);
+        if (t < tCompuesta) tCompuesta = t;
+        composiciones = compuesta.getComposiciones();
+    }
+    std::printf("k=%d %-8s directa %6.2f ns/trama, compuesta %6.2f ns/trama (%.1fx), %ld tablas compuestas\n",
+                k, avance ? "avance" : "MAP", tDirecta / n * 1e9, tCompuesta / n * 1e9,
+                tDirecta / tCompuesta, composiciones);
+    return sumaDirecta == sumaCompuesta;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    long n = (argc > 1) ? std::atol(argv[1]) : 5000000;
+    if (n <= 0) n = 5000000;
+    
+    // Flujo sintético reproducible con letras, minúsculas y otros caracteres
+    TramaCompacta* tramas = new TramaCompacta[n];
+    FlujoSintetico flujo(777, 10, 100, CARACTERES_MEZCLA);
+    flujo.llenar(tramas, n);
+    
+    std::cout << n << " tramas (90% LOAD, 10% MAP), mejor de 3 pasadas" << std::endl;
+    bool correcto = true;
+    const int tamanos[] = { 1, 3, 5, 8 };
+    for (int i = 0; i < 4; i++) correcto = comparar(tamanos[i], false, tramas, n) && correcto;
+    for (int i = 0; i < 4; i++) correcto = comparar(tamanos[i], true, tramas, n) && correcto;
+    
+    // Un rotor con cableado identidad y sin avance es el RotorDeMapeo de siempre
+    RotorDeMapeo simple;
+    CascadaRotores identidad;
+    ConAvance<CascadaRotores> decodificadorIdentidad = { identidad };
+    correcto = sumaDeControl(simple, tramas, n) == sumaDeControl(decodificadorIdentidad, tramas, n) && correcto;
+    
+    delete[] tramas;
+    if (!correcto) {
+        std::cerr << "Error: las cascadas no decodifican igual" << std::endl;
+        return 1;
+    }
+    std::cout << "Ambas cascadas decodifican igual; la identidad coincide con RotorDeMapeo" << std::endl;
+    return 0;
+}
@@ -0,0 +1,175 @@
+/**
+ * @file bench_diario.cpp
+ * @brief Costo por trama del diario en disco y velocidad de recuperación
+ * @author Eliezer Mores Oyervides
+ *
+ * Inserta una sesión sintética en una ListaDeCarga con y sin DiarioTramas
+ * y reporta el costo adicional por trama, la latencia de vaciar() por
+ * lectura simulada (que solo espera si el disco se queda atrás), cuántas
+ * tramas cubre cada fdatasync() y cuánto tardan. Después recupera el diario con mmap,
+ * verifica que la lista y el rotor recuperados decodifican lo mismo, y
+ * corta el último grupo para comprobar que la recuperación lo descarta.
+ *
+ * Uso: bench_diario [tramas] [ruta]
+ */
+
+#include "DiarioTramas.h"
+#include "GeneradorSintetico.h"
+#include "ListaDeCarga.h"
+#include "RotorDeMapeo.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief Tramas por lectura simulada del puerto (una llamada a vaciar() por lectura)
+ */
+const int TRAMAS_POR_LECTURA = 8;
+
+/**
+ * @brief Decodifica una lista completa con un rotor nuevo
+ * @return Rotor final (desplazamiento)
+ */
+int decodificar(ListaDeCarga& lista, char* salida) {
+    RotorDeMapeo rotor;
+    lista.decodificarMensaje(&rotor, salida);
+    return rotor.getDesplazamiento();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int tramas = (argc > 1) ? std::atoi(argv[1]) : 4000000;
+    const char* ruta = (argc > 2) ? argv[2] : "bench_diario.tmp";
+    if (tramas <= 0) tramas = 4000000;
+    
+    // Sesión sintética: una MAP de cada 16, como bench_reproduccion
+    TramaCompacta* sesion = new TramaCompacta[tramas];
+    FlujoSintetico flujo(5, 16, 100, CARACTERES_LETRAS);
+    flujo.llenar(sesion, tramas);
+    
+    // Sin diario
+    double tSinDiario = 1e30;
+    for (int repeticion = 0; repeticion < 3; repeticion++) {
+        ListaDeCarga lista;
+        std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+        for (int i = 0; i < tramas; i++) lista.insertarAlFinal(sesion[i]);
+        double t = segundosDesde(inicio);
+        if (t < tSinDiario) tSinDiario = t;
+    }
+    
+    // Con diario: cada trama se inserta y se agrega al diario, y el lote se
+    // entrega al escritor una vez por lectura, como en tiempo real
+    unlink(ruta);
+    ListaDeCarga original;
+    RotorDeMapeo rotorOriginal;
+    DiarioTramas diario;
+    EstadisticasRecuperacion recuperacion;
+    if (!diario.abrir(ruta, original, rotorOriginal, recuperacion)) return 1;
+    
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    for (int i = 0; i < tramas; i++) {
+        original.insertarAlFinal(sesion[i]);
+        diario.agregar(sesion[i]);
+        if (i % TRAMAS_POR_LECTURA == TRAMAS_POR_LECTURA - 1) diario.vaciar();
+    }
+    double tConDiario = segundosDesde(inicio);
+    diario.sincronizar();
+    double tDuradero = segundosDesde(inicio);
+    
+    // Latencia de una lectura completa: agregar() por trama más vaciar() (incluye leer el reloj)
+    const int muestras = 100000;
+    unsigned long long* latencias = new unsigned long long[muestras];
+    for (int i = 0; i < muestras; i++) {
+        std::chrono::steady_clock::time_point antes = std::chrono::steady_clock::now();
+        for (int j = 0; j < TRAMAS_POR_LECTURA; j++) diario.agregar(sesion[(i * TRAMAS_POR_LECTURA + j) % tramas]);
+        diario.vaciar();
+        latencias[i] = static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - antes).count());
+        for (int j = 0; j < TRAMAS_POR_LECTURA; j++) original.insertarAlFinal(sesion[(i * TRAMAS_POR_LECTURA + j) % tramas]);
+    }
+    std::sort(latencias, latencias + muestras);
+    diario.sincronizar();
+    
+    EstadisticasDiario estadisticas = diario.getEstadisticas();
+    diario.cerrar();
+    
+    std::printf("%d tramas, grupos de hasta %d tramas o %d ms\n", tramas, TRAMAS_POR_GRUPO, MS_POR_GRUPO);
+    std::printf("insertar sin diario:     %6.2f ns/trama\n", tSinDiario / tramas * 1e9);
+    std::printf("insertar con diario:     %6.2f ns/trama (+%.2f), %.2f ns/trama hasta quedar en disco\n",
+                tConDiario / tramas * 1e9, (tConDiario - tSinDiario) / tramas * 1e9, tDuradero / tramas * 1e9);
+    std::printf("lectura de %d tramas:    p50 %llu ns, p99 %llu ns, p99.99 %llu ns, max %llu ns\n",
+                TRAMAS_POR_LECTURA, latencias[muestras / 2], latencias[muestras * 99 / 100],
+                latencias[muestras - muestras / 10000], latencias[muestras - 1]);
+    std::printf("grupos: %ld (%.0f tramas/grupo, %.2f bytes/trama), write+fdatasync promedio %.1f us, max %.1f us\n",
+                estadisticas.grupos, static_cast<double>(estadisticas.tramas) / estadisticas.grupos,
+                static_cast<double>(estadisticas.bytes) / estadisticas.tramas,
+                estadisticas.nsSincronizacion / 1e3 / estadisticas.grupos, estadisticas.maxNsSincronizacion / 1e3);
+    std::printf("esperas por buffer lleno: %ld (pendiente acotado a %zu bytes)\n",
+                estadisticas.esperasLlenas, MAX_BYTES_PENDIENTES);
+    delete[] latencias;
+    
+    // Recuperación
+    char* esperado = new char[original.getTamano() + 1];
+    char* obtenido = new char[original.getTamano() + 1];
+    int desplazamientoEsperado = decodificar(original, esperado);
+    
+    ListaDeCarga recuperada;
+    RotorDeMapeo rotorRecuperado;
+    inicio = std::chrono::steady_clock::now();
+    if (!diario.abrir(ruta, recuperada, rotorRecuperado, recuperacion)) return 1;
+    double tRecuperacion = segundosDesde(inicio);
+    diario.cerrar();
+    
+    decodificar(recuperada, obtenido);
+    bool correcto = recuperada.getTamano() == original.getTamano() &&
+                    std::strcmp(esperado, obtenido) == 0 &&
+                    rotorRecuperado.getDesplazamiento() == desplazamientoEsperado;
+    long tramasOriginal = original.getTamano();
+    std::printf("recuperacion: %ld tramas de %ld grupos en %.1f ms (%.1f M tramas/s)\n",
+                recuperacion.tramas, recuperacion.grupos, tRecuperacion * 1e3,
+                recuperacion.tramas / tRecuperacion / 1e6);
+    
+    // Caída a mitad de un write(): cortar los últimos bytes del último grupo
+    struct stat info;
+    stat(ruta, &info);
+    bool truncado = truncate(ruta, info.st_size - 7) == 0;
+    ListaDeCarga cortada;
+    RotorDeMapeo rotorCortado;
+    if (!diario.abrir(ruta, cortada, rotorCortado, recuperacion)) return 1;
+    diario.cerrar();
+    
+    // Debe quedar exactamente el prefijo de grupos completos
+    char* prefijo = new char[cortada.getTamano() + 1];
+    original.decodificarRango(0, cortada.getTamano(), prefijo);
+    decodificar(cortada, obtenido);
+    bool descartado = truncado && recuperacion.bytesDescartados > 0 &&
+                      recuperacion.tramas < tramasOriginal && recuperacion.tramas > 0 &&
+                      std::strcmp(prefijo, obtenido) == 0;
+    std::printf("grupo cortado: %zu bytes descartados, %ld tramas recuperadas\n",
+                recuperacion.bytesDescartados, recuperacion.tramas);
+    delete[] prefijo;
+    
+    delete[] esperado;
+    delete[] obtenido;
+    delete[] sesion;
+    unlink(ruta);
+    
+    if (!correcto) {
+        std::cerr << "Error: lo recuperado no coincide con lo que se agregó" << std::endl;
+        return 1;
+    }
+    if (!descartado) {
+        std::cerr << "Error: la recuperación no descartó correctamente el grupo cortado" << std::endl;
+        return 1;
+    }
+    std::cout << "La lista y el rotor recuperados coinciden con los originales" << std::endl;
+    return 0;
+}
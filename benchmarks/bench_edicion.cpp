@@ -0,0 +1,126 @@
+/**
+ * @file bench_edicion.cpp
+ * @brief Corrección de tramas cerca de la cabeza de una sesión larga
+ * @author Eliezer Mores Oyervides
+ *
+ * Construye una sesión sintética de 10 millones de tramas y su mensaje
+ * decodificado, y después mide cuánto cuesta corregirlo cuando una trama
+ * cerca de la cabeza llega tarde o se retransmite: con
+ * ListaDeCarga::insertarEn() / eliminarEn() / reemplazarEn() más
+ * MensajeDecodificado::aplicar(), frente a decodificar otra vez toda la
+ * lista (lo único posible antes). Al final verifica que el mensaje
+ * corregido coincide con una decodificación completa.
+ *
+ * Uso: bench_edicion [tramas]
+ */
+
+#include "GeneradorSintetico.h"
+#include "ListaDeCarga.h"
+#include "MensajeDecodificado.h"
+#include "RotorDeMapeo.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+int main(int argc, char* argv[]) {
+    int tramas = (argc > 1) ? std::atoi(argv[1]) : 10000000;
+    if (tramas <= 1000) tramas = 10000000;
+    
+    // Sesión y ediciones reproducibles: una MAP de cada 16, como bench_reproduccion
+    FlujoSintetico flujo(17, 16, 100, CARACTERES_LETRAS);
+    
+    ListaDeCarga lista;
+    for (int i = 0; i < tramas; i++) lista.insertarAlFinal(flujo.siguiente());
+    
+    // Mensaje inicial y costo de la decodificación completa
+    char* completo = new char[tramas + 1024];
+    double tCompleto = 1e30;
+    int longitud = 0;
+    for (int repeticion = 0; repeticion < 3; repeticion++) {
+        std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+        RotorDeMapeo rotor;
+        longitud = lista.decodificarMensaje(&rotor, completo);
+        double t = segundosDesde(inicio);
+        if (t < tCompleto) tCompleto = t;
+    }
+    MensajeDecodificado mensaje(tramas);
+    mensaje.agregar(completo, longitud);
+    
+    std::printf("%d tramas, %d caracteres\n", tramas, longitud);
+    std::printf("%-34s %10.1f us\n", "decodificar toda la lista", tCompleto * 1e6);
+    
+    const int ediciones = 200;
+    CambioMensaje cambio;
+    
+    // Cada caso edita tramas en los primeros 1000 índices; el primero corrige
+    // solo caracteres (LOAD por LOAD), sin tocar el resto del mensaje
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    for (int i = 0; i < ediciones; i++) {
+        int indice = static_cast<int>(flujo.aleatorio() % 1000);
+        int desplazamiento = 0;
+        int cargas = 0;
+        while (lista.buscar(indice, desplazamiento, cargas)->esMap()) indice++;
+        lista.reemplazarEn(indice, TramaCompacta::load(static_cast<char>('A' + flujo.aleatorio() % 26)), &cambio);
+        mensaje.aplicar(cambio);
+    }
+    double tLoad = segundosDesde(inicio) / ediciones;
+    
+    inicio = std::chrono::steady_clock::now();
+    for (int i = 0; i < ediciones; i++) {
+        int indice = static_cast<int>(flujo.aleatorio() % 1000);
+        lista.reemplazarEn(indice, TramaCompacta::map(static_cast<int>(flujo.aleatorio() % 51) - 25), &cambio);
+        mensaje.aplicar(cambio);
+    }
+    double tMap = segundosDesde(inicio) / ediciones;
+    
+    inicio = std::chrono::steady_clock::now();
+    for (int i = 0; i < ediciones; i++) {
+        int indice = static_cast<int>(flujo.aleatorio() % 1000);
+        lista.insertarEn(indice, flujo.siguiente(), &cambio);
+        mensaje.aplicar(cambio);
+    }
+    double tInsercion = segundosDesde(inicio) / ediciones;
+    
+    inicio = std::chrono::steady_clock::now();
+    for (int i = 0; i < ediciones; i++) {
+        int indice = static_cast<int>(flujo.aleatorio() % 1000);
+        lista.eliminarEn(indice, &cambio);
+        mensaje.aplicar(cambio);
+    }
+    double tEliminacion = segundosDesde(inicio) / ediciones;
+    
+    // Consulta del desplazamiento efectivo de un LOAD cualquiera
+    const int consultas = 100000;
+    long suma = 0;
+    inicio = std::chrono::steady_clock::now();
+    for (int i = 0; i < consultas; i++) {
+        int desplazamiento = 0;
+        int cargas = 0;
+        lista.buscar(static_cast<int>(flujo.aleatorio() % static_cast<unsigned int>(lista.getTamano())),
+                     desplazamiento, cargas);
+        suma += desplazamiento;
+    }
+    double tBuscar = segundosDesde(inicio) / consultas;
+    
+    std::printf("%-34s %10.2f us   x%.0f\n", "corregir un LOAD", tLoad * 1e6, tCompleto / tLoad);
+    std::printf("%-34s %10.2f us   x%.0f\n", "reemplazar por un MAP", tMap * 1e6, tCompleto / tMap);
+    std::printf("%-34s %10.2f us   x%.0f\n", "insertar una trama", tInsercion * 1e6, tCompleto / tInsercion);
+    std::printf("%-34s %10.2f us   x%.0f\n", "eliminar una trama", tEliminacion * 1e6, tCompleto / tEliminacion);
+    std::printf("%-34s %10.3f us   (%ld)\n", "desplazamiento de una trama", tBuscar * 1e6, suma);
+    
+    // Verificación contra una decodificación completa de la lista editada
+    RotorDeMapeo rotor;
+    longitud = lista.decodificarMensaje(&rotor, completo);
+    bool correcto = (longitud == mensaje.getLongitud()) &&
+                    std::memcmp(completo, mensaje.getTexto(), longitud) == 0;
+    delete[] completo;
+    
+    if (!correcto) {
+        std::cerr << "Error: el mensaje corregido no coincide con la decodificación completa" << std::endl;
+        return 1;
+    }
+    std::cout << "El mensaje corregido coincide con la decodificación completa" << std::endl;
+    return 0;
+}
@@ -0,0 +1,123 @@
+/**
+ * @file bench_formato.cpp
+ * @brief Compara el formato de texto y el binario de las tramas PRT-7
+ * @author Eliezer Mores Oyervides
+ * 
+ * Para la sesión de ejemplo del Arduino y para una sesión sintética
+ * reporta los bytes por trama en el cable, las tramas por segundo que
+ * caben a 9600 y 115200 baud (8N1, 10 bits por byte) y el costo de
+ * parsear cada formato en el host.
+ * 
+ * Uso: bench_formato [numeroDeTramas]
+ */
+
+#include "FormatoBinario.h"
+#include "GeneradorSintetico.h"
+#include "Tramas.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+/**
+ * @brief Sesión codificada en ambos formatos
+ */
+struct Sesion {
+    char* texto;            ///< Líneas "L,A\r\n" como las envía Serial.println
+    long bytesTexto;        ///< Bytes usados en texto
+    unsigned char* binario; ///< Tramas binarias consecutivas
+    long bytesBinario;      ///< Bytes usados en binario
+    long tramas;            ///< Número de tramas
+};
+
+void codificar(const TramaCompacta* tramas, long n, Sesion& sesion) {
+    sesion.texto = new char[n * 16];
+    sesion.binario = new unsigned char[n * MAX_TRAMA_BINARIA];
+    sesion.bytesTexto = 0;
+    sesion.bytesBinario = 0;
+    sesion.tramas = n;
+    for (long i = 0; i < n; i++) {
+        sesion.bytesTexto += escribirTramaTexto(tramas[i], sesion.texto + sesion.bytesTexto);
+        sesion.texto[sesion.bytesTexto++] = '\r';
+        sesion.texto[sesion.bytesTexto++] = '\n';
+        sesion.bytesBinario += codificarTramaBinaria(tramas[i], sesion.binario + sesion.bytesBinario);
+    }
+}
+
+void reportarCable(const char* nombre, const Sesion& sesion) {
+    double porTramaTexto = static_cast<double>(sesion.bytesTexto) / sesion.tramas;
+    double porTramaBinario = static_cast<double>(sesion.bytesBinario) / sesion.tramas;
+    std::printf("%-10s texto %5.2f B/trama (%6.0f tramas/s a 9600, %7.0f a 115200)\n", nombre,
+                porTramaTexto, 960.0 / porTramaTexto, 11520.0 / porTramaTexto);
+    std::printf("%-10s binario %3.2f B/trama (%6.0f tramas/s a 9600, %7.0f a 115200)  x%.1f\n", "",
+                porTramaBinario, 960.0 / porTramaBinario, 11520.0 / porTramaBinario,
+                porTramaTexto / porTramaBinario);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    long n = (argc > 1) ? std::atol(argv[1]) : 10000000;
+    if (n <= 0) n = 10000000;
+    
+    // Sesión de ejemplo de codigo_arduino_act2_unidad2.ino
+    TramaCompacta ejemplo[] = {
+        TramaCompacta::load('H'), TramaCompacta::load('O'), TramaCompacta::load('L'),
+        TramaCompacta::map(2), TramaCompacta::load('A'), TramaCompacta::load(' '),
+        TramaCompacta::load('W'), TramaCompacta::map(-2), TramaCompacta::load('O'),
+        TramaCompacta::load('R'), TramaCompacta::load('L'), TramaCompacta::load('D')
+    };
+    Sesion sesionEjemplo;
+    codificar(ejemplo, 12, sesionEjemplo);
+    reportarCable("ejemplo", sesionEjemplo);
+    
+    // Sesión sintética: 1 MAP de cada 16 tramas
+    TramaCompacta* tramas = new TramaCompacta[n];
+    FlujoSintetico flujo(99, 16, 100, CARACTERES_LETRAS);
+    flujo.llenar(tramas, n);
+    Sesion sesion;
+    codificar(tramas, n, sesion);
+    reportarCable("sintetica", sesion);
+    
+    // Parseo en el host: texto por líneas contra binario por etiquetas
+    long suma = 0;
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    const char* actual = sesion.texto;
+    const char* fin = sesion.texto + sesion.bytesTexto;
+    while (actual < fin) {
+        const char* finLinea = static_cast<const char*>(std::memchr(actual, '\r', fin - actual));
+        TramaCompacta trama;
+        if (parsearTrama(actual, static_cast<int>(finLinea - actual), trama)) {
+            suma += trama.caracter + trama.rotacion;
+        }
+        actual = finLinea + 2;
+    }
+    double tTexto = segundosDesde(inicio);
+    
+    inicio = std::chrono::steady_clock::now();
+    actual = reinterpret_cast<const char*>(sesion.binario);
+    fin = actual + sesion.bytesBinario;
+    while (actual < fin) {
+        int bytes = longitudTramaBinaria(static_cast<unsigned char>(*actual));
+        TramaCompacta trama;
+        if (parsearTrama(actual, bytes, trama)) {
+            suma -= trama.caracter + trama.rotacion;
+        }
+        actual += bytes;
+    }
+    double tBinario = segundosDesde(inicio);
+    
+    std::printf("Parseo texto:   %.2f ns/trama\n", tTexto * 1e9 / n);
+    std::printf("Parseo binario: %.2f ns/trama\n", tBinario * 1e9 / n);
+    std::printf("Verificacion: %s\n", suma == 0 ? "OK" : "ERROR");
+    
+    delete[] tramas;
+    delete[] sesion.texto;
+    delete[] sesion.binario;
+    delete[] sesionEjemplo.texto;
+    delete[] sesionEjemplo.binario;
+    return suma == 0 ? 0 : 1;
+}
@@ -0,0 +1,125 @@
+/**
+ * @file bench_multipuerto.cpp
+ * @brief Benchmark de escalamiento de IngestaMultipuerto con pseudo-terminales
+ * @author Eliezer Mores Oyervides
+ * 
+ * Para 1, 2, 4, ... N flujos crea un pty por flujo, un hilo emisor por pty
+ * que escribe tramas LOAD/MAP y END, y mide las tramas/s agregadas que
+ * decodifica la ingesta hasta que todos los flujos terminan.
+ * 
+ * Uso: bench_multipuerto [flujosMaximos] [tramasPorFlujo] [hilosDecodificacion]
+ */
+
+#include "GeneradorSintetico.h"
+#include "IngestaMultipuerto.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+/**
+ * @brief Escribe n tramas (una MAP cada diez) y END en el maestro del pty
+ */
+void emitir(int maestro, long n) {
+    char bloque[4096];
+    int usado = 0;
+    for (long i = 0; i <= n; i++) {
+        char trama[16];
+        int largo;
+        if (i == n) {
+            std::memcpy(trama, "END\r\n", 5);
+            largo = 5;
+        } else if (i % 10 == 0) {
+            std::memcpy(trama, "M,3\r\n", 5);
+            largo = 5;
+        } else {
+            trama[0] = 'L';
+            trama[1] = ',';
+            trama[2] = static_cast<char>('A' + i % 26);
+            trama[3] = '\r';
+            trama[4] = '\n';
+            largo = 5;
+        }
+        if (usado + largo > static_cast<int>(sizeof(bloque)) || i == n) {
+            if (i == n) {
+                std::memcpy(bloque + usado, trama, largo);
+                usado += largo;
+            }
+            for (int escrito = 0; escrito < usado;) {
+                ssize_t r = write(maestro, bloque + escrito, usado - escrito);
+                if (r <= 0) return;
+                escrito += static_cast<int>(r);
+            }
+            usado = 0;
+            if (i == n) return;
+        }
+        std::memcpy(bloque + usado, trama, largo);
+        usado += largo;
+    }
+}
+
+bool medir(int flujos, long tramasPorFlujo, int hilos) {
+    int* maestros = new int[flujos];
+    IngestaMultipuerto ingesta;
+    
+    for (int i = 0; i < flujos; i++) {
+        maestros[i] = posix_openpt(O_RDWR | O_NOCTTY);
+        if (maestros[i] < 0 || grantpt(maestros[i]) != 0 || unlockpt(maestros[i]) != 0 ||
+            !ingesta.agregarPuerto(ptsname(maestros[i]), 115200)) {
+            std::cerr << "No se pudo preparar el pseudo-terminal " << i << std::endl;
+            return false;
+        }
+    }
+    
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    ingesta.iniciar(hilos);
+    
+    std::thread* emisores = new std::thread[flujos];
+    for (int i = 0; i < flujos; i++) {
+        emisores[i] = std::thread(emitir, maestros[i], tramasPorFlujo);
+    }
+    for (int i = 0; i < flujos; i++) emisores[i].join();
+    
+    while (!ingesta.terminada()) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    ingesta.esperar();
+    double segundos = segundosDesde(inicio);
+    
+    long total = 0;
+    for (int i = 0; i < flujos; i++) total += ingesta.getFlujo(i).tramasDecodificadas;
+    
+    std::cout << flujos << " flujos: " << total / segundos << " tramas/s agregadas ("
+              << total << " tramas en " << segundos << " s)" << std::endl;
+    
+    for (int i = 0; i < flujos; i++) close(maestros[i]);
+    delete[] maestros;
+    delete[] emisores;
+    return total == flujos * tramasPorFlujo;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int maximo = (argc > 1) ? std::atoi(argv[1]) : 8;
+    long tramas = (argc > 2) ? std::atol(argv[2]) : 200000;
+    int hilos = (argc > 3) ? std::atoi(argv[3]) : static_cast<int>(std::thread::hardware_concurrency());
+    if (maximo < 1 || maximo > MAX_FLUJOS) maximo = 8;
+    if (tramas <= 0) tramas = 200000;
+    if (hilos < 1) hilos = 1;
+    
+    std::cout << "Tramas por flujo: " << tramas << ", hilos decodificadores: hasta " << hilos << std::endl;
+    bool correcto = true;
+    for (int flujos = 1; flujos <= maximo; flujos *= 2) {
+        correcto = medir(flujos, tramas, hilos) && correcto;
+    }
+    
+    if (!correcto) {
+        std::cerr << "ERROR: se perdieron tramas" << std::endl;
+        return 1;
+    }
+    return 0;
+}
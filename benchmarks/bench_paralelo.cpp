@@ -0,0 +1,71 @@
+/**
+ * @file bench_paralelo.cpp
+ * @brief Benchmark de ListaDeCarga::decodificarParalelo contra decodificarMensaje
+ * @author Eliezer Mores Oyervides
+ * 
+ * Llena una lista con una sesión sintética, la decodifica de forma
+ * secuencial y con 1, 2, 4, ... hilos, y verifica que todas las salidas
+ * y el estado final del rotor sean idénticos.
+ * 
+ * Uso: bench_paralelo [numeroDeTramas] [hilosMaximos]
+ */
+
+#include "GeneradorSintetico.h"
+#include "ListaDeCarga.h"
+#include "RotorDeMapeo.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+int main(int argc, char* argv[]) {
+    long n = (argc > 1) ? std::atol(argv[1]) : 50000000;
+    int maximo = (argc > 2) ? std::atoi(argv[2]) : static_cast<int>(std::thread::hardware_concurrency());
+    if (n <= 0) n = 50000000;
+    if (maximo < 2) maximo = 2;
+    
+    ListaDeCarga lista;
+    FlujoSintetico flujo(4242, 16, 100, CARACTERES_LETRAS);
+    for (long i = 0; i < n; i++) lista.insertarAlFinal(flujo.siguiente());
+    
+    char* referencia = new char[n + 1];
+    char* salida = new char[n + 1];
+    std::memset(referencia, 0, n + 1);
+    std::memset(salida, 0, n + 1);
+    
+    RotorDeMapeo rotorReferencia;
+    rotorReferencia.rotar(5);
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    int longitud = lista.decodificarMensaje(&rotorReferencia, referencia);
+    double tSecuencial = segundosDesde(inicio);
+    
+    std::cout << "Tramas: " << n << std::endl;
+    std::cout << "Secuencial:  " << tSecuencial * 1e9 / n << " ns/trama" << std::endl;
+    
+    bool correcto = true;
+    for (int hilos = 1; hilos <= maximo; hilos *= 2) {
+        RotorDeMapeo rotor;
+        rotor.rotar(5);
+        inicio = std::chrono::steady_clock::now();
+        int obtenida = lista.decodificarParalelo(&rotor, salida, hilos);
+        double t = segundosDesde(inicio);
+        
+        bool igual = obtenida == longitud &&
+                     std::memcmp(salida, referencia, longitud + 1) == 0 &&
+                     rotor.getDesplazamiento() == rotorReferencia.getDesplazamiento();
+        correcto = correcto && igual;
+        
+        std::cout << hilos << " hilo(s):   " << t * 1e9 / n << " ns/trama, aceleracion "
+                  << tSecuencial / t << "x" << (igual ? "" : "  [DIFERENTE]") << std::endl;
+    }
+    
+    delete[] referencia;
+    delete[] salida;
+    
+    if (!correcto) {
+        std::cerr << "ERROR: la decodificacion paralela no coincide con la secuencial" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,152 @@
+/**
+ * @file bench_parseo.cpp
+ * @brief Compara parsearTrama() línea por línea con parsearBloque()
+ * @author Eliezer Mores Oyervides
+ *
+ * Genera en memoria una captura de texto grande con todas las variantes que
+ * acepta el parser ("L,A", "l, b", "  M,-12", "L,Space", "M,+3", líneas
+ * inválidas) con finales "\r\n" como los de Serial.println y la parsea de las dos formas: con
+ * memchr + parsearTrama() por línea, como antes lo hacía ReproductorCaptura,
+ * y con parsearBloque() por lotes. Verifica que ambas produzcan las mismas
+ * tramas y reporta GB/s y millones de tramas por segundo.
+ *
+ * Uso: bench_parseo [megabytes]
+ */
+
+#include "GeneradorSintetico.h"
+#include "ParseoBloque.h"
+#include "Tramas.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+/**
+ * @brief Escribe una captura sintética de aproximadamente bytes bytes
+ * @return Bytes escritos
+ */
+long generarCaptura(char* texto, long bytes) {
+    long usados = 0;
+    FlujoSintetico flujo(2025, 16, 100, CARACTERES_LETRAS);
+    while (usados < bytes - 32) {
+        unsigned int r = flujo.aleatorio();
+        char letra = static_cast<char>('A' + (r >> 5) % 26);
+        int rotacion = static_cast<int>((r >> 5) % 201) - 100;
+        // Como bench_reproduccion: una trama MAP de cada 16, más las variantes raras
+        switch (r % 64) {
+            case 0: case 1: case 2: case 3:
+                usados += std::sprintf(texto + usados, "M,%d", rotacion);
+                break;
+            case 4:  usados += std::sprintf(texto + usados, "  m, %+d", rotacion); break;
+            case 5:  usados += std::sprintf(texto + usados, "L,Space"); break;
+            case 6:  usados += std::sprintf(texto + usados, "\tl,%c", letra + ('a' - 'A')); break;
+            case 7:  usados += std::sprintf(texto + usados, "X,%c", letra); break;
+            default: usados += std::sprintf(texto + usados, "L,%c", letra); break;
+        }
+        texto[usados++] = '\r';
+        texto[usados++] = '\n';
+    }
+    return usados;
+}
+
+/**
+ * @brief Huella de una trama para comparar los dos parsers
+ */
+unsigned long long huella(unsigned long long acumulado, const TramaCompacta& trama) {
+    // Sin ramas según el tipo, para no medir saltos mal predichos del propio benchmark
+    unsigned long long valor = trama.tipo | (static_cast<unsigned long long>(static_cast<unsigned char>(trama.caracter)) << 8) |
+                               (static_cast<unsigned long long>(static_cast<unsigned int>(trama.rotacion)) << 16);
+    return acumulado * 1000003ULL + valor;
+}
+
+/**
+ * @brief Parseo línea por línea con memchr y parsearTrama()
+ */
+unsigned long long parsearPorLinea(const char* texto, long bytes, long& tramas) {
+    unsigned long long acumulado = 0;
+    tramas = 0;
+    const char* actual = texto;
+    const char* fin = texto + bytes;
+    while (actual < fin) {
+        const char* finLinea = static_cast<const char*>(std::memchr(actual, '\n', fin - actual));
+        if (finLinea == nullptr) finLinea = fin;
+        int longitud = static_cast<int>(finLinea - actual);
+        if (longitud > 0 && actual[longitud - 1] == '\r') longitud--;
+        
+        TramaCompacta trama;
+        if (longitud > 0 && parsearTrama(actual, longitud, trama)) {
+            acumulado = huella(acumulado, trama);
+            tramas++;
+        }
+        actual = finLinea + 1;
+    }
+    return acumulado;
+}
+
+/**
+ * @brief Parseo por lotes con parsearBloque()
+ */
+unsigned long long parsearPorBloque(const char* texto, long bytes, long& tramas) {
+    unsigned long long acumulado = 0;
+    tramas = 0;
+    TramaCompacta lote[TRAMAS_POR_LOTE];
+    size_t desplazamiento = 0;
+    while (desplazamiento < static_cast<size_t>(bytes)) {
+        ResultadoParseo resultado = parsearBloque(texto + desplazamiento, bytes - desplazamiento,
+                                                  lote, TRAMAS_POR_LOTE, true);
+        for (int i = 0; i < resultado.tramas; i++) acumulado = huella(acumulado, lote[i]);
+        tramas += resultado.tramas;
+        desplazamiento += resultado.consumidos;
+    }
+    return acumulado;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    long megabytes = (argc > 1) ? std::atol(argv[1]) : 64;
+    if (megabytes <= 0) megabytes = 64;
+    
+    long capacidad = megabytes * 1024L * 1024L;
+    char* texto = new char[capacidad + 32];
+    long bytes = generarCaptura(texto, capacidad);
+    
+    std::cout << "Captura: " << bytes << " bytes, kernel de separadores: " << kernelParseo() << std::endl;
+    std::cout << "parser          GB/s    M tramas/s" << std::endl;
+    
+    long tramasLinea = 0;
+    long tramasBloque = 0;
+    unsigned long long huellaLinea = 0;
+    unsigned long long huellaBloque = 0;
+    double mejorLinea = 1e30;
+    double mejorBloque = 1e30;
+    
+    for (int repeticion = 0; repeticion < 5; repeticion++) {
+        std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+        huellaLinea = parsearPorLinea(texto, bytes, tramasLinea);
+        double t = segundosDesde(inicio);
+        if (t < mejorLinea) mejorLinea = t;
+        
+        inicio = std::chrono::steady_clock::now();
+        huellaBloque = parsearPorBloque(texto, bytes, tramasBloque);
+        t = segundosDesde(inicio);
+        if (t < mejorBloque) mejorBloque = t;
+    }
+    
+    std::printf("%-15s %-7.3f %.1f\n", "parsearTrama", bytes / mejorLinea / 1e9, tramasLinea / mejorLinea / 1e6);
+    std::printf("%-15s %-7.3f %.1f\n", "parsearBloque", bytes / mejorBloque / 1e9, tramasBloque / mejorBloque / 1e6);
+    std::printf("Aceleración: x%.2f\n", mejorLinea / mejorBloque);
+    
+    delete[] texto;
+    
+    if (tramasLinea != tramasBloque || huellaLinea != huellaBloque) {
+        std::cerr << "Error: los parsers no coinciden (" << tramasLinea << " vs "
+                  << tramasBloque << " tramas)" << std::endl;
+        return 1;
+    }
+    std::cout << "Ambos parsers producen las mismas " << tramasLinea << " tramas" << std::endl;
+    return 0;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file bench_puntos_control.cpp
+ * @brief Consultas de ventanas profundas con y sin el índice de nodos
+ * @author Eliezer Mores Oyervides
+ *
+ * Construye una sesión sintética larga y decodifica ventanas pequeñas en
+ * posiciones aleatorias de dos formas: repitiendo todas las tramas desde
+ * la cabeza (lo único posible sin el índice de la lista) y con
+ * ListaDeCarga::decodificarRango(). Verifica que ambas coincidan y reporta
+ * el tiempo por consulta.
+ *
+ * Uso: bench_puntos_control [tramas] [tramasPorVentana]
+ */
+
+#include "GeneradorSintetico.h"
+#include "ListaDeCarga.h"
+#include "RotorDeMapeo.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+/**
+ * @brief Decodifica [inicio, fin) repitiendo las tramas desde la cabeza
+ */
+int decodificarDesdeCabeza(const ListaDeCarga& lista, int inicio, int fin, char* salida) {
+    RotorDeMapeo rotor;
+    int indice = 0;
+    int posicion = 0;
+    for (IteradorCarga it = lista.primero(); it.valido() && indice < fin; ++it, indice++) {
+        if (it->esMap()) {
+            rotor.rotar(it->rotacion);
+        } else if (indice >= inicio) {
+            salida[posicion++] = rotor.getMapeo(it->caracter);
+        }
+    }
+    salida[posicion] = '\0';
+    return posicion;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int tramas = (argc > 1) ? std::atoi(argv[1]) : 4000000;
+    int ventana = (argc > 2) ? std::atoi(argv[2]) : 64;
+    if (tramas <= 0) tramas = 4000000;
+    if (ventana <= 0 || ventana > tramas) ventana = 64;
+    
+    ListaDeCarga lista;
+    FlujoSintetico flujo(99, 16, 100, CARACTERES_LETRAS);
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    for (int i = 0; i < tramas; i++) lista.insertarAlFinal(flujo.siguiente());
+    double tInsercion = segundosDesde(inicio);
+    std::printf("%d tramas, un resumen cada %d en el indice (insercion: %.2f ns/trama)\n",
+                tramas, TRAMAS_POR_NODO, tInsercion / tramas * 1e9);
+    
+    char* esperado = new char[ventana + 1];
+    char* obtenido = new char[ventana + 1];
+    const int consultasCabeza = 20;
+    const int consultasRango = 20000;
+    
+    // Las mismas posiciones para las dos formas (las primeras consultasCabeza)
+    int* posiciones = new int[consultasRango];
+    for (int i = 0; i < consultasRango; i++) {
+        posiciones[i] = static_cast<int>(flujo.aleatorio() % static_cast<unsigned int>(tramas - ventana + 1));
+    }
+    
+    inicio = std::chrono::steady_clock::now();
+    for (int i = 0; i < consultasCabeza; i++) {
+        decodificarDesdeCabeza(lista, posiciones[i], posiciones[i] + ventana, esperado);
+    }
+    double tCabeza = segundosDesde(inicio)
+                     / consultasCabeza;
+    
+    inicio = std::chrono::steady_clock::now();
+    long suma = 0;
+    for (int i = 0; i < consultasRango; i++) {
+        suma += lista.decodificarRango(posiciones[i], posiciones[i] + ventana, obtenido);
+    }
+    double tRango = segundosDesde(inicio)
+                    / consultasRango;
+    
+    // Verificación
+    bool correcto = true;
+    for (int i = 0; i < consultasCabeza && correcto; i++) {
+        int n = decodificarDesdeCabeza(lista, posiciones[i], posiciones[i] + ventana, esperado);
+        int m = lista.decodificarRango(posiciones[i], posiciones[i] + ventana, obtenido);
+        correcto = (n == m) && std::memcmp(esperado, obtenido, n) == 0;
+    }
+    
+    std::printf("ventana de %d tramas   desde la cabeza: %10.1f us   con el indice: %6.2f us   x%.0f\n",
+                ventana, tCabeza * 1e6, tRango * 1e6, tCabeza / tRango);
+    std::printf("(%ld caracteres decodificados)\n", suma);
+    
+    delete[] posiciones;
+    delete[] esperado;
+    delete[] obtenido;
+    
+    if (!correcto) {
+        std::cerr << "Error: decodificarRango no coincide con la decodificación desde la cabeza" << std::endl;
+        return 1;
+    }
+    return 0;
+}
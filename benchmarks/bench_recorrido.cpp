@@ -0,0 +1,123 @@
+/**
+ * @file bench_recorrido.cpp
+ * @brief Benchmark de recorrido: un nodo por trama vs nodos de 64 tramas
+ * @author Eliezer Mores Oyervides
+ * 
+ * Construye listas de 1M y 10M tramas (o los tamaños indicados) con el
+ * diseño anterior de un NodoCarga por trama y con la ListaDeCarga
+ * desenrollada, y mide el recorrido hacia adelante y hacia atrás.
+ * Los nodos del diseño anterior se reservan con new y se enlazan en un
+ * orden barajado, como quedan en un heap fragmentado tras una sesión larga.
+ * 
+ * Uso: bench_recorrido [tramas...]   (ej: bench_recorrido 1000000 10000000 100000000)
+ */
+
+#include "GeneradorSintetico.h"
+#include "ListaDeCarga.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+
+/**
+ * @brief Nodo del diseño anterior: una trama por nodo
+ */
+struct NodoPorTrama {
+    TramaCompacta trama;
+    NodoPorTrama* siguiente;
+    NodoPorTrama* previo;
+};
+
+/**
+ * @brief Visitante que solo acumula una suma de control
+ */
+struct Suma {
+    unsigned long valor;
+    void visitarLoad(char c) { valor = valor * 31 + static_cast<unsigned char>(c); }
+    void visitarMap(int n) { valor = valor * 31 + static_cast<unsigned int>(n); }
+};
+
+void medir(long n) {
+    // Diseño anterior, con nodos dispersos en el heap
+    NodoPorTrama** nodos = new NodoPorTrama*[n];
+    for (long i = 0; i < n; i++) nodos[i] = new NodoPorTrama();
+    unsigned int semilla = 99;
+    for (long i = n - 1; i > 0; i--) {
+        semilla = semilla * 1103515245u + 12345u;
+        long j = static_cast<long>((static_cast<unsigned long>(semilla) << 16 ^ i) % (i + 1));
+        NodoPorTrama* temporal = nodos[i];
+        nodos[i] = nodos[j];
+        nodos[j] = temporal;
+    }
+    for (long i = 0; i < n; i++) {
+        nodos[i]->trama = tramaPorIndice(i);
+        nodos[i]->siguiente = (i + 1 < n) ? nodos[i + 1] : nullptr;
+        nodos[i]->previo = (i > 0) ? nodos[i - 1] : nullptr;
+    }
+    NodoPorTrama* cabeza = nodos[0];
+    NodoPorTrama* cola = nodos[n - 1];
+    delete[] nodos;
+    
+    Suma sumaAnterior = { 0 };
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    for (NodoPorTrama* actual = cabeza; actual != nullptr; actual = actual->siguiente) {
+        actual->trama.aceptar(sumaAnterior);
+    }
+    double adelanteAnterior = segundosDesde(inicio) * 1e9;
+    inicio = std::chrono::steady_clock::now();
+    for (NodoPorTrama* actual = cola; actual != nullptr; actual = actual->previo) {
+        actual->trama.aceptar(sumaAnterior);
+    }
+    double atrasAnterior = segundosDesde(inicio) * 1e9;
+    
+    while (cabeza != nullptr) {
+        NodoPorTrama* siguiente = cabeza->siguiente;
+        delete cabeza;
+        cabeza = siguiente;
+    }
+    
+    // Lista desenrollada
+    ListaDeCarga* lista = new ListaDeCarga();
+    for (long i = 0; i < n; i++) lista->insertarAlFinal(tramaPorIndice(i));
+    
+    Suma sumaBloques = { 0 };
+    inicio = std::chrono::steady_clock::now();
+    for (IteradorCarga it = lista->primero(); it.valido(); ++it) {
+        it->aceptar(sumaBloques);
+    }
+    double adelanteBloques = segundosDesde(inicio) * 1e9;
+    inicio = std::chrono::steady_clock::now();
+    for (IteradorCarga it = lista->ultimo(); it.valido(); --it) {
+        it->aceptar(sumaBloques);
+    }
+    double atrasBloques = segundosDesde(inicio) * 1e9;
+    delete lista;
+    
+    std::cout << "Tramas: " << n << std::endl;
+    std::cout << "  Nodo por trama:   adelante " << adelanteAnterior / n << " ns/trama, atras "
+              << atrasAnterior / n << " ns/trama, " << sizeof(NodoPorTrama) << " bytes/trama" << std::endl;
+    std::cout << "  Nodos de " << TRAMAS_POR_NODO << ":      adelante " << adelanteBloques / n
+              << " ns/trama, atras " << atrasBloques / n << " ns/trama, "
+              << static_cast<double>(sizeof(NodoCarga)) / TRAMAS_POR_NODO << " bytes/trama" << std::endl;
+    
+    if (sumaAnterior.valor != sumaBloques.valor) {
+        std::cerr << "ERROR: los recorridos no coinciden" << std::endl;
+        std::exit(1);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            long n = std::atol(argv[i]);
+            if (n > 0) medir(n);
+        }
+    } else {
+        medir(1000000);
+        medir(10000000);
+    }
+    return 0;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file bench_reproduccion.cpp
+ * @brief Benchmark de ReproductorCaptura sobre capturas de distintos tamaños
+ * @author Eliezer Mores Oyervides
+ * 
+ * Genera capturas sintéticas en /tmp ("L,X" y "M,N" por línea), las
+ * reproduce con mmap y reporta el rendimiento del parseo en GB/s junto con
+ * el de la decodificación posterior.
+ * 
+ * Uso: bench_reproduccion [megabytesMaximos]
+ */
+
+#include "ReproductorCaptura.h"
+#include "FormatoBinario.h"
+#include "GeneradorSintetico.h"
+#include "RotorDeMapeo.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief Escribe una captura sintética de aproximadamente megabytes MB
+ * @return true si se pudo escribir
+ */
+bool generarCaptura(const char* ruta, long megabytes) {
+    FILE* archivo = std::fopen(ruta, "w");
+    if (archivo == nullptr) return false;
+    
+    long objetivo = megabytes * 1024L * 1024L;
+    long escritos = 0;
+    FlujoSintetico flujo(777, 16, 100, CARACTERES_LETRAS);
+    char linea[16];
+    while (escritos < objetivo) {
+        int n = escribirTramaTexto(flujo.siguiente(), linea);
+        linea[n++] = '\n';
+        escritos += static_cast<long>(std::fwrite(linea, 1, n, archivo));
+    }
+    std::fputs("END\n", archivo);
+    std::fclose(archivo);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    long maximo = (argc > 1) ? std::atol(argv[1]) : 256;
+    if (maximo <= 0) maximo = 256;
+    
+    const char* ruta = "/tmp/bench_reproduccion.prt7";
+    std::cout << "MB      tramas      parseo GB/s   decodificacion M tramas/s" << std::endl;
+    
+    for (long megabytes = 1; megabytes <= maximo; megabytes *= 4) {
+        if (!generarCaptura(ruta, megabytes)) {
+            std::cerr << "Error: No se pudo generar " << ruta << std::endl;
+            return 1;
+        }
+        
+        ReproductorCaptura reproductor;
+        if (!reproductor.abrir(ruta)) return 1;
+        
+        ListaDeCarga lista;
+        std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+        EstadisticasReproduccion estadisticas = reproductor.reproducir(lista);
+        double tParseo = segundosDesde(inicio);
+        
+        RotorDeMapeo rotor;
+        char* mensaje = new char[lista.getTamano() + 1];
+        inicio = std::chrono::steady_clock::now();
+        lista.decodificarMensaje(&rotor, mensaje);
+        double tDecodificacion = segundosDesde(inicio);
+        delete[] mensaje;
+        
+        std::printf("%-7ld %-11ld %-13.3f %.1f%s\n", megabytes, estadisticas.tramas,
+                    estadisticas.bytes / tParseo / 1e9,
+                    estadisticas.tramas / tDecodificacion / 1e6,
+                    estadisticas.finEncontrado ? "" : "  (sin END)");
+    }
+    
+    unlink(ruta);
+    return 0;
+}
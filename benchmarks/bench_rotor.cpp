@@ -0,0 +1,116 @@
+/**
+ * @file bench_rotor.cpp
+ * @brief Microbenchmark del RotorDeMapeo: recorrido de la lista vs tabla
+ * @author Eliezer Mores Oyervides
+ * 
+ * Genera un flujo sintético de tramas (90% LOAD, 10% MAP) y mide los
+ * nanosegundos por trama de la implementación original, que recorre la
+ * lista circular en cada consulta, contra el rotor basado en tablas.
+ * 
+ * Uso: bench_rotor [numeroDeTramas]
+ */
+
+#include "GeneradorSintetico.h"
+#include "RotorDeMapeo.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+
+/**
+ * @brief Copia del rotor original que recorre la lista en cada operación
+ */
+class RotorLegado {
+private:
+    NodoRotor* cabeza;
+    
+public:
+    RotorLegado() : cabeza(nullptr) {
+        const char alfabeto[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+        NodoRotor* ultimo = nullptr;
+        for (int i = 0; alfabeto[i] != '\0'; i++) {
+            NodoRotor* nuevo = new NodoRotor(alfabeto[i]);
+            if (cabeza == nullptr) {
+                cabeza = nuevo;
+            } else {
+                ultimo->siguiente = nuevo;
+                nuevo->previo = ultimo;
+            }
+            ultimo = nuevo;
+        }
+        ultimo->siguiente = cabeza;
+        cabeza->previo = ultimo;
+    }
+    
+    ~RotorLegado() {
+        cabeza->previo->siguiente = nullptr;
+        while (cabeza != nullptr) {
+            NodoRotor* siguiente = cabeza->siguiente;
+            delete cabeza;
+            cabeza = siguiente;
+        }
+    }
+    
+    void rotar(int n) {
+        n = n % TAMANO_ALFABETO;
+        if (n < 0) n += TAMANO_ALFABETO;
+        for (int i = 0; i < n; i++) cabeza = cabeza->siguiente;
+    }
+    
+    char getMapeo(char in) {
+        if (in >= 'a' && in <= 'z') in = in - 'a' + 'A';
+        if (in == ' ') return ' ';
+        if (in < 'A' || in > 'Z') return in;
+        const char alfabeto[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+        int posicionOriginal = -1;
+        for (int i = 0; alfabeto[i] != '\0'; i++) {
+            if (alfabeto[i] == in) {
+                posicionOriginal = i;
+                break;
+            }
+        }
+        NodoRotor* resultado = cabeza;
+        for (int i = 0; i < posicionOriginal; i++) resultado = resultado->siguiente;
+        return resultado->dato;
+    }
+};
+
+template <typename Rotor>
+double medir(const TramaCompacta* tramas, long n, unsigned long& suma) {
+    Rotor rotor;
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    suma = sumaDeControl(rotor, tramas, n);
+    std::chrono::steady_clock::time_point fin = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(fin - inicio).count() / n;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    long n = (argc > 1) ? std::atol(argv[1]) : 5000000;
+    if (n <= 0) n = 5000000;
+    
+    // Flujo sintético reproducible (generador lineal congruente)
+    TramaCompacta* tramas = new TramaCompacta[n];
+    FlujoSintetico flujo(12345, 10, 25, CARACTERES_MEZCLA);
+    flujo.llenar(tramas, n);
+    
+    unsigned long sumaLegado = 0;
+    unsigned long sumaTabla = 0;
+    double nsLegado = medir<RotorLegado>(tramas, n, sumaLegado);
+    double nsTabla = medir<RotorDeMapeo>(tramas, n, sumaTabla);
+    
+    std::cout << "Tramas sinteticas: " << n << std::endl;
+    std::cout << "Rotor legado (lista): " << nsLegado << " ns/trama" << std::endl;
+    std::cout << "Rotor con tabla:      " << nsTabla << " ns/trama" << std::endl;
+    std::cout << "Aceleracion:          " << nsLegado / nsTabla << "x" << std::endl;
+    
+    delete[] tramas;
+    
+    if (sumaLegado != sumaTabla) {
+        std::cerr << "ERROR: los resultados de ambos rotores no coinciden" << std::endl;
+        return 1;
+    }
+    return 0;
+}
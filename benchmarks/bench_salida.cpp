@@ -0,0 +1,113 @@
+/**
+ * @file bench_salida.cpp
+ * @brief Benchmark de SalidaTramas contra la impresión original por trama
+ * @author Eliezer Mores Oyervides
+ * 
+ * Escribe en /dev/null una sesión sintética con la impresión original
+ * (std::cout con std::endl y el mensaje completo en cada LOAD) y con cada
+ * modo de SalidaTramas, vaciando el buffer cada 64 tramas como si cada
+ * lectura del puerto trajera ese número de tramas.
+ * 
+ * Uso: bench_salida [numeroDeTramas]
+ */
+
+#include "GeneradorSintetico.h"
+#include "MensajeDecodificado.h"
+#include "RotorDeMapeo.h"
+#include "SalidaTramas.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+/**
+ * @brief Tramas por lectura simulada del puerto
+ */
+const long TRAMAS_POR_LECTURA = 64;
+
+/**
+ * @brief Réplica de la impresión original de main.cpp
+ */
+void imprimirLegado(std::ostream& salida, long n) {
+    RotorDeMapeo rotor;
+    char* mensaje = new char[n + 1];
+    int pos = 0;
+    for (long i = 0; i < n; i++) {
+        if (i % 16 == 15) {
+            rotor.rotar(3);
+            salida << "Trama recibida: [M,3] -> Procesando... -> ";
+            salida << "ROTANDO ROTOR +3. ";
+            salida << "(Ahora 'A' se mapea a '" << rotor.getMapeo('A') << "')" << std::endl;
+        } else {
+            char original = static_cast<char>('A' + i % 26);
+            char decodificado = rotor.getMapeo(original);
+            mensaje[pos++] = decodificado;
+            salida << "Trama recibida: [L," << original << "] -> Procesando... -> ";
+            salida << "Fragmento '" << original << "' decodificado como '" << decodificado << "'. ";
+            salida << "Mensaje: [";
+            for (int j = 0; j < pos; j++) salida << "[" << mensaje[j] << "]";
+            salida << "]" << std::endl;
+        }
+        salida << std::endl;
+    }
+    delete[] mensaje;
+}
+
+void imprimirConSalida(std::ostream& destino, long n, ModoSalida modo) {
+    RotorDeMapeo rotor;
+    MensajeDecodificado mensaje;
+    SalidaTramas salida(destino, modo);
+    char texto[4] = { 'L', ',', 'A', '\0' };
+    for (long i = 0; i < n; i++) {
+        if (i % 16 == 15) {
+            rotor.rotar(3);
+            salida.registrarRotacion("M,3", 3, 3, rotor.getMapeo('A'), mensaje);
+        } else {
+            texto[2] = static_cast<char>('A' + i % 26);
+            char decodificado = rotor.getMapeo(texto[2]);
+            mensaje.agregar(decodificado);
+            salida.registrarCarga(texto, 3, texto[2], decodificado, mensaje);
+        }
+        if (i % TRAMAS_POR_LECTURA == TRAMAS_POR_LECTURA - 1) salida.vaciar();
+    }
+    salida.vaciar();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    long n = (argc > 1) ? std::atol(argv[1]) : 1000000;
+    if (n <= 0) n = 1000000;
+    
+    // Los formatos que reimprimen el mensaje son cuadráticos: se miden con menos tramas
+    long nCuadratico = (n < 5000) ? n : 5000;
+    
+    std::ofstream nulo("/dev/null");
+    
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    imprimirLegado(nulo, nCuadratico);
+    double tLegado = segundosDesde(inicio);
+    
+    inicio = std::chrono::steady_clock::now();
+    imprimirConSalida(nulo, nCuadratico, SALIDA_COMPLETA);
+    double tCompleta = segundosDesde(inicio);
+    
+    std::printf("%-24s %8ld tramas %12.1f ns/trama\n", "legado (cout + endl)", nCuadratico,
+                tLegado * 1e9 / nCuadratico);
+    std::printf("%-24s %8ld tramas %12.1f ns/trama\n", "completa", nCuadratico,
+                tCompleta * 1e9 / nCuadratico);
+    
+    const ModoSalida modos[] = { SALIDA_INCREMENTAL, SALIDA_RESUMEN, SALIDA_SILENCIOSA };
+    const char* nombres[] = { "incremental", "resumen", "silenciosa" };
+    for (int m = 0; m < 3; m++) {
+        inicio = std::chrono::steady_clock::now();
+        imprimirConSalida(nulo, n, modos[m]);
+        double t = segundosDesde(inicio);
+        std::printf("%-24s %8ld tramas %12.1f ns/trama\n", nombres[m], n, t * 1e9 / n);
+    }
+    
+    return 0;
+}
@@ -0,0 +1,182 @@
+/**
+ * @file bench_serial.cpp
+ * @brief Benchmark de lectura de líneas a través de un pseudo-terminal
+ * @author Eliezer Mores Oyervides
+ * 
+ * Abre un par pty, un hilo escribe tramas "L,X\r\n" en el maestro y el
+ * hilo principal las lee del esclavo con SerialReader. Compara la lectura
+ * original (un read() por byte) con la lectura por bloques, reportando
+ * líneas/s y el tiempo de CPU del hilo lector.
+ * 
+ * Después repite la lectura por bloques con el pty configurado a una
+ * velocidad fuera de la tabla Bxxx (termios2/BOTHER), que se informa
+ * tal como quedó, y con VMIN=0 contra VMIN=64: con VMIN alto un read()
+ * no vuelve con menos de 64 bytes salvo que venza VTIME, lo que importa
+ * cuando el emisor entrega de a pocos bytes.
+ * 
+ * Uso: bench_serial [numeroDeLineas] [baudios]
+ */
+
+#include "GeneradorSintetico.h"
+#include "SerialReader.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+/**
+ * @brief Copia de la lectura original: un read() por carácter
+ */
+bool leerLineaLegado(int puerto, char* buffer, int maxLen) {
+    int pos = 0;
+    while (pos < maxLen - 1) {
+        char c;
+        int n = read(puerto, &c, 1);
+        if (n < 0) return false;
+        if (n == 0) continue;
+        if (c == '\n' || c == '\r') {
+            if (pos > 0) {
+                buffer[pos] = '\0';
+                return true;
+            }
+        } else {
+            buffer[pos++] = c;
+        }
+    }
+    buffer[pos] = '\0';
+    return pos > 0;
+}
+
+/**
+ * @brief Escribe n tramas LOAD seguidas de END en el maestro del pty
+ */
+void escribirTramas(int maestro, long n) {
+    char bloque[4096];
+    int usado = 0;
+    for (long i = 0; i <= n; i++) {
+        const char* trama = "END\r\n";
+        char temporal[8];
+        if (i < n) {
+            temporal[0] = 'L';
+            temporal[1] = ',';
+            temporal[2] = static_cast<char>('A' + i % 26);
+            temporal[3] = '\r';
+            temporal[4] = '\n';
+            temporal[5] = '\0';
+            trama = temporal;
+        }
+        int largo = static_cast<int>(std::strlen(trama));
+        if (usado + largo > static_cast<int>(sizeof(bloque))) {
+            for (int escrito = 0; escrito < usado;) {
+                ssize_t r = write(maestro, bloque + escrito, usado - escrito);
+                if (r <= 0) return;
+                escrito += static_cast<int>(r);
+            }
+            usado = 0;
+        }
+        std::memcpy(bloque + usado, trama, largo);
+        usado += largo;
+    }
+    for (int escrito = 0; escrito < usado;) {
+        ssize_t r = write(maestro, bloque + escrito, usado - escrito);
+        if (r <= 0) return;
+        escrito += static_cast<int>(r);
+    }
+}
+
+double cpuHilo() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Ejecuta una medición completa con el modo de lectura indicado
+ */
+bool medir(long n, bool porBloques, const ConfiguracionSerial& configuracion, const char* etiqueta) {
+    int maestro = posix_openpt(O_RDWR | O_NOCTTY);
+    if (maestro < 0 || grantpt(maestro) != 0 || unlockpt(maestro) != 0) {
+        std::cerr << "No se pudo crear el pseudo-terminal" << std::endl;
+        return false;
+    }
+    
+    SerialReader serial;
+    if (!serial.conectar(ptsname(maestro), configuracion)) {
+        close(maestro);
+        return false;
+    }
+    
+    std::thread escritor(escribirTramas, maestro, n);
+    
+    long lineas = 0;
+    double cpuInicio = cpuHilo();
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    
+    if (porBloques) {
+        const char* linea;
+        int longitud;
+        while (serial.leerLineaVista(linea, longitud)) {
+            if (longitud >= 3 && std::memcmp(linea, "END", 3) == 0) break;
+            lineas++;
+        }
+    } else {
+        char buffer[256];
+        while (leerLineaLegado(serial.getDescriptor(), buffer, sizeof(buffer))) {
+            if (std::strcmp(buffer, "END") == 0) break;
+            lineas++;
+        }
+    }
+    
+    double segundos = segundosDesde(inicio);
+    double cpu = cpuHilo() - cpuInicio;
+    escritor.join();
+    close(maestro);
+    
+    std::cout << etiqueta << lineas / segundos << " lineas/s, CPU del lector "
+              << cpu * 1e9 / lineas << " ns/linea ("
+              << 100.0 * cpu / segundos << "% de un nucleo)" << std::endl;
+    return lineas == n;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    long n = (argc > 1) ? std::atol(argv[1]) : 1000000;
+    if (n <= 0) n = 1000000;
+    
+    int baudios = (argc > 2) ? std::atoi(argv[2]) : 2000000;
+    if (baudios <= 0) baudios = 2000000;
+    
+    std::cout << "Lineas por medicion: " << n << std::endl;
+    ConfiguracionSerial configuracion;
+    configuracion.baudios = 115200;
+    bool correcto = medir(n, false, configuracion, "Byte a byte:  ");
+    correcto = medir(n, true, configuracion, "Por bloques:  ") && correcto;
+    
+    // Velocidad arbitraria: el pty la guarda tal cual, un driver real puede redondearla
+    int maestro = posix_openpt(O_RDWR | O_NOCTTY);
+    SerialReader prueba;
+    configuracion.baudios = baudios;
+    if (maestro < 0 || grantpt(maestro) != 0 || unlockpt(maestro) != 0 ||
+        !prueba.conectar(ptsname(maestro), configuracion)) {
+        std::cerr << "ERROR: el pseudo-terminal no acepto " << baudios << " baudios" << std::endl;
+        return 1;
+    }
+    std::cout << "Pedidos " << baudios << " baudios, configurados " << prueba.getBaudios() << std::endl;
+    prueba.cerrar();
+    close(maestro);
+    
+    correcto = medir(n, true, configuracion, "VMIN=0:       ") && correcto;
+    configuracion.vmin = 64;
+    correcto = medir(n, true, configuracion, "VMIN=64:      ") && correcto;
+    
+    if (!correcto) {
+        std::cerr << "ERROR: no se recibieron todas las lineas" << std::endl;
+        return 1;
+    }
+    return 0;
+}
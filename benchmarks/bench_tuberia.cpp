@@ -0,0 +1,225 @@
+/**
+ * @file bench_tuberia.cpp
+ * @brief Bucle de un hilo contra TuberiaDecodificacion con una consola lenta
+ * @author Eliezer Mores Oyervides
+ *
+ * Un hilo emisor escribe tramas en un pseudo-terminal tan rápido como el
+ * lector las acepta. La salida va a un flujo que cobra un tiempo por
+ * byte, como una terminal remota. Compara el bucle secuencial (leer,
+ * parsear, decodificar y escribir en el mismo hilo) con la tubería con
+ * PRESION_BLOQUEAR y PRESION_DESCARTAR: cuánto tarda el emisor en
+ * entregar todo (lo que el puerto acepta), el tiempo total y las métricas
+ * de las colas. En los tres casos el mensaje ensamblado debe ser el
+ * mismo.
+ *
+ * Uso: bench_tuberia [tramas] [nsPorByte]
+ */
+
+#include "TuberiaDecodificacion.h"
+#include "FormatoBinario.h"
+#include "GeneradorSintetico.h"
+#include "RotorDeMapeo.h"
+#include "Tramas.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <poll.h>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @class BufferLento
+ * @brief streambuf que descarta los bytes tras esperar un tiempo proporcional
+ */
+class BufferLento : public std::streambuf {
+private:
+    long nsPorByte; ///< Costo de cada byte escrito
+    
+protected:
+    virtual std::streamsize xsputn(const char*, std::streamsize n) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(nsPorByte * n));
+        return n;
+    }
+    
+    virtual int_type overflow(int_type c) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(nsPorByte));
+        return traits_type::not_eof(c);
+    }
+    
+public:
+    explicit BufferLento(long ns) : nsPorByte(ns) {}
+};
+
+/**
+ * @brief Trama i del flujo sintético en texto, con su fin de línea
+ */
+int tramaSintetica(long i, char* trama) {
+    int largo = escribirTramaTexto(tramaPorIndice(i), trama);
+    trama[largo++] = '\r';
+    trama[largo++] = '\n';
+    return largo;
+}
+
+/**
+ * @brief Mensaje que debe salir del flujo sintético
+ */
+std::string mensajeEsperado(long n) {
+    RotorDeMapeo rotor;
+    std::string mensaje;
+    for (long i = 0; i < n; i++) {
+        TramaCompacta trama = tramaPorIndice(i);
+        if (trama.esMap()) rotor.rotar(trama.rotacion);
+        else mensaje += rotor.getMapeo(trama.caracter);
+    }
+    return mensaje;
+}
+
+/**
+ * @brief Escribe n tramas y END en el maestro del pty
+ * @param segundos Recibe cuánto tardó en entregar todo
+ */
+void emitir(int maestro, long n, double* segundos) {
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    char bloque[4096];
+    int usado = 0;
+    for (long i = 0; i <= n; i++) {
+        char trama[16];
+        int largo = (i == n) ? std::snprintf(trama, sizeof(trama), "END\r\n") : tramaSintetica(i, trama);
+        if (usado + largo > static_cast<int>(sizeof(bloque))) {
+            for (int escrito = 0; escrito < usado;) {
+                ssize_t r = write(maestro, bloque + escrito, usado - escrito);
+                if (r <= 0) return;
+                escrito += static_cast<int>(r);
+            }
+            usado = 0;
+        }
+        std::memcpy(bloque + usado, trama, largo);
+        usado += largo;
+    }
+    for (int escrito = 0; escrito < usado;) {
+        ssize_t r = write(maestro, bloque + escrito, usado - escrito);
+        if (r <= 0) return;
+        escrito += static_cast<int>(r);
+    }
+    *segundos = segundosDesde(inicio);
+}
+
+/**
+ * @brief Abre un pty y conecta el lector a su esclavo
+ * @return Descriptor del maestro, o -1 si falla
+ */
+int abrirPty(SerialReader& serial) {
+    int maestro = posix_openpt(O_RDWR | O_NOCTTY);
+    if (maestro < 0 || grantpt(maestro) != 0 || unlockpt(maestro) != 0 ||
+        !serial.conectar(ptsname(maestro), 115200) || !serial.setNoBloqueante(true)) {
+        std::cerr << "No se pudo preparar el pseudo-terminal" << std::endl;
+        if (maestro >= 0) close(maestro);
+        return -1;
+    }
+    return maestro;
+}
+
+/**
+ * @brief Bucle de un hilo como el de main sin --tuberia
+ */
+void bucleSecuencial(SerialReader& serial, ListaDeCarga& lista, RotorConfigurable& rotor,
+                     MensajeDecodificado& mensaje, SalidaTramas& salida) {
+    struct pollfd espera = { serial.getDescriptor(), POLLIN, 0 };
+    for (;;) {
+        if (poll(&espera, 1, 1000) <= 0 || serial.leerDisponible() < 0) return;
+        
+        const char* linea;
+        int longitud;
+        while (serial.extraerLinea(linea, longitud)) {
+            if (longitud >= 3 && std::strncmp(linea, "END", 3) == 0) {
+                salida.vaciar();
+                return;
+            }
+            TramaCompacta trama;
+            if (!parsearTrama(linea, longitud, trama)) continue;
+            lista.insertarAlFinal(trama);
+            if (trama.esLoad()) {
+                char decodificado = rotor.getMapeo(trama.caracter);
+                mensaje.agregar(decodificado);
+                salida.registrarCarga(linea, longitud, trama.caracter, decodificado, mensaje);
+            } else {
+                rotor.rotar(trama.rotacion);
+                salida.registrarRotacion(linea, longitud, trama.rotacion, rotor.getMapeo('A'), mensaje);
+            }
+        }
+        salida.vaciar();
+    }
+}
+
+/**
+ * @brief Decodifica n tramas de un pty, en un hilo (politica < 0) o con la tubería
+ * @return false si el mensaje no coincide con el esperado
+ */
+bool medir(const char* nombre, int politica, long n, long nsPorByte, const std::string& esperado) {
+    SerialReader serial;
+    int maestro = abrirPty(serial);
+    if (maestro < 0) return false;
+    
+    BufferLento lento(nsPorByte);
+    std::ostream consola(&lento);
+    SalidaTramas salida(consola, SALIDA_INCREMENTAL);
+    ListaDeCarga lista;
+    RotorConfigurable rotor;
+    MensajeDecodificado mensaje;
+    
+    double segundosEmisor = 0;
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    std::thread emisor(emitir, maestro, n, &segundosEmisor);
+    
+    TuberiaDecodificacion tuberia(serial, lista, rotor, nullptr, mensaje, salida, nullptr);
+    if (politica < 0) {
+        bucleSecuencial(serial, lista, rotor, mensaje, salida);
+    } else {
+        tuberia.iniciar(static_cast<PoliticaPresion>(politica), 5000);
+        tuberia.esperar();
+    }
+    double segundos = segundosDesde(inicio);
+    emisor.join();
+    
+    std::printf("%-20s emisor %7.3f s (%9.0f tramas/s)   total %7.3f s\n", nombre, segundosEmisor,
+                n / segundosEmisor, segundos);
+    if (politica >= 0) {
+        const EstadisticasCola& cola = tuberia.getEstadisticas(COLA_SALIDA);
+        std::printf("%-20s cola de salida: profundidad max %ld, esperas %ld, lotes descartados %ld\n", "",
+                    cola.profundidadMaxima.load(), cola.esperasLlena.load(), cola.descartados.load());
+    }
+    
+    close(maestro);
+    serial.cerrar();
+    return std::string(mensaje.getTexto(), mensaje.getLongitud()) == esperado && lista.getTamano() == n;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    long n = (argc > 1) ? std::atol(argv[1]) : 200000;
+    long nsPorByte = (argc > 2) ? std::atol(argv[2]) : 100;
+    if (n <= 0) n = 200000;
+    if (nsPorByte < 0) nsPorByte = 100;
+    
+    std::cout << n << " tramas, salida incremental a " << nsPorByte << " ns por byte" << std::endl;
+    std::string esperado = mensajeEsperado(n);
+    
+    bool correcto = medir("un hilo", -1, n, nsPorByte, esperado);
+    correcto = medir("tuberia, bloquear", PRESION_BLOQUEAR, n, nsPorByte, esperado) && correcto;
+    correcto = medir("tuberia, descartar", PRESION_DESCARTAR, n, nsPorByte, esperado) && correcto;
+    
+    if (!correcto) {
+        std::cerr << "ERROR: el mensaje ensamblado no coincide" << std::endl;
+        return 1;
+    }
+    std::cout << "Los tres modos ensamblan el mismo mensaje" << std::endl;
+    return 0;
+}
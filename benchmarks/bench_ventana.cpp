@@ -0,0 +1,176 @@
+/**
+ * @file bench_ventana.cpp
+ * @brief Memoria residente de ListaDeCarga con ventana contra retener toda la sesión
+ * @author Eliezer Mores Oyervides
+ *
+ * Inserta el mismo flujo sintético en una lista sin ventana, en una con
+ * ventana y texto compactado en memoria, y en una con ventana y derrame a
+ * disco. Reporta el costo por trama y la memoria residente (nodos en la
+ * arena y texto compactado) en varios puntos de la sesión: sin ventana crece con
+ * cada trama, con derrame queda fija. Después verifica que el texto
+ * compactado más la decodificación de la ventana es el mensaje completo,
+ * también tras editar tramas dentro de la ventana.
+ *
+ * Uso: bench_ventana [tramas] [ventana] [ruta]
+ */
+
+#include "GeneradorSintetico.h"
+#include "ListaDeCarga.h"
+#include "RotorDeMapeo.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief Puntos de la sesión donde se mide la memoria
+ */
+const int PUNTOS_MEDICION = 4;
+
+/**
+ * @brief Bytes que la lista tiene en memoria (nodos en la arena y texto compactado)
+ */
+size_t bytesResidentes(const ListaDeCarga& lista) {
+    return lista.getEstadisticasArena().bytesReservados + lista.getTextoCompactado().getBytesResidentes();
+}
+
+/**
+ * @brief Inserta n tramas midiendo la memoria en PUNTOS_MEDICION puntos
+ * @return Segundos de inserción
+ */
+double insertar(ListaDeCarga& lista, long n, size_t* memoria) {
+    FlujoSintetico flujo(2025, 10, 10, CARACTERES_LETRAS);
+    double segundos = 0;
+    for (int p = 0; p < PUNTOS_MEDICION; p++) {
+        long hasta = n * (p + 1) / PUNTOS_MEDICION;
+        std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+        for (long i = n * p / PUNTOS_MEDICION; i < hasta; i++) lista.insertarAlFinal(flujo.siguiente());
+        segundos += segundosDesde(inicio);
+        memoria[p] = bytesResidentes(lista);
+    }
+    return segundos;
+}
+
+/**
+ * @brief Mensaje completo de una lista sin ventana
+ */
+std::string decodificarCompleta(ListaDeCarga& lista) {
+    char* salida = new char[lista.getTamano() + 1];
+    RotorDeMapeo rotor;
+    int caracteres = lista.decodificarMensaje(&rotor, salida);
+    std::string mensaje(salida, caracteres);
+    delete[] salida;
+    return mensaje;
+}
+
+/**
+ * @brief Mensaje de una lista con ventana (texto compactado más ventana)
+ */
+std::string decodificarVentana(const ListaDeCarga& lista) {
+    std::ostringstream salida;
+    lista.escribirMensaje(salida);
+    return salida.str();
+}
+
+/**
+ * @brief Imprime una fila de la tabla de memoria
+ */
+void imprimirFila(const char* nombre, double segundos, long n, const size_t* memoria) {
+    std::printf("%-22s %6.2f ns/trama ", nombre, segundos / n * 1e9);
+    for (int p = 0; p < PUNTOS_MEDICION; p++) std::printf(" %10.1f", memoria[p] / 1024.0);
+    std::printf("\n");
+}
+
+/**
+ * @brief Edita las mismas tramas en una lista con ventana y en la completa
+ * @return false si los mensajes dejan de coincidir
+ */
+bool verificarEdiciones(ListaDeCarga& completa, ListaDeCarga& ventana, MensajeDecodificado& mensaje) {
+    FlujoSintetico flujo(99, 10, 10, CARACTERES_LETRAS);
+    for (int e = 0; e < 2000; e++) {
+        int indice = static_cast<int>(flujo.aleatorio() % static_cast<unsigned int>(ventana.getTamano()));
+        int indiceCompleto = static_cast<int>(ventana.getCompactado().tramas) + indice;
+        TramaCompacta trama = flujo.siguiente();
+        CambioMensaje cambio;
+        
+        switch (e % 3) {
+            case 0:
+                completa.insertarEn(indiceCompleto, trama);
+                ventana.insertarEn(indice, trama, &cambio);
+                break;
+            case 1:
+                completa.eliminarEn(indiceCompleto);
+                ventana.eliminarEn(indice, &cambio);
+                break;
+            default:
+                completa.reemplazarEn(indiceCompleto, trama);
+                ventana.reemplazarEn(indice, trama, &cambio);
+                break;
+        }
+        mensaje.aplicar(cambio);
+    }
+    
+    std::string esperado = decodificarCompleta(completa);
+    if (decodificarVentana(ventana) != esperado) return false;
+    
+    // El final que guarda el mensaje recortado sigue igual al del mensaje completo
+    return esperado.compare(static_cast<size_t>(mensaje.getDescartados()), std::string::npos,
+                            mensaje.getTexto()) == 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    long n = (argc > 1) ? std::atol(argv[1]) : 20000000;
+    if (n <= 0) n = 20000000;
+    int tamanoVentana = (argc > 2) ? std::atoi(argv[2]) : 4096;
+    if (tamanoVentana <= 0) tamanoVentana = 4096;
+    const char* ruta = (argc > 3) ? argv[3] : "bench_ventana.txt";
+    
+    std::cout << n << " tramas (90% LOAD, 10% MAP), ventana de " << tamanoVentana << " tramas" << std::endl;
+    std::printf("%-22s %15s ", "", "");
+    for (int p = 0; p < PUNTOS_MEDICION; p++) std::printf(" %7ld%% KB", 100L * (p + 1) / PUNTOS_MEDICION);
+    std::printf("\n");
+    
+    size_t memoria[PUNTOS_MEDICION];
+    ListaDeCarga completa;
+    imprimirFila("sin ventana", insertar(completa, n, memoria), n, memoria);
+    
+    ListaDeCarga enMemoria;
+    enMemoria.setVentana(tamanoVentana);
+    imprimirFila("ventana, texto en RAM", insertar(enMemoria, n, memoria), n, memoria);
+    
+    ListaDeCarga derramada;
+    if (!derramada.setVentana(tamanoVentana, ruta)) return 1;
+    imprimirFila("ventana con derrame", insertar(derramada, n, memoria), n, memoria);
+    
+    bool correcto = derramada.getTamano() <= tamanoVentana + tamanoVentana / 4 + TRAMAS_POR_NODO &&
+                    derramada.getTramasTotales() == n;
+    std::cout << "Retenidas: " << derramada.getTamano() << " tramas; compactadas: "
+              << derramada.getCompactado().tramas << " (" << derramada.getCompactado().cargas
+              << " caracteres)" << std::endl;
+    
+    // El mensaje de toda la sesión no cambia por compactar
+    std::string esperado = decodificarCompleta(completa);
+    correcto = decodificarVentana(enMemoria) == esperado && correcto;
+    correcto = decodificarVentana(derramada) == esperado && correcto;
+    
+    // Ediciones dentro de la ventana, con el mensaje recortado como en main
+    MensajeDecodificado mensaje;
+    mensaje.agregar(esperado.data(), static_cast<long>(esperado.size()));
+    mensaje.descartarInicio(enMemoria.getCompactado().cargas);
+    correcto = verificarEdiciones(completa, enMemoria, mensaje) && correcto;
+    
+    unlink(ruta);
+    if (!correcto) {
+        std::cerr << "Error: la lista con ventana no reproduce el mensaje completo" << std::endl;
+        return 1;
+    }
+    std::cout << "El texto compactado más la ventana coincide con el mensaje completo" << std::endl;
+    return 0;
+}
@@ -0,0 +1,438 @@
+/**
+ * @file prt7_bench.cpp
+ * @brief Suite de benchmarks del núcleo PRT-7 con salida JSON
+ * @author Eliezer Mores Oyervides
+ *
+ * Genera una sesión sintética (proporción LOAD/MAP, magnitud de las
+ * rotaciones y longitud configurables) y mide sobre ella el parser, el
+ * rotor, la lista y el decodificado completo. Para cada caso reporta
+ * ns/trama, tramas/s y asignaciones de memoria por trama (contadas
+ * reemplazando el operator new global), tomando la mejor de varias
+ * repeticiones.
+ *
+ * Uso: prt7_bench [--tramas N] [--proporcion-map P] [--magnitud R]
+ *                 [--semilla S] [--repeticiones K] [--json archivo|-]
+ */
+
+#include "FormatoBinario.h"
+#include "GeneradorSintetico.h"
+#include "ListaDeCarga.h"
+#include "ParseoBloque.h"
+#include "RotorDeMapeo.h"
+#include "Tramas.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <streambuf>
+
+#ifndef PRT7_VERSION
+#define PRT7_VERSION "desconocida"
+#endif
+
+namespace {
+
+std::atomic<long> asignaciones(0); ///< Llamadas a operator new desde el inicio
+
+/**
+ * @brief Reserva memoria contando la asignación
+ */
+void* reservarContado(std::size_t bytes) {
+    asignaciones.fetch_add(1, std::memory_order_relaxed);
+    void* p = std::malloc(bytes == 0 ? 1 : bytes);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+} // namespace
+
+void* operator new(std::size_t bytes) {
+    return reservarContado(bytes);
+}
+
+void* operator new[](std::size_t bytes) {
+    return reservarContado(bytes);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+/**
+ * @brief Parámetros del generador de sesiones sintéticas
+ */
+struct ConfiguracionSintetica {
+    long tramas;          ///< Longitud de la sesión
+    double proporcionMap; ///< Fracción de tramas MAP (0 a 1)
+    int magnitud;         ///< Las rotaciones van de -magnitud a +magnitud
+    unsigned int semilla; ///< Semilla del generador
+};
+
+/**
+ * @brief Sesión sintética en forma compacta, en texto y en binario
+ */
+struct SesionSintetica {
+    TramaCompacta* tramas; ///< Tramas generadas
+    long numeroTramas;     ///< Número de tramas
+    long cargas;           ///< Número de tramas LOAD
+    char* caracteres;      ///< Caracteres de las tramas LOAD, en orden
+    int* rotaciones;       ///< Rotaciones de las tramas MAP, en orden
+    char* texto;           ///< Sesión en texto, "L,A\n" por línea
+    long bytesTexto;       ///< Bytes de texto
+    char* binario;         ///< Sesión en formato binario
+    long bytesBinario;     ///< Bytes binarios
+};
+
+/**
+ * @brief Generador xorshift32: rápido y reproducible entre plataformas
+ */
+unsigned int siguienteAleatorio(unsigned int& estado) {
+    estado ^= estado << 13;
+    estado ^= estado >> 17;
+    estado ^= estado << 5;
+    return estado;
+}
+
+void generarSesion(const ConfiguracionSintetica& config, SesionSintetica& sesion) {
+    long n = config.tramas;
+    sesion.tramas = new TramaCompacta[n];
+    sesion.numeroTramas = n;
+    sesion.caracteres = new char[n];
+    sesion.rotaciones = new int[n];
+    sesion.texto = new char[n * 16];
+    sesion.binario = new char[n * MAX_TRAMA_BINARIA];
+    sesion.cargas = 0;
+    sesion.bytesTexto = 0;
+    sesion.bytesBinario = 0;
+    
+    unsigned int estado = (config.semilla != 0) ? config.semilla : 1;
+    unsigned int umbralMap = static_cast<unsigned int>(config.proporcionMap * 4294967295.0);
+    long mapas = 0;
+    
+    for (long i = 0; i < n; i++) {
+        TramaCompacta trama;
+        if (siguienteAleatorio(estado) < umbralMap) {
+            int rango = 2 * config.magnitud + 1;
+            int rotacion = static_cast<int>(siguienteAleatorio(estado) % rango) - config.magnitud;
+            trama = TramaCompacta::map(rotacion);
+            sesion.rotaciones[mapas++] = rotacion;
+        } else {
+            // Letras A-Z y de vez en cuando un espacio, como los mensajes reales
+            unsigned int r = siguienteAleatorio(estado) % 27;
+            trama = TramaCompacta::load(r == 26 ? ' ' : static_cast<char>('A' + r));
+            sesion.caracteres[sesion.cargas++] = trama.caracter;
+        }
+        
+        sesion.tramas[i] = trama;
+        sesion.bytesTexto += escribirTramaTexto(trama, sesion.texto + sesion.bytesTexto);
+        sesion.texto[sesion.bytesTexto++] = '\n';
+        sesion.bytesBinario += codificarTramaBinaria(
+            trama, reinterpret_cast<unsigned char*>(sesion.binario + sesion.bytesBinario));
+    }
+}
+
+void liberarSesion(SesionSintetica& sesion) {
+    delete[] sesion.tramas;
+    delete[] sesion.caracteres;
+    delete[] sesion.rotaciones;
+    delete[] sesion.texto;
+    delete[] sesion.binario;
+}
+
+/**
+ * @brief Resultado de un caso del benchmark
+ */
+struct Resultado {
+    const char* nombre;          ///< Identificador estable del caso (se usa en el JSON)
+    long tramas;                 ///< Tramas procesadas por repetición
+    double nsPorTrama;           ///< Mejor tiempo por trama
+    double asignacionesPorTrama; ///< Llamadas a new por trama en la mejor repetición
+    long verificacion;           ///< Valor derivado de la salida para que no se optimice
+};
+
+/**
+ * @brief Mide una función repetidamente y se queda con la mejor repetición
+ * @param nombre Identificador del caso
+ * @param tramas Tramas procesadas por cada llamada
+ * @param repeticiones Número de repeticiones
+ * @param caso Objeto con long operator()() que ejecuta el caso
+ */
+template <typename Caso>
+Resultado medir(const char* nombre, long tramas, int repeticiones, Caso caso) {
+    Resultado resultado;
+    resultado.nombre = nombre;
+    resultado.tramas = tramas;
+    resultado.nsPorTrama = 0;
+    resultado.asignacionesPorTrama = 0;
+    resultado.verificacion = 0;
+    
+    for (int r = 0; r < repeticiones; r++) {
+        long antes = asignaciones.load(std::memory_order_relaxed);
+        std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+        long verificacion = caso();
+        double segundos = segundosDesde(inicio);
+        long hechas = asignaciones.load(std::memory_order_relaxed) - antes;
+        
+        double ns = segundos * 1e9 / tramas;
+        if (r == 0 || ns < resultado.nsPorTrama) {
+            resultado.nsPorTrama = ns;
+            resultado.asignacionesPorTrama = static_cast<double>(hechas) / tramas;
+        }
+        resultado.verificacion = verificacion;
+    }
+    return resultado;
+}
+
+/**
+ * @brief Buffer de salida que descarta todo (para procesarTramas, que imprime)
+ */
+class SalidaNula : public std::streambuf {
+protected:
+    int overflow(int c) { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) { return n; }
+};
+
+long parsearTexto(const SesionSintetica& sesion) {
+    long suma = 0;
+    const char* actual = sesion.texto;
+    const char* fin = sesion.texto + sesion.bytesTexto;
+    while (actual < fin) {
+        const char* finLinea = static_cast<const char*>(std::memchr(actual, '\n', fin - actual));
+        TramaCompacta trama;
+        if (parsearTrama(actual, static_cast<int>(finLinea - actual), trama)) {
+            suma += trama.caracter + trama.rotacion;
+        }
+        actual = finLinea + 1;
+    }
+    return suma;
+}
+
+long parsearTextoBloque(const SesionSintetica& sesion) {
+    long suma = 0;
+    TramaCompacta lote[TRAMAS_POR_LOTE];
+    size_t desplazamiento = 0;
+    size_t bytes = static_cast<size_t>(sesion.bytesTexto);
+    while (desplazamiento < bytes) {
+        ResultadoParseo resultado = parsearBloque(sesion.texto + desplazamiento, bytes - desplazamiento,
+                                                  lote, TRAMAS_POR_LOTE, true);
+        for (int i = 0; i < resultado.tramas; i++) suma += lote[i].caracter + lote[i].rotacion;
+        desplazamiento += resultado.consumidos;
+    }
+    return suma;
+}
+
+long parsearBinario(const SesionSintetica& sesion) {
+    long suma = 0;
+    const char* actual = sesion.binario;
+    const char* fin = sesion.binario + sesion.bytesBinario;
+    while (actual < fin) {
+        int bytes = longitudTramaBinaria(static_cast<unsigned char>(*actual));
+        TramaCompacta trama;
+        if (parsearTrama(actual, bytes, trama)) {
+            suma += trama.caracter + trama.rotacion;
+        }
+        actual += bytes;
+    }
+    return suma;
+}
+
+/**
+ * @brief Camino completo sin E/S: separar líneas, parsear, almacenar y decodificar
+ */
+long extremoAExtremo(const char* datos, long bytes, bool binario) {
+    ListaDeCarga lista;
+    const char* actual = datos;
+    const char* fin = datos + bytes;
+    while (actual < fin) {
+        int longitud;
+        const char* siguiente;
+        if (binario) {
+            longitud = longitudTramaBinaria(static_cast<unsigned char>(*actual));
+            siguiente = actual + longitud;
+        } else {
+            const char* finLinea = static_cast<const char*>(std::memchr(actual, '\n', fin - actual));
+            longitud = static_cast<int>(finLinea - actual);
+            siguiente = finLinea + 1;
+        }
+        
+        if (esTramaFin(actual, longitud)) break;
+        TramaCompacta trama;
+        if (parsearTrama(actual, longitud, trama)) {
+            lista.insertarAlFinal(trama);
+        }
+        actual = siguiente;
+    }
+    
+    RotorDeMapeo rotor;
+    char* mensaje = new char[lista.getTamano() + 1];
+    long longitudMensaje = lista.decodificarMensaje(&rotor, mensaje);
+    long suma = longitudMensaje + mensaje[longitudMensaje / 2];
+    delete[] mensaje;
+    return suma;
+}
+
+void imprimirJSON(FILE* archivo, const ConfiguracionSintetica& config, const SesionSintetica& sesion,
+                  const Resultado* resultados, int numeroResultados) {
+    std::fprintf(archivo, "{\n");
+    std::fprintf(archivo, "  \"version\": \"%s\",\n", PRT7_VERSION);
+    std::fprintf(archivo, "  \"configuracion\": {\n");
+    std::fprintf(archivo, "    \"tramas\": %ld,\n", config.tramas);
+    std::fprintf(archivo, "    \"proporcion_map\": %.6f,\n", config.proporcionMap);
+    std::fprintf(archivo, "    \"magnitud\": %d,\n", config.magnitud);
+    std::fprintf(archivo, "    \"semilla\": %u,\n", config.semilla);
+    std::fprintf(archivo, "    \"bytes_texto\": %ld,\n", sesion.bytesTexto);
+    std::fprintf(archivo, "    \"bytes_binario\": %ld\n", sesion.bytesBinario);
+    std::fprintf(archivo, "  },\n");
+    std::fprintf(archivo, "  \"resultados\": [\n");
+    for (int i = 0; i < numeroResultados; i++) {
+        const Resultado& r = resultados[i];
+        std::fprintf(archivo,
+                     "    {\"nombre\": \"%s\", \"tramas\": %ld, \"ns_por_trama\": %.4f, "
+                     "\"tramas_por_segundo\": %.0f, \"asignaciones_por_trama\": %.6f}%s\n",
+                     r.nombre, r.tramas, r.nsPorTrama, 1e9 / r.nsPorTrama,
+                     r.asignacionesPorTrama, (i + 1 < numeroResultados) ? "," : "");
+    }
+    std::fprintf(archivo, "  ]\n");
+    std::fprintf(archivo, "}\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    ConfiguracionSintetica config;
+    config.tramas = 5000000;
+    config.proporcionMap = 1.0 / 16;
+    config.magnitud = 100;
+    config.semilla = 2025;
+    int repeticiones = 5;
+    const char* rutaJSON = nullptr;
+    
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (std::strcmp(argv[i], "--tramas") == 0) config.tramas = std::atol(argv[i + 1]);
+        else if (std::strcmp(argv[i], "--proporcion-map") == 0) config.proporcionMap = std::atof(argv[i + 1]);
+        else if (std::strcmp(argv[i], "--magnitud") == 0) config.magnitud = std::atoi(argv[i + 1]);
+        else if (std::strcmp(argv[i], "--semilla") == 0) config.semilla = std::strtoul(argv[i + 1], nullptr, 10);
+        else if (std::strcmp(argv[i], "--repeticiones") == 0) repeticiones = std::atoi(argv[i + 1]);
+        else if (std::strcmp(argv[i], "--json") == 0) rutaJSON = argv[i + 1];
+        else {
+            std::cerr << "Opción desconocida: " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+    if (config.tramas <= 0) config.tramas = 5000000;
+    if (config.proporcionMap < 0) config.proporcionMap = 0;
+    if (config.proporcionMap > 1) config.proporcionMap = 1;
+    if (config.magnitud < 0) config.magnitud = -config.magnitud;
+    if (repeticiones <= 0) repeticiones = 1;
+    
+    SesionSintetica sesion;
+    generarSesion(config, sesion);
+    long n = sesion.numeroTramas;
+    long mapas = n - sesion.cargas;
+    
+    const int MAX_RESULTADOS = 16;
+    Resultado resultados[MAX_RESULTADOS];
+    int numeroResultados = 0;
+    
+    // Parser
+    resultados[numeroResultados++] = medir("parsear_texto", n, repeticiones,
+        [&]() { return parsearTexto(sesion); });
+    resultados[numeroResultados++] = medir("parsear_texto_bloque", n, repeticiones,
+        [&]() { return parsearTextoBloque(sesion); });
+    resultados[numeroResultados++] = medir("parsear_binario", n, repeticiones,
+        [&]() { return parsearBinario(sesion); });
+    
+    // Rotor
+    if (sesion.cargas > 0) {
+        resultados[numeroResultados++] = medir("rotor_getMapeo", sesion.cargas, repeticiones, [&]() {
+            RotorDeMapeo rotor;
+            rotor.rotar(7);
+            long suma = 0;
+            for (long i = 0; i < sesion.cargas; i++) suma += rotor.getMapeo(sesion.caracteres[i]);
+            return suma;
+        });
+    }
+    if (mapas > 0) {
+        resultados[numeroResultados++] = medir("rotor_rotar", mapas, repeticiones, [&]() {
+            RotorDeMapeo rotor;
+            for (long i = 0; i < mapas; i++) rotor.rotar(sesion.rotaciones[i]);
+            return static_cast<long>(rotor.getMapeo('A'));
+        });
+    }
+    
+    // Lista
+    resultados[numeroResultados++] = medir("lista_insertarAlFinal", n, repeticiones, [&]() {
+        ListaDeCarga lista;
+        for (long i = 0; i < n; i++) lista.insertarAlFinal(sesion.tramas[i]);
+        return static_cast<long>(lista.getTamano());
+    });
+    
+    ListaDeCarga lista;
+    for (long i = 0; i < n; i++) lista.insertarAlFinal(sesion.tramas[i]);
+    char* mensaje = new char[n + 1];
+    
+    resultados[numeroResultados++] = medir("lista_decodificarMensaje", n, repeticiones, [&]() {
+        RotorDeMapeo rotor;
+        return static_cast<long>(lista.decodificarMensaje(&rotor, mensaje));
+    });
+    
+    // procesarTramas imprime una línea por trama: se mide con la salida descartada
+    SalidaNula nula;
+    std::streambuf* salidaOriginal = std::cout.rdbuf(&nula);
+    resultados[numeroResultados++] = medir("lista_procesarTramas", n, repeticiones, [&]() {
+        RotorDeMapeo rotor;
+        lista.procesarTramas(&rotor);
+        return static_cast<long>(rotor.getMapeo('A'));
+    });
+    std::cout.rdbuf(salidaOriginal);
+    
+    // Camino completo
+    resultados[numeroResultados++] = medir("extremo_a_extremo_texto", n, repeticiones,
+        [&]() { return extremoAExtremo(sesion.texto, sesion.bytesTexto, false); });
+    resultados[numeroResultados++] = medir("extremo_a_extremo_binario", n, repeticiones,
+        [&]() { return extremoAExtremo(sesion.binario, sesion.bytesBinario, true); });
+    
+    delete[] mensaje;
+    
+    if (rutaJSON != nullptr) {
+        FILE* archivo = (std::strcmp(rutaJSON, "-") == 0) ? stdout : std::fopen(rutaJSON, "w");
+        if (archivo == nullptr) {
+            std::cerr << "Error: No se pudo crear " << rutaJSON << std::endl;
+            liberarSesion(sesion);
+            return 1;
+        }
+        imprimirJSON(archivo, config, sesion, resultados, numeroResultados);
+        if (archivo != stdout) std::fclose(archivo);
+    }
+    
+    if (rutaJSON == nullptr || std::strcmp(rutaJSON, "-") != 0) {
+        std::printf("PRT-7 %s  tramas=%ld  MAP=%.3f  magnitud=%d\n", PRT7_VERSION, n,
+                    config.proporcionMap, config.magnitud);
+        std::printf("%-28s %12s %14s %12s\n", "caso", "ns/trama", "tramas/s", "new/trama");
+        for (int i = 0; i < numeroResultados; i++) {
+            const Resultado& r = resultados[i];
+            std::printf("%-28s %12.3f %14.0f %12.5f\n", r.nombre, r.nsPorTrama,
+                        1e9 / r.nsPorTrama, r.asignacionesPorTrama);
+        }
+    }
+    
+    liberarSesion(sesion);
+    return 0;
+}
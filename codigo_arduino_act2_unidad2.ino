@@ -25,6 +25,17 @@ const char* tramas[] = {
 };
 
 const int numTramas = 12;
+
+// true: enviar las tramas en el formato binario compacto (ver FormatoBinario.h)
+// false: enviar las líneas de texto "L,X" / "M,N"
+const bool formatoBinario = false;
+
+// Etiquetas del formato binario
+const byte ETIQUETA_LOAD = 0x80;
+const byte ETIQUETA_LOAD_EXTENDIDO = 0xDF;
+const byte ETIQUETA_MAP = 0xE0;
+const byte ETIQUETA_SINCRONIA = 0xF0;
+const byte ETIQUETA_FIN = 0xFF;
 int indiceActual = 0;
 bool transmisionCompletada = false;
 
@@ -37,13 +48,22 @@ void setup() {
   
   Serial.println("Arduino PRT-7 - Iniciando transmision...");
   delay(1000);
+  
+  // Anunciar el formato binario al receptor
+  if (formatoBinario) {
+    Serial.write(ETIQUETA_SINCRONIA);
+  }
 }
 
 void loop() {
   if (!transmisionCompletada) {
     if (indiceActual < numTramas) {
       // Enviar la trama actual
-      Serial.println(tramas[indiceActual]);
+      if (formatoBinario) {
+        enviarTramaBinaria(tramas[indiceActual]);
+      } else {
+        Serial.println(tramas[indiceActual]);
+      }
       
       // Avanzar al siguiente índice
       indiceActual++;
@@ -52,7 +72,11 @@ void loop() {
       delay(1000);
     } else {
       // Todas las tramas enviadas
-      Serial.println("END");
+      if (formatoBinario) {
+        Serial.write(ETIQUETA_FIN);
+      } else {
+        Serial.println("END");
+      }
       transmisionCompletada = true;
       Serial.println("Transmision completada.");
     }
@@ -75,3 +99,47 @@ void enviarTramaMapeo(char tipo, int rotacion) {
   Serial.print(',');
   Serial.println(rotacion);
 }
+
+/**
+ * Envía una trama LOAD en formato binario: un byte para los caracteres
+ * imprimibles, tres bytes para los demás
+ */
+void enviarLoadBinario(char dato) {
+  byte c = (byte)dato;
+  if (c >= 0x20 && c < 0x7F) {
+    Serial.write((byte)(ETIQUETA_LOAD + (c - 0x20)));
+  } else {
+    Serial.write(ETIQUETA_LOAD_EXTENDIDO);
+    Serial.write((byte)(c & 0x7F));
+    Serial.write((byte)(c >> 7));
+  }
+}
+
+/**
+ * Envía una trama MAP en formato binario: la rotación en zigzag,
+ * 7 bits por byte, precedida por una etiqueta con el número de bytes
+ */
+void enviarMapBinario(long rotacion) {
+  unsigned long zigzag = ((unsigned long)rotacion << 1) ^ (rotacion < 0 ? 0xFFFFFFFFUL : 0UL);
+  byte carga[5];
+  byte bytes = 0;
+  do {
+    carga[bytes++] = zigzag & 0x7F;
+    zigzag >>= 7;
+  } while (zigzag != 0);
+  
+  Serial.write((byte)(ETIQUETA_MAP + bytes));
+  Serial.write(carga, bytes);
+}
+
+/**
+ * Convierte una trama de texto ("L,H", "L,Space", "M,-2") y la envía en binario
+ */
+void enviarTramaBinaria(const char* trama) {
+  const char* dato = trama + 2;
+  if (trama[0] == 'L') {
+    enviarLoadBinario(strcmp(dato, "Space") == 0 ? ' ' : dato[0]);
+  } else if (trama[0] == 'M') {
+    enviarMapBinario(atol(dato));
+  }
+}
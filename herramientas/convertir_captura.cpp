@@ -0,0 +1,114 @@
+/**
+ * @file convertir_captura.cpp
+ * @brief Convierte capturas PRT-7 entre el formato de texto y el binario
+ * @author Eliezer Mores Oyervides
+ *
+ * Lee la captura con ReproductorCaptura (que detecta el formato de entrada)
+ * y la escribe en el otro formato, o en el indicado con --texto/--binario.
+ * La salida binaria empieza con el byte de sincronía y termina con END
+ * si la entrada lo tenía.
+ *
+ * Uso: prt7_convertir [--texto | --binario] entrada salida
+ */
+
+#include "FormatoBinario.h"
+#include "ListaDeCarga.h"
+#include "ReproductorCaptura.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+/**
+ * @brief Visitante que escribe cada trama en texto, una por línea
+ */
+struct EscritorTexto {
+    FILE* archivo; ///< Archivo de salida
+
+    void visitarLoad(char c) { escribir(TramaCompacta::load(c)); }
+    void visitarMap(int n) { escribir(TramaCompacta::map(n)); }
+
+    void escribir(const TramaCompacta& trama) {
+        char texto[16];
+        int n = escribirTramaTexto(trama, texto);
+        texto[n++] = '\n';
+        std::fwrite(texto, 1, n, archivo);
+    }
+};
+
+/**
+ * @brief Visitante que escribe cada trama en formato binario
+ */
+struct EscritorBinario {
+    FILE* archivo; ///< Archivo de salida
+
+    void visitarLoad(char c) { escribir(TramaCompacta::load(c)); }
+    void visitarMap(int n) { escribir(TramaCompacta::map(n)); }
+
+    void escribir(const TramaCompacta& trama) {
+        unsigned char bytes[MAX_TRAMA_BINARIA];
+        std::fwrite(bytes, 1, codificarTramaBinaria(trama, bytes), archivo);
+    }
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int formato = 0; // 0: el contrario de la entrada, 1: texto, 2: binario
+    int primero = 1;
+    if (argc > 1 && std::strcmp(argv[1], "--texto") == 0) {
+        formato = 1;
+        primero = 2;
+    } else if (argc > 1 && std::strcmp(argv[1], "--binario") == 0) {
+        formato = 2;
+        primero = 2;
+    }
+
+    if (argc - primero != 2) {
+        std::cerr << "Uso: " << argv[0] << " [--texto | --binario] entrada salida" << std::endl;
+        return 1;
+    }
+
+    ReproductorCaptura reproductor;
+    if (!reproductor.abrir(argv[primero])) return 1;
+
+    ListaDeCarga lista;
+    EstadisticasReproduccion estadisticas = reproductor.reproducir(lista);
+
+    if (formato == 0) {
+        // Detectar el formato de la entrada por su primer byte
+        FILE* entrada = std::fopen(argv[primero], "rb");
+        int byte = (entrada != nullptr) ? std::fgetc(entrada) : EOF;
+        if (entrada != nullptr) std::fclose(entrada);
+        formato = (byte != EOF && esEtiquetaBinaria(static_cast<char>(byte))) ? 1 : 2;
+    }
+
+    FILE* salida = std::fopen(argv[primero + 1], "wb");
+    if (salida == nullptr) {
+        std::cerr << "Error: No se pudo crear " << argv[primero + 1] << std::endl;
+        return 1;
+    }
+
+    if (formato == 1) {
+        EscritorTexto escritor = { salida };
+        lista.recorrer(escritor);
+        if (estadisticas.finEncontrado) std::fputs("END\n", salida);
+    } else {
+        std::fputc(ETIQUETA_SINCRONIA, salida);
+        EscritorBinario escritor = { salida };
+        lista.recorrer(escritor);
+        if (estadisticas.finEncontrado) std::fputc(ETIQUETA_FIN, salida);
+    }
+
+    long bytesSalida = std::ftell(salida);
+    std::fclose(salida);
+
+    std::cout << estadisticas.tramas << " tramas: " << estadisticas.bytes << " bytes -> "
+              << bytesSalida << " bytes (" << (formato == 1 ? "texto" : "binario") << ")"
+              << std::endl;
+    if (estadisticas.lineasInvalidas > 0) {
+        std::cout << estadisticas.lineasInvalidas << " lineas invalidas omitidas" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,487 @@
+/**
+ * @file simulador_arduino.cpp
+ * @brief Emisor PRT-7 en un pseudo-terminal para pruebas de carga y latencia
+ * @author Eliezer Mores Oyervides
+ *
+ * Hace de Arduino sin hardware: abre un par pty, publica la ruta del
+ * esclavo (opcionalmente como enlace simbólico) y, cuando el decodificador
+ * la abre, le envía tramas de texto a la tasa pedida, en ráfagas, con la
+ * mezcla LOAD/MAP y la cantidad indicadas, y termina con END.
+ *
+ * Cada trama lleva ";s=N" (secuencia) y ";t=ns" (reloj monótono al
+ * enviarla), que DecodificadorPRT7 compilado con PRT7_INSTRUMENTACION usa
+ * para contar tramas perdidas y medir la latencia desde el emisor
+ * (etapa "desde_emisor" del volcado de métricas).
+ *
+ * Si el decodificador no alcanza a leer, el buffer del pty se llena. Por
+ * defecto el simulador espera (y reporta cuánto); con --perder descarta
+ * la trama como haría una UART desbordada, y el decodificador ve el hueco
+ * en la secuencia. Al terminar reporta tramas/s sostenidas, esperas y
+ * tramas perdidas; --esperado escribe el mensaje que debió decodificarse.
+ *
+ * Con --carriles N el flujo se reparte en N pseudo-terminales (enlaces
+ * ruta.0, ruta.1, ...): la trama s sale por el carril s % N, cada carril
+ * desde su propio hilo y con --tasa como límite propio, como N enlaces
+ * seriales de un mismo emisor. Se decodifica con
+ * "DecodificadorPRT7 --carriles ruta.0 ruta.1 ...".
+ *
+ * Uso: prt7_simulador [--tramas N] [--tasa tramas/s] [--rafaga N] [--mapas %]
+ *                     [--perder] [--sin-marcas] [--enlace ruta] [--esperado archivo]
+ *                     [--semilla N] [--carriles N]
+ */
+
+#include "RotorDeMapeo.h"
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <iostream>
+#include <poll.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief Se pone en 1 con SIGINT o SIGTERM
+ */
+volatile std::sig_atomic_t interrumpido = 0;
+
+void alInterrumpir(int) {
+    interrumpido = 1;
+}
+
+/**
+ * @brief Bytes máximos de una trama con sus marcas
+ */
+const int MAX_TRAMA_SIMULADA = 64;
+
+/**
+ * @brief Carriles máximos (los que admite DecodificadorPRT7 --carriles)
+ */
+const int MAX_CARRILES_SIMULADOS = 16;
+
+/**
+ * @brief Milisegundos entre que el decodificador abre el pty y el primer envío
+ *
+ * SerialReader::conectar() vacía el buffer del puerto tras configurarlo;
+ * lo que llegue antes se perdería.
+ */
+const int MS_ANTES_DE_ENVIAR = 500;
+
+/**
+ * @brief Opciones de la simulación
+ */
+struct OpcionesSimulador {
+    long tramas;             ///< Tramas a enviar (0: hasta SIGINT)
+    long tasa;               ///< Tramas por segundo (0: tan rápido como se pueda)
+    int rafaga;              ///< Tramas que se envían juntas en cada escritura
+    int porcentajeMapas;     ///< Porcentaje de tramas MAP
+    bool perder;             ///< Descartar tramas cuando el pty está lleno
+    bool marcas;             ///< Agregar ";s=" y ";t="
+    const char* enlace;      ///< Enlace simbólico al esclavo (nullptr sin él)
+    const char* esperado;    ///< Archivo para el mensaje esperado (nullptr sin él)
+    unsigned int semilla;    ///< Semilla del generador
+    int carriles;            ///< Pseudo-terminales entre los que se reparte el flujo
+};
+
+/**
+ * @brief Resultados de la simulación
+ */
+struct ResultadosSimulador {
+    long enviadas;           ///< Tramas escritas completas
+    long perdidas;           ///< Tramas descartadas por pty lleno (--perder)
+    long esperas;            ///< Veces que el pty estuvo lleno
+    double segundosEsperando; ///< Tiempo bloqueado esperando espacio
+    long long bytes;         ///< Bytes escritos
+};
+
+/**
+ * @brief Un carril: su pseudo-terminal y lo que envió
+ */
+struct CarrilSimulado {
+    int maestro;             ///< Lado maestro del pty
+    std::string esclavo;     ///< Ruta del esclavo
+    std::string enlace;      ///< Enlace simbólico al esclavo (vacío sin él)
+    ResultadosSimulador resultados; ///< Contadores del carril
+    std::string enviadas;    ///< Por cada trama del carril, '1' si salió completa
+};
+
+/**
+ * @brief Reloj monótono en ns (el mismo que ahoraNs() del decodificador)
+ */
+unsigned long long relojNs() {
+    return static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * @brief Contenido de la trama de una secuencia: depende solo de la semilla y la secuencia
+ *
+ * Así cada carril genera sus tramas sin compartir estado, y el mensaje
+ * esperado se reconstruye en orden al final.
+ */
+unsigned int mezclar(unsigned int semilla, long secuencia) {
+    unsigned long long x = (static_cast<unsigned long long>(semilla) << 32) ^
+                           static_cast<unsigned long long>(secuencia);
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return static_cast<unsigned int>(x);
+}
+
+/**
+ * @brief Genera la trama de una secuencia (rotacion o caracter dicen cuál fue, para el mensaje esperado)
+ * @return Bytes de la trama (con "\r\n")
+ */
+int generarTrama(const OpcionesSimulador& opciones, long secuencia, char* trama, int& rotacion, char& caracter) {
+    unsigned int r = mezclar(opciones.semilla, secuencia) >> 8;
+    int n;
+    if (static_cast<int>(r % 100) < opciones.porcentajeMapas) {
+        rotacion = static_cast<int>((r >> 7) % 25) - 12;
+        caracter = 0;
+        n = std::snprintf(trama, MAX_TRAMA_SIMULADA, "M,%d", rotacion);
+    } else {
+        unsigned int letra = (r >> 7) % 27;
+        caracter = (letra == 26) ? ' ' : static_cast<char>('A' + letra);
+        rotacion = 0;
+        n = (caracter == ' ') ? std::snprintf(trama, MAX_TRAMA_SIMULADA, "L,Space")
+                              : std::snprintf(trama, MAX_TRAMA_SIMULADA, "L,%c", caracter);
+    }
+    if (opciones.marcas) {
+        n += std::snprintf(trama + n, MAX_TRAMA_SIMULADA - n, ";s=%ld;t=%llu", secuencia, relojNs());
+    }
+    trama[n++] = '\r';
+    trama[n++] = '\n';
+    return n;
+}
+
+/**
+ * @brief Escribe todo el bloque, esperando espacio en el pty si hace falta
+ * @return false si el decodificador cerró el puerto o hubo un error
+ */
+bool escribirTodo(int maestro, const char* datos, int n, ResultadosSimulador& resultados) {
+    bool contada = false;
+    while (n > 0) {
+        ssize_t escritos = write(maestro, datos, n);
+        if (escritos > 0) {
+            datos += escritos;
+            n -= static_cast<int>(escritos);
+            resultados.bytes += escritos;
+            continue;
+        }
+        if (escritos < 0 && errno != EAGAIN && errno != EINTR) return false;
+        if (interrumpido) return false;
+
+        // pty lleno: el decodificador no está leyendo al ritmo del emisor
+        if (!contada) {
+            resultados.esperas++;
+            contada = true;
+        }
+        std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+        struct pollfd espera = { maestro, POLLOUT, 0 };
+        poll(&espera, 1, 100);
+        if (espera.revents & POLLHUP) return false;
+        resultados.segundosEsperando +=
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    }
+    return true;
+}
+
+/**
+ * @brief Espera a que el decodificador abra el esclavo
+ *
+ * El maestro reporta POLLHUP mientras nadie tiene abierto el esclavo, pero
+ * solo después de que alguien lo abrió alguna vez: por eso se abre y se
+ * cierra una vez antes de esperar. La pausa de MS_ANTES_DE_ENVIAR la hace
+ * quien llama, una vez que esperó a todos los carriles.
+ */
+bool esperarLector(int maestro, const char* esclavo) {
+    int propio = open(esclavo, O_RDWR | O_NOCTTY);
+    if (propio >= 0) close(propio);
+
+    while (!interrumpido) {
+        struct pollfd espera = { maestro, POLLOUT, 0 };
+        if (poll(&espera, 1, 100) > 0 && !(espera.revents & POLLHUP)) return true;
+        if (espera.revents & POLLHUP) std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    return false;
+}
+
+/**
+ * @brief Cuántas de las tramas [0, tramas) salen por un carril
+ */
+long tramasDelCarril(const OpcionesSimulador& opciones, int carril) {
+    if (opciones.tramas <= carril) return 0;
+    return (opciones.tramas - carril + opciones.carriles - 1) / opciones.carriles;
+}
+
+/**
+ * @brief Envía por un carril sus tramas (secuencias carril, carril + carriles, ...) y END
+ * @param carril Índice del carril
+ * @param inicio Instante común de la primera ráfaga de todos los carriles
+ */
+void simular(CarrilSimulado* carriles, int carril, const OpcionesSimulador& opciones,
+             std::chrono::steady_clock::time_point inicio) {
+    int maestro = carriles[carril].maestro;
+    ResultadosSimulador& resultados = carriles[carril].resultados;
+    std::string& enviadas = carriles[carril].enviadas;
+    long propias = tramasDelCarril(opciones, carril);
+    char* bloque = new char[opciones.rafaga * MAX_TRAMA_SIMULADA];
+    int* finTrama = new int[opciones.rafaga];
+    int* rotaciones = new int[opciones.rafaga];
+    char* caracteres = new char[opciones.rafaga];
+
+    // Cada ráfaga sale en su instante: inicio + k * rafaga / tasa (la tasa es por carril)
+    std::chrono::nanoseconds periodo(opciones.tasa > 0 ? 1000000000LL * opciones.rafaga / opciones.tasa : 0);
+    long indice = 0;
+    bool abierto = true;
+
+    for (long rafaga = 0; abierto && !interrumpido; rafaga++) {
+        if (opciones.tasa > 0) std::this_thread::sleep_until(inicio + periodo * rafaga);
+
+        int tramas = opciones.rafaga;
+        if (opciones.tramas > 0 && propias - indice < tramas) {
+            tramas = static_cast<int>(propias - indice);
+        }
+        if (tramas == 0) break;
+
+        int usado = 0;
+        for (int i = 0; i < tramas; i++) {
+            long secuencia = (indice + i) * opciones.carriles + carril;
+            usado += generarTrama(opciones, secuencia, bloque + usado, rotaciones[i], caracteres[i]);
+            finTrama[i] = usado;
+        }
+
+        // Con --perder se escribe lo que quepa; la trama cortada se completa y el resto se descarta
+        int completas = tramas;
+        if (opciones.perder) {
+            ssize_t escritos = write(maestro, bloque, usado);
+            if (escritos < 0 && errno != EAGAIN && errno != EINTR) break;
+            if (escritos < 0) escritos = 0;
+            resultados.bytes += escritos;
+            if (escritos < usado) {
+                resultados.esperas++;
+                completas = 0;
+                while (completas < tramas && finTrama[completas] <= escritos) completas++;
+                int inicioCortada = (completas > 0) ? finTrama[completas - 1] : 0;
+                if (completas < tramas && escritos > inicioCortada) {
+                    abierto = escribirTodo(maestro, bloque + escritos,
+                                           finTrama[completas] - static_cast<int>(escritos), resultados);
+                    completas++;
+                }
+                resultados.perdidas += tramas - completas;
+            }
+        } else {
+            abierto = escribirTodo(maestro, bloque, usado, resultados);
+        }
+
+        // Solo lo enviado cuenta para el mensaje esperado
+        enviadas.append(completas, '1');
+        enviadas.append(tramas - completas, '0');
+        resultados.enviadas += completas;
+        indice += tramas;
+    }
+
+    delete[] bloque;
+    delete[] finTrama;
+    delete[] rotaciones;
+    delete[] caracteres;
+
+    // END y un momento para que el decodificador lea lo pendiente antes del cierre
+    if (abierto) escribirTodo(maestro, "END\r\n", 5, resultados);
+    for (int i = 0; abierto && i < 50; i++) {
+        struct pollfd espera = { maestro, POLLOUT, 0 };
+        if (poll(&espera, 1, 0) > 0 && (espera.revents & POLLHUP)) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+}
+
+/**
+ * @brief Reconstruye en orden de secuencia el mensaje de las tramas que salieron completas
+ */
+std::string mensajeEsperado(const CarrilSimulado* carriles, const OpcionesSimulador& opciones) {
+    RotorDeMapeo rotor;
+    std::string mensaje;
+    char trama[MAX_TRAMA_SIMULADA];
+    for (long secuencia = 0; ; secuencia++) {
+        const std::string& enviadas = carriles[secuencia % opciones.carriles].enviadas;
+        std::string::size_type indice = static_cast<std::string::size_type>(secuencia / opciones.carriles);
+        if (indice >= enviadas.size()) break;
+        if (enviadas[indice] != '1') continue;
+
+        int rotacion;
+        char caracter;
+        generarTrama(opciones, secuencia, trama, rotacion, caracter);
+        if (caracter != 0) mensaje += rotor.getMapeo(caracter);
+        else rotor.rotar(rotacion);
+    }
+    return mensaje;
+}
+
+/**
+ * @brief Crea el pseudo-terminal de un carril y su enlace
+ */
+bool abrirCarril(CarrilSimulado& carril, const std::string& enlace) {
+    carril.maestro = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (carril.maestro < 0 || grantpt(carril.maestro) != 0 || unlockpt(carril.maestro) != 0) {
+        std::cerr << "Error: No se pudo crear el pseudo-terminal" << std::endl;
+        return false;
+    }
+    carril.esclavo = ptsname(carril.maestro);
+    if (!enlace.empty()) {
+        unlink(enlace.c_str());
+        if (symlink(carril.esclavo.c_str(), enlace.c_str()) != 0) {
+            std::cerr << "Error: No se pudo crear el enlace " << enlace << std::endl;
+            return false;
+        }
+        carril.enlace = enlace;
+    }
+    return true;
+}
+
+/**
+ * @brief Lee un entero de la línea de comandos
+ */
+bool leerEntero(const char* texto, long minimo, long& valor) {
+    char* fin;
+    valor = std::strtol(texto, &fin, 10);
+    return *fin == '\0' && valor >= minimo;
+}
+
+void mostrarUso(const char* programa) {
+    std::cerr << "Uso: " << programa << " [--tramas N] [--tasa tramas/s] [--rafaga N] [--mapas %]\n"
+              << "       [--perder] [--sin-marcas] [--enlace ruta] [--esperado archivo] [--semilla N]\n"
+              << "       [--carriles N]"
+              << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    OpcionesSimulador opciones = { 100000, 0, 1, 10, false, true, nullptr, nullptr, 2025, 1 };
+    for (int i = 1; i < argc; i++) {
+        long valor = 0;
+        bool valido = true;
+        if (std::strcmp(argv[i], "--tramas") == 0 && i + 1 < argc) {
+            valido = leerEntero(argv[++i], 0, valor);
+            opciones.tramas = valor;
+        } else if (std::strcmp(argv[i], "--tasa") == 0 && i + 1 < argc) {
+            valido = leerEntero(argv[++i], 0, valor);
+            opciones.tasa = valor;
+        } else if (std::strcmp(argv[i], "--rafaga") == 0 && i + 1 < argc) {
+            valido = leerEntero(argv[++i], 1, valor) && valor <= 4096;
+            opciones.rafaga = static_cast<int>(valor);
+        } else if (std::strcmp(argv[i], "--mapas") == 0 && i + 1 < argc) {
+            valido = leerEntero(argv[++i], 0, valor) && valor <= 100;
+            opciones.porcentajeMapas = static_cast<int>(valor);
+        } else if (std::strcmp(argv[i], "--semilla") == 0 && i + 1 < argc) {
+            valido = leerEntero(argv[++i], 0, valor);
+            opciones.semilla = static_cast<unsigned int>(valor);
+        } else if (std::strcmp(argv[i], "--carriles") == 0 && i + 1 < argc) {
+            valido = leerEntero(argv[++i], 1, valor) && valor <= MAX_CARRILES_SIMULADOS;
+            opciones.carriles = static_cast<int>(valor);
+        } else if (std::strcmp(argv[i], "--perder") == 0) {
+            opciones.perder = true;
+        } else if (std::strcmp(argv[i], "--sin-marcas") == 0) {
+            opciones.marcas = false;
+        } else if (std::strcmp(argv[i], "--enlace") == 0 && i + 1 < argc) {
+            opciones.enlace = argv[++i];
+        } else if (std::strcmp(argv[i], "--esperado") == 0 && i + 1 < argc) {
+            opciones.esperado = argv[++i];
+        } else {
+            valido = false;
+        }
+        if (!valido) {
+            mostrarUso(argv[0]);
+            return 1;
+        }
+    }
+
+    // Un carril usa --enlace tal cual; con varios, cada uno agrega su índice
+    CarrilSimulado* carriles = new CarrilSimulado[opciones.carriles];
+    for (int c = 0; c < opciones.carriles; c++) carriles[c].maestro = -1;
+    bool abiertos = true;
+    for (int c = 0; abiertos && c < opciones.carriles; c++) {
+        std::string enlace;
+        if (opciones.enlace != nullptr) {
+            enlace = opciones.enlace;
+            if (opciones.carriles > 1) enlace += "." + std::to_string(c);
+        }
+        abiertos = abrirCarril(carriles[c], enlace);
+    }
+
+    struct sigaction accion;
+    std::memset(&accion, 0, sizeof(accion));
+    accion.sa_handler = alInterrumpir;
+    sigaction(SIGINT, &accion, nullptr);
+    sigaction(SIGTERM, &accion, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    for (int c = 0; abiertos && c < opciones.carriles; c++) {
+        std::cout << (opciones.carriles > 1 ? "Carril simulado: " : "Puerto simulado: ")
+                  << (carriles[c].enlace.empty() ? carriles[c].esclavo : carriles[c].enlace) << std::endl;
+    }
+    if (abiertos) std::cout << "(esperando al decodificador...)" << std::endl;
+
+    // Todos los carriles arrancan juntos una vez que el decodificador abrió cada uno
+    bool conectado = abiertos;
+    for (int c = 0; conectado && c < opciones.carriles; c++) {
+        conectado = esperarLector(carriles[c].maestro, carriles[c].esclavo.c_str());
+    }
+    double segundos = 0;
+    if (conectado) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(MS_ANTES_DE_ENVIAR));
+        std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+        std::thread* hilos = new std::thread[opciones.carriles];
+        for (int c = 0; c < opciones.carriles; c++) {
+            hilos[c] = std::thread(simular, carriles, c, std::cref(opciones), inicio);
+        }
+        for (int c = 0; c < opciones.carriles; c++) hilos[c].join();
+        delete[] hilos;
+        segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    }
+
+    ResultadosSimulador resultados = { 0, 0, 0, 0.0, 0 };
+    for (int c = 0; c < opciones.carriles; c++) {
+        resultados.enviadas += carriles[c].resultados.enviadas;
+        resultados.perdidas += carriles[c].resultados.perdidas;
+        resultados.esperas += carriles[c].resultados.esperas;
+        resultados.segundosEsperando += carriles[c].resultados.segundosEsperando;
+        resultados.bytes += carriles[c].resultados.bytes;
+    }
+
+    std::cout << "Tramas enviadas: " << resultados.enviadas << " en " << segundos << " s ("
+              << (segundos > 0 ? resultados.enviadas / segundos : 0) << " tramas/s sostenidas, "
+              << (segundos > 0 ? resultados.bytes / segundos / 1024 : 0) << " KB/s";
+    if (opciones.carriles > 1) std::cout << " en " << opciones.carriles << " carriles";
+    std::cout << ")" << std::endl;
+    std::cout << "pty lleno: " << resultados.esperas << " veces, " << resultados.segundosEsperando
+              << " s esperando; tramas perdidas (--perder): " << resultados.perdidas << std::endl;
+
+    if (opciones.esperado != nullptr) {
+        std::string mensaje = mensajeEsperado(carriles, opciones);
+        FILE* archivo = std::fopen(opciones.esperado, "w");
+        if (archivo == nullptr) {
+            std::cerr << "Error: No se pudo escribir " << opciones.esperado << std::endl;
+        } else {
+            std::fwrite(mensaje.data(), 1, mensaje.size(), archivo);
+            std::fputc('\n', archivo);
+            std::fclose(archivo);
+        }
+    }
+
+    for (int c = 0; c < opciones.carriles; c++) {
+        if (!carriles[c].enlace.empty()) unlink(carriles[c].enlace.c_str());
+        if (carriles[c].maestro >= 0) close(carriles[c].maestro);
+    }
+    delete[] carriles;
+    return abiertos ? 0 : 1;
+}
@@ -17,189 +17,1026 @@
  * - **ListaDeCarga:** Almacena todas las tramas recibidas.
  * - **RotorDeMapeo:** Lógica de mapeo de caracteres.
  * - **TramaBase:** Clase base para polimorfismo.
+ * - **TramaCompacta:** Trama por valor que guarda la lista.
  */
 
 #include <iostream>
+#include <cerrno>
+#include <chrono>
 #include <cstring>
+#include <climits>
 #include <cstdlib>
+#include <csignal>
+#include <pthread.h>
 #include "SerialReader.h"
+#include "BucleEventos.h"
+#include "BufferReordenamiento.h"
+#include "IngestaMultipuerto.h"
+#include "ReproductorCaptura.h"
+#include "DiarioTramas.h"
+#include "FormatoBinario.h"
+#include "Instrumentacion.h"
+#include "MensajeDecodificado.h"
+#include "SalidaTramas.h"
 #include "ListaDeCarga.h"
 #include "RotorDeMapeo.h"
+#include "RotorAlfabeto.h"
+#include "CascadaRotores.h"
 #include "Tramas.h"
+#include "TuberiaDecodificacion.h"
 #include "TramaBase.h"
+#include "TramaCompacta.h"
 
 /**
- * @brief Parsea una línea de trama y crea el objeto correspondiente
- * @param linea Línea leída del puerto serial (ej: "L,A" o "M,5")
- * @return Puntero a TramaBase (TramaLoad o TramaMap), o nullptr si hay error
+ * @brief Milisegundos sin tramas tras los cuales se avisa inactividad
  */
-TramaBase* parsearTrama(char* linea) {
-    // Eliminar espacios en blanco al inicio
-    while (*linea == ' ' || *linea == '\t') linea++;
+const int MS_INACTIVIDAD = 5000;
+
+/**
+ * @brief Máximo de hilos que se aceptan con --hilos
+ */
+const int MAX_HILOS_PEDIDOS = 256;
+
+/**
+ * @brief Visitante que procesa cada trama en tiempo real y muestra el resultado
+ */
+struct ProcesadorTiempoReal {
+    RotorConfigurable& rotor;     ///< Rotor que decodifica las tramas LOAD (alfabeto de --alfabeto)
+    CascadaRotores* cascada;      ///< Cascada de --cascada, que reemplaza a rotor (nullptr sin ella)
+    MensajeDecodificado& mensaje; ///< Mensaje ensamblado hasta ahora
+    SalidaTramas& salida;         ///< Salida en consola
+    const char* texto;            ///< Texto de la trama actual (para mostrarla)
+    int longitudTexto;            ///< Caracteres de texto
+    unsigned long long marcaLectura; ///< ahoraNs() del read() que trajo la trama
+    long long secuenciaEsperada;  ///< Siguiente ";s=" del emisor (-1 antes de la primera)
     
-    if (linea[0] == '\0') return nullptr;
+    void visitarLoad(char original) {
+        // Procesar TRAMA LOAD
+        char decodificado;
+        {
+            MedicionEtapa medicion(ETAPA_ROTOR);
+            decodificado = (cascada != nullptr) ? cascada->decodificar(original) : rotor.getMapeo(original);
+        }
+        mensaje.agregar(decodificado);
+        
+        MedicionEtapa medicion(ETAPA_SALIDA);
+        salida.registrarCarga(texto, longitudTexto, original, decodificado, mensaje);
+    }
     
-    char tipo = linea[0];
+    void visitarMap(int rotacion) {
+        // Procesar TRAMA MAP y mostrar qué mapeo genera (A->?)
+        char mapeoA;
+        {
+            MedicionEtapa medicion(ETAPA_ROTOR);
+            if (cascada != nullptr) {
+                cascada->rotar(rotacion);
+                mapeoA = cascada->getMapeo('A');
+            } else {
+                rotor.rotar(rotacion);
+                mapeoA = rotor.getMapeo('A');
+            }
+        }
+        
+        MedicionEtapa medicion(ETAPA_SALIDA);
+        salida.registrarRotacion(texto, longitudTexto, rotacion, mapeoA, mensaje);
+    }
+};
+
+/**
+ * @brief Visitante que redecodifica una sesión recuperada con un alfabeto distinto de A-Z o una cascada
+ *
+ * La instantánea del diario guarda el desplazamiento de un solo rotor
+ * módulo 26; con otro alfabeto o con una cascada el estado se reconstruye
+ * recorriendo las tramas.
+ */
+struct RecuperadorSesion {
+    RotorConfigurable& rotor;     ///< Rotor que queda en el estado final de la sesión
+    CascadaRotores* cascada;      ///< Cascada que reemplaza a rotor (nullptr sin ella)
+    MensajeDecodificado& mensaje; ///< Mensaje recuperado
+    
+    void visitarLoad(char original) {
+        mensaje.agregar((cascada != nullptr) ? cascada->decodificar(original) : rotor.getMapeo(original));
+    }
+    
+    void visitarMap(int rotacion) {
+        if (cascada != nullptr) {
+            cascada->rotar(rotacion);
+        } else {
+            rotor.rotar(rotacion);
+        }
+    }
+};
+
+/**
+ * @brief Convierte un argumento numérico de la línea de comandos
+ * @param texto Argumento a convertir
+ * @param minimo Valor mínimo aceptado
+ * @param maximo Valor máximo aceptado
+ * @param valor Recibe el número convertido
+ * @return true si el texto es un entero completo dentro de [minimo, maximo]
+ */
+bool leerEntero(const char* texto, long minimo, long maximo, long& valor) {
+    char* fin;
+    errno = 0;
+    long numero = std::strtol(texto, &fin, 10);
+    if (fin == texto || *fin != '\0' || errno == ERANGE || numero < minimo || numero > maximo) return false;
+    valor = numero;
+    return true;
+}
+
+/**
+ * @brief Almacena y decodifica una trama ya parseada
+ * @param trama Trama recibida
+ * @param lista Lista donde se almacena la trama
+ * @param procesador Visitante que decodifica y muestra la trama (con su texto ya asignado)
+ * @param diario Diario en disco donde se agrega la trama (nullptr sin --diario)
+ */
+void procesarTrama(const TramaCompacta& trama, ListaDeCarga& lista,
+                   ProcesadorTiempoReal& procesador, DiarioTramas* diario) {
+    // Almacenar en la lista doblemente enlazada
+    {
+        MedicionEtapa medicion(ETAPA_INSERCION);
+        lista.insertarAlFinal(trama);
+    }
+    if (diario != nullptr) diario->agregar(trama);
     
-    // Buscar la coma
-    char* coma = linea;
-    while (*coma != '\0' && *coma != ',') coma++;
+    // Despachar según la etiqueta de la trama (sin RTTI)
+    trama.aceptar(procesador);
     
-    if (*coma != ',') {
-        return nullptr;
+    contar(CONTADOR_TRAMAS);
+    registrarLatencia(ETAPA_EXTREMO_A_EXTREMO, procesador.marcaLectura);
+}
+
+/**
+ * @brief Procesa una línea recibida: la parsea, la almacena y la decodifica
+ * @param linea Línea recibida (sin fin de línea)
+ * @param longitud Número de caracteres de la línea
+ * @param lista Lista donde se almacena la trama
+ * @param procesador Visitante que decodifica y muestra la trama
+ * @param diario Diario en disco donde se agrega la trama (nullptr sin --diario)
+ * @return false si la línea es la señal de finalización (END), true en otro caso
+ */
+bool procesarLinea(const char* linea, int longitud, ListaDeCarga& lista,
+                   ProcesadorTiempoReal& procesador, DiarioTramas* diario) {
+    // Verificar si es la señal de finalización
+    if (esTramaFin(linea, longitud)) {
+        return false;
     }
     
-    coma++; // Saltar la coma
+    // Ignorar líneas que no sean tramas válidas
+    bool binaria = esEtiquetaBinaria(linea[0]);
+    if (!binaria && linea[0] != 'L' && linea[0] != 'l' && 
+        linea[0] != 'M' && linea[0] != 'm') {
+        return true;
+    }
     
-    // Eliminar espacios después de la coma
-    while (*coma == ' ' || *coma == '\t') coma++;
+    // Parsear la trama a su forma compacta
+    TramaCompacta trama;
+    bool valida;
+    {
+        MedicionEtapa medicion(ETAPA_PARSEO);
+        valida = parsearTrama(linea, longitud, trama);
+    }
     
-    if (tipo == 'L' || tipo == 'l') {
-        // Trama LOAD
-        if (*coma == '\0') {
-            return nullptr;
+    if (valida) {
+        // Las tramas binarias se muestran con su equivalente en texto
+        char texto[16];
+        if (binaria) {
+            procesador.longitudTexto = escribirTramaTexto(trama, texto);
+            procesador.texto = texto;
+        } else {
+            procesador.texto = linea;
+            procesador.longitudTexto = longitud;
         }
+        procesarTrama(trama, lista, procesador, diario);
         
-        // Manejar "Space" como carácter especial
-        if (coma[0] == 'S' && coma[1] == 'p' && coma[2] == 'a' && 
-            coma[3] == 'c' && coma[4] == 'e') {
-            return new TramaLoad(' ');
+        // Marcas de un emisor de pruebas (prt7_simulador): latencia y huecos
+        MarcasTrama marcas;
+        if (instrumentacionActiva() && !binaria && leerMarcasTrama(linea, longitud, marcas)) {
+            if (marcas.envioNs != 0) registrarLatencia(ETAPA_DESDE_EMISOR, marcas.envioNs);
+            if (marcas.secuencia >= 0) registrarSecuencia(marcas.secuencia, procesador.secuenciaEsperada);
         }
-        
-        return new TramaLoad(coma[0]);
+    } else {
+        contar(CONTADOR_LINEAS_INVALIDAS);
     }
-    else if (tipo == 'M' || tipo == 'm') {
-        // Trama MAP
-        int rotacion = 0;
+    
+    return true;
+}
+
+/**
+ * @brief Receptor del BufferReordenamiento: procesa las tramas de los carriles ya en orden
+ *
+ * Las tramas llegan sin su línea original (el buffer guarda la forma
+ * compacta), así que se muestran con su equivalente en texto.
+ */
+struct ReceptorEnOrden {
+    ListaDeCarga& lista;              ///< Lista donde se almacenan las tramas
+    ProcesadorTiempoReal& procesador; ///< Visitante que decodifica y muestra
+    DiarioTramas* diario;             ///< Diario en disco (nullptr sin --diario)
+    
+    void entregar(const TramaCompacta& trama, unsigned long long envioNs) {
+        char texto[16];
+        procesador.longitudTexto = escribirTramaTexto(trama, texto);
+        procesador.texto = texto;
+        procesarTrama(trama, lista, procesador, diario);
+        if (envioNs != 0) registrarLatencia(ETAPA_DESDE_EMISOR, envioNs);
+    }
+};
+
+/**
+ * @brief Procesa una línea de un carril: la parsea y la pasa al buffer de reordenamiento
+ * @param linea Línea recibida (sin fin de línea)
+ * @param longitud Número de caracteres de la línea
+ * @param reorden Buffer que libera las tramas en orden de secuencia
+ * @param receptor Receptor de las tramas liberadas
+ * @return false si la línea es la señal de finalización (END) del carril, true en otro caso
+ *
+ * En modo carriles cada trama debe traer su secuencia (";s=N"); las que
+ * no la traen cuentan como líneas inválidas porque no hay forma de
+ * ubicarlas en el flujo.
+ */
+bool procesarLineaCarril(const char* linea, int longitud, BufferReordenamiento& reorden,
+                         ReceptorEnOrden& receptor) {
+    if (esTramaFin(linea, longitud)) {
+        return false;
+    }
+    if (linea[0] != 'L' && linea[0] != 'l' && linea[0] != 'M' && linea[0] != 'm') {
+        return true;
+    }
+    
+    TramaCompacta trama;
+    MarcasTrama marcas;
+    bool valida;
+    {
+        MedicionEtapa medicion(ETAPA_PARSEO);
+        valida = parsearTrama(linea, longitud, trama) && leerMarcasTrama(linea, longitud, marcas) &&
+                 marcas.secuencia >= 0;
+    }
+    
+    if (valida) {
+        reorden.agregar(marcas.secuencia, trama, marcas.envioNs, receptor);
+    } else {
+        contar(CONTADOR_LINEAS_INVALIDAS);
+    }
+    return true;
+}
+
+/**
+ * @brief Lee lo disponible en cada carril activo y lo pasa por el buffer de reordenamiento
+ * @param carriles Puertos de los carriles
+ * @param activos Carriles que aún no enviaron END ni se desconectaron
+ * @param numeroCarriles Número de carriles
+ * @param bucle Bucle de eventos del que se quitan los carriles terminados
+ * @param reorden Buffer que libera las tramas en orden de secuencia
+ * @param receptor Receptor de las tramas liberadas
+ * @param perdidos Se incrementa por cada carril que se desconecta sin END
+ * @return Carriles que siguen activos
+ *
+ * Se leen todos los carriles y no solo el que avisó epoll: así una
+ * lectura trae lo de cada carril y el hueco que deja uno se llena con lo
+ * que ya esperaba en otro.
+ */
+int leerCarriles(SerialReader* carriles, bool* activos, int numeroCarriles, BucleEventos& bucle,
+                 BufferReordenamiento& reorden, ReceptorEnOrden& receptor, int& perdidos) {
+    const char* linea;
+    int longitud;
+    int restantes = 0;
+    for (int i = 0; i < numeroCarriles; i++) {
+        if (!activos[i]) continue;
         
-        // Parsear el número (puede ser negativo)
-        bool negativo = false;
-        if (*coma == '-') {
-            negativo = true;
-            coma++;
-        } else if (*coma == '+') {
-            coma++;
+        // Como en un solo puerto: solo -1 es un carril colgado, 0 bytes es EAGAIN/EINTR
+        if (carriles[i].leerDisponible() < 0) {
+            std::cerr << "ERROR: Se perdió la conexión con el carril " << i << std::endl;
+            activos[i] = false;
+            bucle.quitarDescriptor(carriles[i].getDescriptor());
+            perdidos++;
+            continue;
         }
         
-        while (*coma >= '0' && *coma <= '9') {
-            rotacion = rotacion * 10 + (*coma - '0');
-            coma++;
+        while (activos[i] && carriles[i].extraerLinea(linea, longitud)) {
+            if (!procesarLineaCarril(linea, longitud, reorden, receptor)) {
+                activos[i] = false;
+                bucle.quitarDescriptor(carriles[i].getDescriptor());
+            }
+        }
+        if (activos[i]) restantes++;
+    }
+    
+    // Un hueco que no se llenó a tiempo no debe retener al resto
+    reorden.vencer(receptor);
+    return restantes;
+}
+
+/**
+ * @brief Modo tubería: las etapas trabajan en sus hilos y este atiende las señales
+ * @param tuberia Tubería ya construida sobre el puerto, la lista y la salida
+ * @param politica Qué hacer cuando la salida no alcanza al decodificador
+ * @param formatoMetricas Formato del volcado de métricas (SIGUSR1 y al terminar)
+ */
+void ejecutarTuberia(TuberiaDecodificacion& tuberia, PoliticaPresion politica, FormatoVolcado formatoMetricas) {
+    // Igual que en el multipuerto: las señales se bloquean antes de crear
+    // los hilos y se atienden aquí con sigtimedwait
+    sigset_t mascara;
+    sigemptyset(&mascara);
+    sigaddset(&mascara, SIGINT);
+    sigaddset(&mascara, SIGTERM);
+    sigaddset(&mascara, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &mascara, nullptr);
+    
+    tuberia.iniciar(politica, MS_INACTIVIDAD);
+    
+    struct timespec espera;
+    espera.tv_sec = 0;
+    espera.tv_nsec = 200000000L;
+    int senalRecibida = 0;
+    while (!tuberia.terminada()) {
+        int senal = sigtimedwait(&mascara, nullptr, &espera);
+        if (senal == SIGUSR1) {
+            volcarInstrumentacion(std::cerr, formatoMetricas);
+            tuberia.volcarColas(std::cerr, formatoMetricas);
+        } else if (senal > 0 && senalRecibida == 0) {
+            // Las etapas vacían sus colas antes de terminar
+            senalRecibida = senal;
+            tuberia.detener();
+        }
+    }
+    tuberia.esperar();
+    
+    if (tuberia.getFinRecibido()) {
+        std::cout << std::endl;
+        std::cout << "---" << std::endl;
+        std::cout << "Flujo de datos terminado." << std::endl;
+    } else if (senalRecibida != 0) {
+        std::cout << std::endl;
+        std::cout << "---" << std::endl;
+        std::cout << "Señal " << senalRecibida << " recibida. Cerrando decodificador." << std::endl;
+    } else if (tuberia.getDesconectado()) {
+        std::cerr << "ERROR: Se perdió la conexión con el puerto serial" << std::endl;
+    }
+    tuberia.volcarColas(std::cerr, formatoMetricas);
+}
+
+/**
+ * @brief Modo multipuerto: decodifica varios emisores PRT-7 en paralelo
+ * @param puertos Rutas de los puertos
+ * @param numeroPuertos Número de puertos
+ * @param hilos Hilos decodificadores
+ * @param formatoMetricas Formato del volcado de métricas (SIGUSR1 y al terminar)
+ * @param configuracion Velocidad, VMIN/VTIME y baja latencia de todos los puertos
+ * @return Código de salida
+ */
+int ejecutarMultipuerto(char** puertos, int numeroPuertos, int hilos, FormatoVolcado formatoMetricas,
+                        const ConfiguracionSerial& configuracion) {
+    // Las señales de terminación y de volcado se atienden con sigtimedwait en
+    // este hilo; se bloquean antes de crear los hilos para que todos las hereden
+    sigset_t mascara;
+    sigemptyset(&mascara);
+    sigaddset(&mascara, SIGINT);
+    sigaddset(&mascara, SIGTERM);
+    sigaddset(&mascara, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &mascara, nullptr);
+    
+    IngestaMultipuerto ingesta;
+    for (int i = 0; i < numeroPuertos; i++) {
+        if (!ingesta.agregarPuerto(puertos[i], configuracion)) {
+            std::cerr << "ERROR: No se pudo conectar al puerto " << puertos[i] << std::endl;
+            return 1;
+        }
+        int baudios = ingesta.getFlujo(i).serial.getBaudios();
+        if (baudios != configuracion.baudios) {
+            std::cout << puertos[i] << ": " << baudios << " baudios (se pidieron "
+                      << configuracion.baudios << ")" << std::endl;
+        }
+    }
+    
+    if (!ingesta.iniciar(hilos)) {
+        std::cerr << "ERROR: No se pudieron iniciar los hilos de ingesta" << std::endl;
+        return 1;
+    }
+    
+    std::cout << "Conectados " << numeroPuertos << " puertos. Esperando tramas..." << std::endl;
+    
+    struct timespec espera;
+    espera.tv_sec = 0;
+    espera.tv_nsec = 200000000L;
+    while (!ingesta.terminada()) {
+        int senal = sigtimedwait(&mascara, nullptr, &espera);
+        if (senal == SIGUSR1) {
+            volcarInstrumentacion(std::cerr, formatoMetricas);
+        } else if (senal > 0) {
+            std::cout << "Señal recibida. Deteniendo la ingesta..." << std::endl;
+            ingesta.detener();
         }
+    }
+    ingesta.esperar();
+    
+    if (instrumentacionActiva()) {
+        volcarInstrumentacion(std::cerr, formatoMetricas);
+    }
+    
+    // Resumen por flujo
+    for (int i = 0; i < ingesta.getNumeroFlujos(); i++) {
+        const FlujoPRT7& flujo = ingesta.getFlujo(i);
+        std::cout << "---" << std::endl;
+        std::cout << "Puerto " << flujo.nombrePuerto << ": " << flujo.tramasDecodificadas
+                  << " tramas" << (flujo.finRecibido ? "" : " (sin END)") << std::endl;
+        std::cout << "MENSAJE OCULTO ENSAMBLADO:" << std::endl;
+        std::cout << flujo.mensaje.getTexto() << std::endl;
+    }
+    std::cout << "---" << std::endl;
+    std::cout << "Liberando memoria... Sistema apagado." << std::endl;
+    
+    return 0;
+}
+
+/**
+ * @brief Modo reproducción: decodifica un archivo de captura en lugar del puerto
+ * @param ruta Ruta del archivo de captura
+ * @param hilos Hilos para la decodificación en bloque
+ * @param rangoInicio Primera trama a mostrar con --rango
+ * @param rangoFin Trama siguiente a la última con --rango (negativo: mensaje completo)
+ * @return Código de salida
+ */
+int ejecutarReproduccion(const char* ruta, int hilos, int rangoInicio, int rangoFin) {
+    ReproductorCaptura reproductor;
+    if (!reproductor.abrir(ruta)) {
+        return 1;
+    }
+    
+    ListaDeCarga lista;
+    RotorDeMapeo rotor;
+    
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    EstadisticasReproduccion estadisticas = reproductor.reproducir(lista);
+    double segundosParseo = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - inicio).count();
+    
+    if (rangoFin >= 0) {
+        // Solo el rango pedido, ubicado con el índice de la lista
+        // Recortar a las tramas de la captura antes de reservar el fragmento
+        if (rangoFin < rangoInicio) rangoFin = rangoInicio;
+        if (rangoFin > lista.getTamano()) rangoFin = lista.getTamano();
+        if (rangoInicio > rangoFin) rangoInicio = rangoFin;
+        char* fragmento = new char[rangoFin - rangoInicio + 1];
+        inicio = std::chrono::steady_clock::now();
+        lista.decodificarRango(rangoInicio, rangoFin, fragmento);
+        double microsegundos = std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - inicio).count();
         
-        if (negativo) rotacion = -rotacion;
+        std::cout << "Captura: " << ruta << " (" << estadisticas.tramas << " tramas)" << std::endl;
+        std::cout << "Tramas [" << rangoInicio << ", " << rangoFin << ") decodificadas en "
+                  << microsegundos << " us:" << std::endl;
+        std::cout << fragmento << std::endl;
+        std::cout << "---" << std::endl;
         
-        return new TramaMap(rotacion);
+        delete[] fragmento;
+        return 0;
     }
     
-    return nullptr;
+    char* mensaje = new char[lista.getTamano() + 1];
+    inicio = std::chrono::steady_clock::now();
+    lista.decodificarParalelo(&rotor, mensaje, hilos);
+    double segundosDecodificacion = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - inicio).count();
+    
+    std::cout << "Captura: " << ruta << " (" << estadisticas.bytes << " bytes, "
+              << estadisticas.tramas << " tramas, " << estadisticas.lineasInvalidas
+              << " lineas invalidas" << (estadisticas.finEncontrado ? ", END" : ", sin END")
+              << ")" << std::endl;
+    std::cout << "Parseo: " << estadisticas.bytes / segundosParseo / 1e9 << " GB/s, "
+              << "decodificacion: " << estadisticas.tramas / segundosDecodificacion / 1e6
+              << " M tramas/s" << std::endl;
+    std::cout << "MENSAJE OCULTO ENSAMBLADO:" << std::endl;
+    std::cout << mensaje << std::endl;
+    std::cout << "---" << std::endl;
+    
+    delete[] mensaje;
+    return 0;
 }
 
 /**
  * @brief Función principal del decodificador
+ * @param argc Número de argumentos
+ * @param argv Argumentos: [--hilos N] [--reproducir captura [--rango inicio fin]]
+ *             [--salida completa|incremental|resumen|silenciosa] [--resumen-cada N]
+ *             [--metricas texto|json] [--diario archivo] [--alfabeto nombre]
+ *             [--cascada configuracion] [--ventana N [--derrame archivo]]
+ *             [--tuberia bloquear|descartar] [--baudios N] [--baja-latencia]
+ *             [--carriles [--reorden N] [--hueco-ms N]] [puerto...]
  * @return Código de salida
+ * 
+ * Sin puertos se pregunta el puerto de forma interactiva. Con un puerto se
+ * usa directamente, y con dos o más se activa el modo multipuerto. Con
+ * --reproducir se decodifica un archivo de captura en lugar de un puerto;
+ * --rango limita la decodificación a las tramas [inicio, fin) de la captura.
+ * --salida elige cuánto se muestra por trama en el modo de un solo puerto.
+ * Con la instrumentación compilada, SIGUSR1 vuelca las métricas en stderr
+ * (en el formato de --metricas) y se vuelcan también al terminar.
+ * Con --diario (un solo puerto) cada trama se guarda en disco y, al
+ * reiniciar con el mismo archivo, la sesión anterior se recupera antes de
+ * seguir recibiendo. --alfabeto (un solo puerto) elige sobre qué caracteres
+ * rota el rotor: letras (A-Z, por defecto), digitos, alfanumerico o imprimible.
+ * --cascada (un solo puerto, A-Z) reemplaza el rotor por varios rotores en
+ * serie descritos en un archivo (ver CascadaRotores.h). --ventana (un
+ * solo puerto, A-Z) retiene solo las últimas N tramas y compacta las
+ * anteriores en su texto decodificado, que --derrame guarda en un archivo
+ * en lugar de en memoria, para sesiones de cualquier duración.
+ * --tuberia (un solo puerto) reparte lectura, parseo, decodificación y
+ * salida en hilos conectados por colas sin bloqueos, para que una consola
+ * lenta no frene la lectura del puerto; "descartar" deja de mostrar
+ * tramas cuando la salida se atrasa (el mensaje sigue completo) y
+ * "bloquear" espera. Las métricas de las colas se vuelcan en stderr.
+ * --baudios acepta cualquier velocidad que admita el driver (por defecto
+ * 9600; 1000000 o 2000000 en placas recientes) y se informa la que quedó
+ * configurada. --baja-latencia pide ASYNC_LOW_LATENCY al driver si lo
+ * admite.
+ * --carriles trata los puertos como carriles de un mismo emisor, que
+ * reparte un solo flujo entre varios enlaces para sumar su ancho de banda.
+ * Cada trama trae su secuencia (";s=N") y un buffer de reordenamiento de
+ * --reorden tramas (4096 por defecto) las devuelve al orden original; un
+ * hueco que bloquea más de --hueco-ms milisegundos (100 por defecto) se da
+ * por perdido. Las estadísticas del reordenamiento se vuelcan en stderr.
  */
-int main() {
-    std::cout << "Iniciando Decodificador PRT-7. Conectando a puerto..." << std::endl;
+int main(int argc, char* argv[]) {
+    // Separar opciones y puertos
+    int hilos = 1;
+    const char* captura = nullptr;
+    int rangoInicio = 0;
+    int rangoFin = -1;
+    ModoSalida modoSalida = SALIDA_COMPLETA;
+    long intervaloResumen = 1000;
+    FormatoVolcado formatoMetricas = VOLCADO_TEXTO;
+    const char* rutaDiario = nullptr;
+    TipoAlfabeto alfabeto = ALFABETO_LETRAS;
+    const char* rutaCascada = nullptr;
+    int ventana = 0;
+    const char* rutaDerrame = nullptr;
+    bool usarTuberia = false;
+    PoliticaPresion politica = PRESION_BLOQUEAR;
+    ConfiguracionSerial configuracion;
+    bool baudiosPedidos = false;
+    bool usarCarriles = false;
+    int capacidadReorden = CAPACIDAD_REORDENAMIENTO;
+    int msHueco = MS_HUECO_REORDENAMIENTO;
+    char** puertos = new char*[argc];
+    int numeroPuertos = 0;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--hilos") == 0 && i + 1 < argc) {
+            long hilosPedidos;
+            if (!leerEntero(argv[++i], 1, MAX_HILOS_PEDIDOS, hilosPedidos)) {
+                std::cerr << "ERROR: --hilos necesita un número de hilos entre 1 y " << MAX_HILOS_PEDIDOS << ": "
+                          << argv[i] << std::endl;
+                delete[] puertos;
+                return 1;
+            }
+            hilos = static_cast<int>(hilosPedidos);
+        } else if (std::strcmp(argv[i], "--reproducir") == 0 && i + 1 < argc) {
+            captura = argv[++i];
+        } else if (std::strcmp(argv[i], "--rango") == 0 && i + 2 < argc) {
+            long inicioPedido;
+            long finPedido;
+            if (!leerEntero(argv[i + 1], 0, INT_MAX, inicioPedido) ||
+                !leerEntero(argv[i + 2], 0, INT_MAX, finPedido)) {
+                std::cerr << "ERROR: --rango necesita dos índices de trama enteros no negativos: " << argv[i + 1]
+                          << " " << argv[i + 2] << std::endl;
+                delete[] puertos;
+                return 1;
+            }
+            rangoInicio = static_cast<int>(inicioPedido);
+            rangoFin = static_cast<int>(finPedido);
+            i += 2;
+        } else if (std::strcmp(argv[i], "--salida") == 0 && i + 1 < argc) {
+            if (!SalidaTramas::parsearModo(argv[++i], modoSalida)) {
+                std::cerr << "ERROR: Modo de salida desconocido: " << argv[i]
+                          << " (completa, incremental, resumen o silenciosa)" << std::endl;
+                delete[] puertos;
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--resumen-cada") == 0 && i + 1 < argc) {
+            if (!leerEntero(argv[++i], 1, LONG_MAX, intervaloResumen)) {
+                std::cerr << "ERROR: --resumen-cada necesita un número de tramas mayor que 0: " << argv[i] << std::endl;
+                delete[] puertos;
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--metricas") == 0 && i + 1 < argc) {
+            if (!parsearFormatoVolcado(argv[++i], formatoMetricas)) {
+                std::cerr << "ERROR: Formato de métricas desconocido: " << argv[i] << " (texto o json)" << std::endl;
+                delete[] puertos;
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--diario") == 0 && i + 1 < argc) {
+            rutaDiario = argv[++i];
+        } else if (std::strcmp(argv[i], "--alfabeto") == 0 && i + 1 < argc) {
+            if (!RotorConfigurable::parsearTipo(argv[++i], alfabeto)) {
+                std::cerr << "ERROR: Alfabeto desconocido: " << argv[i]
+                          << " (letras, digitos, alfanumerico o imprimible)" << std::endl;
+                delete[] puertos;
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--cascada") == 0 && i + 1 < argc) {
+            rutaCascada = argv[++i];
+        } else if (std::strcmp(argv[i], "--ventana") == 0 && i + 1 < argc) {
+            ventana = std::atoi(argv[++i]);
+            if (ventana <= 0) {
+                std::cerr << "ERROR: --ventana necesita un número de tramas mayor que 0" << std::endl;
+                delete[] puertos;
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--derrame") == 0 && i + 1 < argc) {
+            rutaDerrame = argv[++i];
+        } else if (std::strcmp(argv[i], "--tuberia") == 0 && i + 1 < argc) {
+            if (!TuberiaDecodificacion::parsearPolitica(argv[++i], politica)) {
+                std::cerr << "ERROR: Política de la tubería desconocida: " << argv[i]
+                          << " (bloquear o descartar)" << std::endl;
+                delete[] puertos;
+                return 1;
+            }
+            usarTuberia = true;
+        } else if (std::strcmp(argv[i], "--baudios") == 0 && i + 1 < argc) {
+            long baudios;
+            if (!leerEntero(argv[++i], 1, 100000000L, baudios)) {
+                std::cerr << "ERROR: --baudios necesita una velocidad entera mayor que 0: " << argv[i] << std::endl;
+                delete[] puertos;
+                return 1;
+            }
+            configuracion.baudios = static_cast<int>(baudios);
+            baudiosPedidos = true;
+        } else if (std::strcmp(argv[i], "--baja-latencia") == 0) {
+            configuracion.bajaLatencia = true;
+        } else if (std::strcmp(argv[i], "--carriles") == 0) {
+            usarCarriles = true;
+        } else if (std::strcmp(argv[i], "--reorden") == 0 && i + 1 < argc) {
+            capacidadReorden = std::atoi(argv[++i]);
+            if (capacidadReorden <= 0 || capacidadReorden > (1 << 20)) {
+                std::cerr << "ERROR: --reorden necesita una capacidad entre 1 y " << (1 << 20) << std::endl;
+                delete[] puertos;
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--hueco-ms") == 0 && i + 1 < argc) {
+            msHueco = std::atoi(argv[++i]);
+            if (msHueco < 0) {
+                std::cerr << "ERROR: --hueco-ms necesita un número de milisegundos no negativo" << std::endl;
+                delete[] puertos;
+                return 1;
+            }
+        } else {
+            puertos[numeroPuertos++] = argv[i];
+        }
+    }
+    
+    // Con --carriles varios puertos son un solo flujo, no el modo multipuerto
+    bool multipuerto = numeroPuertos > 1 && !usarCarriles;
+    if (usarCarriles && (captura != nullptr || usarTuberia)) {
+        std::cerr << "ERROR: --carriles no se admite con --reproducir ni con --tuberia" << std::endl;
+        delete[] puertos;
+        return 1;
+    }
+    if (usarCarriles && numeroPuertos > MAX_DESCRIPTORES_DATOS) {
+        std::cerr << "ERROR: --carriles admite hasta " << MAX_DESCRIPTORES_DATOS << " puertos" << std::endl;
+        delete[] puertos;
+        return 1;
+    }
+    
+    if (rutaDiario != nullptr && (captura != nullptr || multipuerto)) {
+        std::cerr << "ERROR: --diario solo se admite con un puerto" << std::endl;
+        delete[] puertos;
+        return 1;
+    }
+    
+    // La reproducción y el multipuerto decodifican en bloque con los kernels A-Z
+    if (alfabeto != ALFABETO_LETRAS && (captura != nullptr || multipuerto)) {
+        std::cerr << "ERROR: --alfabeto solo se admite con un puerto" << std::endl;
+        delete[] puertos;
+        return 1;
+    }
+    if (rutaCascada != nullptr && (captura != nullptr || multipuerto || alfabeto != ALFABETO_LETRAS)) {
+        std::cerr << "ERROR: --cascada solo se admite con un puerto y el alfabeto A-Z" << std::endl;
+        delete[] puertos;
+        return 1;
+    }
     
-    // Crear las estructuras de datos
+    // La compactación decodifica con las tablas A-Z del rotor simple
+    if (ventana > 0 && (captura != nullptr || multipuerto || alfabeto != ALFABETO_LETRAS ||
+                        rutaCascada != nullptr)) {
+        std::cerr << "ERROR: --ventana solo se admite con un puerto, el alfabeto A-Z y sin --cascada" << std::endl;
+        delete[] puertos;
+        return 1;
+    }
+    if (usarTuberia && (captura != nullptr || multipuerto)) {
+        std::cerr << "ERROR: --tuberia solo se admite con un puerto" << std::endl;
+        delete[] puertos;
+        return 1;
+    }
+    if (rutaDerrame != nullptr && ventana == 0) {
+        std::cerr << "ERROR: --derrame necesita --ventana" << std::endl;
+        delete[] puertos;
+        return 1;
+    }
+    
+    if (captura != nullptr) {
+        delete[] puertos;
+        return ejecutarReproduccion(captura, hilos, rangoInicio, rangoFin);
+    }
+    
+    if (multipuerto) {
+        int codigo = ejecutarMultipuerto(puertos, numeroPuertos, hilos, formatoMetricas, configuracion);
+        delete[] puertos;
+        return codigo;
+    }
+    
+    // La configuración de rotores se valida antes de tocar el puerto
+    CascadaRotores cascada;
+    if (rutaCascada != nullptr && !cascada.cargar(rutaCascada)) {
+        delete[] puertos;
+        return 1;
+    }
+    CascadaRotores* cascadaActiva = (rutaCascada != nullptr) ? &cascada : nullptr;
+    
+    // Crear las estructuras de datos (la ventana antes de recuperar el diario)
     ListaDeCarga miListaDeCarga;
+    if (ventana > 0 && !miListaDeCarga.setVentana(ventana, rutaDerrame)) {
+        delete[] puertos;
+        return 1;
+    }
+    
+    std::cout << "Iniciando Decodificador PRT-7. Conectando a puerto..." << std::endl;
+    
     RotorDeMapeo miRotorDeMapeo;
+    RotorConfigurable rotorActivo(alfabeto);
     
-    // Configurar puerto serial
-    SerialReader serial;
+    // Configurar puerto serial (con --carriles, el primer carril)
+    SerialReader carriles[MAX_DESCRIPTORES_DATOS];
+    SerialReader& serial = carriles[0];
+    int numeroCarriles = (numeroPuertos > 1) ? numeroPuertos : 1;
     char nombrePuerto[100];
     
-    std::cout << "Ingrese el nombre del puerto (ej: /dev/ttyUSB0): ";
-    std::cin.getline(nombrePuerto, 100);
+    if (numeroPuertos >= 1) {
+        std::strncpy(nombrePuerto, puertos[0], sizeof(nombrePuerto) - 1);
+        nombrePuerto[sizeof(nombrePuerto) - 1] = '\0';
+    } else {
+        std::cout << "Ingrese el nombre del puerto (ej: /dev/ttyUSB0): ";
+        std::cin.getline(nombrePuerto, 100);
+    }
     
-    if (!serial.conectar(nombrePuerto, 9600)) {
+    if (!serial.conectar(nombrePuerto, configuracion)) {
         std::cerr << "ERROR: No se pudo conectar al puerto serial" << std::endl;
+        delete[] puertos;
         return 1;
     }
+    for (int i = 1; i < numeroCarriles; i++) {
+        if (!carriles[i].conectar(puertos[i], configuracion) || !carriles[i].setNoBloqueante(true)) {
+            std::cerr << "ERROR: No se pudo conectar al carril " << puertos[i] << std::endl;
+            delete[] puertos;
+            return 1;
+        }
+    }
+    delete[] puertos;
+    if (baudiosPedidos || serial.getBaudios() != configuracion.baudios) {
+        std::cout << "Velocidad configurada: " << serial.getBaudios() << " baudios";
+        if (serial.getBaudios() != configuracion.baudios) {
+            std::cout << " (se pidieron " << configuracion.baudios << ")";
+        }
+        std::cout << std::endl;
+    }
     
-    std::cout << "Conexión establecida. Esperando tramas..." << std::endl;
+    // El bucle de eventos solo despierta cuando hay bytes, señales o inactividad
+    // (con --tuberia el lector espera con poll() en su propio hilo)
+    BucleEventos bucle;
+    if (!serial.setNoBloqueante(true) ||
+        (!usarTuberia && !bucle.iniciar(serial.getDescriptor(), MS_INACTIVIDAD))) {
+        std::cerr << "ERROR: No se pudo preparar el bucle de eventos" << std::endl;
+        return 1;
+    }
+    for (int i = 1; i < numeroCarriles; i++) {
+        if (!bucle.agregarDescriptor(carriles[i].getDescriptor())) {
+            std::cerr << "ERROR: No se pudo preparar el bucle de eventos" << std::endl;
+            return 1;
+        }
+    }
+    
+    if (usarCarriles) {
+        std::cout << "Conexión establecida en " << numeroCarriles << " carriles. Esperando tramas..." << std::endl;
+    } else {
+        std::cout << "Conexión establecida. Esperando tramas..." << std::endl;
+    }
     std::cout << std::endl;
     
-    // Buffer para leer líneas y construir mensaje
-    char buffer[256];
-    char mensajeParcial[1000];
-    int posMensaje = 0;
-    mensajeParcial[0] = '\0';
+    // Línea actual (vista dentro del buffer del SerialReader) y mensaje
+    const char* linea;
+    int longitud;
+    MensajeDecodificado mensajeParcial;
+    SalidaTramas salida(std::cout, modoSalida);
     
-    // Bucle principal de procesamiento
-    while (true) {
-        if (serial.leerLinea(buffer, sizeof(buffer))) {
-            
-            // Verificar si es la señal de finalización
-            if (buffer[0] == 'E' && buffer[1] == 'N' && buffer[2] == 'D') {
-                std::cout << std::endl;
-                std::cout << "---" << std::endl;
-                std::cout << "Flujo de datos terminado." << std::endl;
+    // Recuperar la sesión anterior del diario: lista, rotor y mensaje
+    DiarioTramas diario;
+    if (rutaDiario != nullptr) {
+        EstadisticasRecuperacion recuperacion;
+        if (!diario.abrir(rutaDiario, miListaDeCarga, miRotorDeMapeo, recuperacion)) {
+            std::cerr << "ERROR: No se pudo abrir el diario " << rutaDiario << std::endl;
+            return 1;
+        }
+        if (recuperacion.tramas > 0 && (alfabeto != ALFABETO_LETRAS || cascadaActiva != nullptr)) {
+            RecuperadorSesion recuperador = { rotorActivo, cascadaActiva, mensajeParcial };
+            miListaDeCarga.recorrer(recuperador);
+        } else if (recuperacion.tramas > 0) {
+            rotorActivo.rotar(miRotorDeMapeo.getDesplazamiento());
+            char* recuperado = new char[miListaDeCarga.getTamano() + 1];
+            RotorDeMapeo rotorTemporal;
+            int caracteres = miListaDeCarga.decodificarMensaje(&rotorTemporal, recuperado);
+            mensajeParcial.omitirAnteriores(miListaDeCarga.getCompactado().cargas);
+            mensajeParcial.agregar(recuperado, caracteres);
+            delete[] recuperado;
+        }
+        std::cout << "Diario " << rutaDiario << ": " << recuperacion.tramas << " tramas recuperadas";
+        if (recuperacion.bytesDescartados > 0) {
+            std::cout << " (" << recuperacion.bytesDescartados << " bytes incompletos descartados)";
+        }
+        std::cout << std::endl;
+        if (recuperacion.tramas > 0) {
+            std::cout << "Mensaje recuperado: " << (mensajeParcial.getDescartados() > 0 ? "..." : "")
+                      << mensajeParcial.getTexto() << std::endl;
+        }
+    }
+    DiarioTramas* diarioActivo = (rutaDiario != nullptr) ? &diario : nullptr;
+    salida.setIntervaloResumen(intervaloResumen);
+    
+    ProcesadorTiempoReal procesador = { rotorActivo, cascadaActiva, mensajeParcial, salida, nullptr, 0, 0, -1 };
+    
+    // Con --carriles las tramas pasan por el buffer de reordenamiento antes de la lista
+    BufferReordenamiento reorden(usarCarriles ? capacidadReorden : 1, msHueco);
+    ReceptorEnOrden receptor = { miListaDeCarga, procesador, diarioActivo };
+    bool activos[MAX_DESCRIPTORES_DATOS];
+    for (int i = 0; i < numeroCarriles; i++) activos[i] = true;
+    int carrilesActivos = numeroCarriles;
+    int carrilesPerdidos = 0;
+    bool plazoArmado = false;
+    
+    // Bucle principal de procesamiento (con --tuberia lo hacen los hilos de la tubería)
+    bool terminado = false;
+    bool inactivo = false;
+    if (usarTuberia) {
+        TuberiaDecodificacion tuberia(serial, miListaDeCarga, rotorActivo, cascadaActiva, mensajeParcial,
+                                      salida, diarioActivo);
+        ejecutarTuberia(tuberia, politica, formatoMetricas);
+        terminado = true;
+    }
+    while (!terminado) {
+        switch (bucle.esperar()) {
+            case EVENTO_DATOS:
+                inactivo = false;
+                procesador.marcaLectura = ahoraNs();
+                if (usarCarriles) {
+                    carrilesActivos = leerCarriles(carriles, activos, numeroCarriles, bucle, reorden, receptor,
+                                                   carrilesPerdidos);
+                    if (carrilesActivos == 0) {
+                        // Todos los carriles terminaron: entregar lo que quede retenido
+                        reorden.vaciar(receptor);
+                        salida.vaciar();
+                        if (carrilesPerdidos == 0) {
+                            std::cout << std::endl;
+                            std::cout << "---" << std::endl;
+                            std::cout << "Flujo de datos terminado." << std::endl;
+                        }
+                        terminado = true;
+                    }
+                } else if (serial.leerDisponible() < 0) {
+                    // read() falló o llegó al fin de archivo: el puerto colgó
+                    std::cerr << "ERROR: Se perdió la conexión con el puerto serial" << std::endl;
+                    terminado = true;
+                    break;
+                }
+                
+                // Procesar todas las líneas completas que trajo la lectura
+                while (!usarCarriles && !terminado && serial.extraerLinea(linea, longitud)) {
+                    if (!procesarLinea(linea, longitud, miListaDeCarga, procesador, diarioActivo)) {
+                        salida.vaciar();
+                        std::cout << std::endl;
+                        std::cout << "---" << std::endl;
+                        std::cout << "Flujo de datos terminado." << std::endl;
+                        terminado = true;
+                    }
+                }
+                
+                // Una sola escritura por lectura del puerto; el diario recibe el lote
+                salida.vaciar();
+                if (diarioActivo != nullptr) {
+                    diarioActivo->vaciar();
+                    if (diarioActivo->getFallido()) {
+                        std::cerr << "ERROR: El diario dejó de escribirse; la sesión sigue sin diario" << std::endl;
+                        diarioActivo = nullptr;
+                        receptor.diario = nullptr;
+                    }
+                }
+                
+                // Con ventana el mensaje completo está en la lista: aquí basta lo de la ventana
+                if (ventana > 0 && mensajeParcial.getLongitud() > 2L * ventana) {
+                    mensajeParcial.descartarInicio(miListaDeCarga.getCompactado().cargas -
+                                                   mensajeParcial.getDescartados());
+                }
                 break;
-            }
             
-            // Ignorar líneas que no sean tramas válidas
-            if (buffer[0] != 'L' && buffer[0] != 'l' && 
-                buffer[0] != 'M' && buffer[0] != 'm') {
-                continue;
-            }
-            
-            // Parsear y crear objeto trama
-            TramaBase* trama = parsearTrama(buffer);
+            case EVENTO_PLAZO:
+                // Venció la espera de un hueco sin que llegaran más tramas
+                reorden.vencer(receptor);
+                salida.vaciar();
+                if (diarioActivo != nullptr) diarioActivo->vaciar();
+                break;
             
-            if (trama != nullptr) {
-                // Almacenar en la lista doblemente enlazada
-                miListaDeCarga.insertarAlFinal(trama);
-                
-                // Mostrar trama recibida y procesarla en tiempo real
-                std::cout << "Trama recibida: [" << buffer << "] -> Procesando... -> ";
-                
-                // Verificar tipo de trama usando polimorfismo
-                TramaLoad* tramaLoad = dynamic_cast<TramaLoad*>(trama);
-                TramaMap* tramaMap = dynamic_cast<TramaMap*>(trama);
+            case EVENTO_INACTIVIDAD:
+                // Sin tramas, un hueco de los carriles ya no se va a llenar
+                if (usarCarriles && reorden.getPendientes() > 0) {
+                    reorden.vaciar(receptor);
+                    salida.vaciar();
+                }
                 
-                if (tramaLoad != nullptr) {
-                    // Procesar TRAMA LOAD
-                    char original = tramaLoad->getCaracter();
-                    char decodificado = miRotorDeMapeo.getMapeo(original);
-                    mensajeParcial[posMensaje++] = decodificado;
-                    mensajeParcial[posMensaje] = '\0';
-                    
-                    std::cout << "Fragmento '" << original 
-                              << "' decodificado como '" << decodificado << "'. ";
-                    std::cout << "Mensaje: [";
-                    
-                    // Imprimir mensaje con formato [X][X][X]
-                    for (int i = 0; i < posMensaje; i++) {
-                        std::cout << "[" << mensajeParcial[i] << "]";
-                    }
-                    std::cout << "]" << std::endl;
-                    
-                } else if (tramaMap != nullptr) {
-                    // Procesar TRAMA MAP
-                    int rotacion = tramaMap->getRotacion();
-                    miRotorDeMapeo.rotar(rotacion);
-                    
-                    std::cout << "ROTANDO ROTOR " 
-                              << (rotacion >= 0 ? "+" : "") << rotacion << ". ";
-                    
-                    // Calcular qué mapeo genera (A->?)
-                    char mapeado = miRotorDeMapeo.getMapeo('A');
-                    std::cout << "(Ahora 'A' se mapea a '" << mapeado << "')" << std::endl;
+                // Avisar una sola vez por periodo de inactividad
+                if (!inactivo) {
+                    std::cout << "(Sin tramas durante " << MS_INACTIVIDAD / 1000
+                              << " s, esperando...)" << std::endl;
+                    inactivo = true;
+                }
+                break;
+            
+            case EVENTO_SENAL:
+                if (bucle.getUltimaSenal() == SIGUSR1) {
+                    // Volcado bajo demanda: seguir recibiendo tramas
+                    salida.vaciar();
+                    volcarInstrumentacion(std::cerr, formatoMetricas);
+                    if (usarCarriles) reorden.volcar(std::cerr, formatoMetricas);
+                    break;
                 }
                 
                 std::cout << std::endl;
+                std::cout << "---" << std::endl;
+                std::cout << "Señal " << bucle.getUltimaSenal()
+                          << " recibida. Cerrando decodificador." << std::endl;
+                terminado = true;
+                break;
+            
+            case EVENTO_DESCONEXION:
+                if (usarCarriles) {
+                    // Solo se pierde ese carril; el resto del flujo sigue llegando
+                    for (int i = 0; i < numeroCarriles; i++) {
+                        if (activos[i] && carriles[i].getDescriptor() == bucle.getDescriptorListo()) {
+                            std::cerr << "ERROR: Se perdió la conexión con el carril " << i << std::endl;
+                            activos[i] = false;
+                            bucle.quitarDescriptor(carriles[i].getDescriptor());
+                            carrilesActivos--;
+                            carrilesPerdidos++;
+                        }
+                    }
+                    if (carrilesActivos > 0) break;
+                    terminado = true;
+                    break;
+                }
+                std::cerr << "ERROR: Se perdió la conexión con el puerto serial" << std::endl;
+                terminado = true;
+                break;
+            
+            case EVENTO_ERROR:
+                std::cerr << "ERROR: Se perdió la conexión con el puerto serial" << std::endl;
+                terminado = true;
+                break;
+        }
+        
+        // Con tramas retenidas tras un hueco, despertar cuando venza aunque no lleguen datos
+        if (usarCarriles && !terminado) {
+            int msPlazo = reorden.msHastaVencer();
+            if (msPlazo >= 0 || plazoArmado) {
+                bucle.programarPlazo(msPlazo);
+                plazoArmado = (msPlazo >= 0);
             }
         }
     }
     
+    // Lo retenido detrás de un hueco también forma parte del mensaje
+    if (usarCarriles) {
+        reorden.vaciar(receptor);
+        salida.vaciar();
+    }
+    
     // Imprimir mensaje final
     std::cout << "MENSAJE OCULTO ENSAMBLADO:" << std::endl;
-    std::cout << mensajeParcial << std::endl;
+    if (ventana > 0) {
+        miListaDeCarga.escribirMensaje(std::cout);
+        std::cout << std::endl;
+    } else {
+        std::cout << mensajeParcial.getTexto() << std::endl;
+    }
     std::cout << "---" << std::endl;
     std::cout << "Liberando memoria... Sistema apagado." << std::endl;
     
-    serial.cerrar();
+    if (instrumentacionActiva()) {
+        volcarInstrumentacion(std::cerr, formatoMetricas);
+    }
+    if (usarCarriles) {
+        reorden.volcar(std::cerr, formatoMetricas);
+    }
+    
+    // Dejar en disco lo que quede del diario antes de salir
+    diario.cerrar();
+    bucle.cerrar();
+    for (int i = 0; i < numeroCarriles; i++) carriles[i].cerrar();
     
     return 0;
-}
\ No newline at end of file
+}